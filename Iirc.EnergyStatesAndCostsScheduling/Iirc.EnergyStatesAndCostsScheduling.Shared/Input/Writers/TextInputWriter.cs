@@ -34,6 +34,7 @@ namespace Iirc.EnergyStatesAndCostsScheduling.Shared.Input.Writers
                 this.WriteOptimalSwitchingCosts(stream, instance, instance.OptimalSwitchingCosts);
                 this.WriteOptimalSwitchingCosts(stream, instance, instance.FullOptimalSwitchingCosts);
                 this.WriteCumulativeEnergyCost(stream, instance);
+                this.WriteStateDiagram(stream, instance);
             }
         }
 
@@ -133,5 +134,18 @@ namespace Iirc.EnergyStatesAndCostsScheduling.Shared.Input.Writers
                 stream.WriteLine();
             }
         }
+
+        private void WriteStateDiagram(StreamWriter stream, ExtendedInstance instance)
+        {
+            stream.WriteLine($"{instance.States.Length} {instance.OnStateIdx} {instance.IdleStateIdx}");
+            stream.WriteLine(string.Join(" ", instance.StatePowerConsumption));
+            foreach (var transitionValues in new[] { instance.StateDiagramTime, instance.StateDiagramPowerConsumption })
+            {
+                foreach (var row in transitionValues)
+                {
+                    stream.WriteLine(string.Join(" ", row.Select(value => value ?? NoValue)));
+                }
+            }
+        }
     }
 }
@@ -137,6 +137,8 @@ namespace Iirc.EnergyStatesAndCostsScheduling.Shared.Solvers
                 {
                     stream.WriteLine("0");
                 }
+
+                stream.WriteLine(this.SolverConfig.UseMongeTransitions ? "1" : "0");
             }
         }
 
@@ -200,6 +202,16 @@ namespace Iirc.EnergyStatesAndCostsScheduling.Shared.Solvers
             currLine++;
             additionalInfo["PrimalHeuristicBlockFindingTotalTime"] = TimeSpan.FromMilliseconds(long.Parse(lines[currLine]));
             currLine++;
+            additionalInfo["MongeTransitionKernelUsed"] = int.Parse(lines[currLine]);
+            currLine++;
+            additionalInfo["CostCacheHitsCount"] = long.Parse(lines[currLine]);
+            currLine++;
+            additionalInfo["CostCacheMissesCount"] = long.Parse(lines[currLine]);
+            currLine++;
+            additionalInfo["GlobalLowerBound"] = int.Parse(lines[currLine]);
+            currLine++;
+            additionalInfo["DominatedNodesCount"] = long.Parse(lines[currLine]);
+            currLine++;
 
             return new CppSolverResult
             {
@@ -57,6 +57,17 @@ namespace Iirc.EnergyStatesAndCostsScheduling.Shared.Solvers
                 {
                     stream.WriteLine("-1");
                 }
+                stream.WriteLine(this.specializedSolverConfig.SearchThreadsCount);
+                stream.WriteLine((int)this.specializedSolverConfig.NodeSelection);
+                if (this.specializedSolverConfig.OpenNodesMemoryLimitMb.HasValue)
+                {
+                    stream.WriteLine($"{this.specializedSolverConfig.OpenNodesMemoryLimitMb.Value}");
+                }
+                else
+                {
+                    stream.WriteLine("-1");
+                }
+                stream.WriteLine(this.specializedSolverConfig.DominanceMemoCapacity);
             }
         }
 
@@ -91,6 +102,30 @@ namespace Iirc.EnergyStatesAndCostsScheduling.Shared.Solvers
             
             [DefaultValue(null)]
             public long? FullHorizonBabNodesCountLimit { get; set; }
+            
+            /// <summary>
+            /// Threads searching the tree in parallel (stealing the open subtrees of each other), if less than 1 then
+            /// the number of workers.
+            /// </summary>
+            [DefaultValue(1)]
+            public int SearchThreadsCount { get; set; }
+            
+            [DefaultValue(BranchAndBoundJob.NodeSelection.DepthFirst)]
+            public NodeSelection NodeSelection { get; set; }
+            
+            /// <summary>
+            /// Memory of the open nodes of the best-first search, if reached then the children are searched depth-first
+            /// until the memory is freed. Null if unlimited.
+            /// </summary>
+            [DefaultValue(1024L)]
+            public long? OpenNodesMemoryLimitMb { get; set; }
+            
+            /// <summary>
+            /// Maximum number of the cost frontiers of the searched nodes kept to prune the nodes dominated by a searched
+            /// node with the same remaining jobs, 0 disables the pruning.
+            /// </summary>
+            [DefaultValue(20000)]
+            public int DominanceMemoCapacity { get; set; }
         }
 
         public enum JobsJoiningOnGcd
@@ -119,5 +154,12 @@ namespace Iirc.EnergyStatesAndCostsScheduling.Shared.Solvers
         {
             MinimizeLengthDifference = 0
         }
+
+        public enum NodeSelection
+        {
+            DepthFirst = 0,
+            BestFirst = 1,
+            BestFirstWithDives = 2
+        }
     }
 }
\ No newline at end of file
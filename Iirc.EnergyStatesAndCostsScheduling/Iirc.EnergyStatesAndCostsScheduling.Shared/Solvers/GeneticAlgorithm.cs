@@ -39,6 +39,15 @@ namespace Iirc.EnergyStatesAndCostsScheduling.Shared.Solvers
                 stream.WriteLine(this.specializedSolverConfig.MutationRate);
                 stream.WriteLine((int)this.specializedSolverConfig.BestStallMax);
                 stream.WriteLine((int)this.specializedSolverConfig.AverageStallMax);
+                stream.WriteLine(this.specializedSolverConfig.PopulationThreadsCount);
+                stream.WriteLine(this.specializedSolverConfig.LevelThreadsCount);
+                stream.WriteLine(this.specializedSolverConfig.CostCacheCapacity);
+                stream.WriteLine(this.specializedSolverConfig.IslandsCount);
+                stream.WriteLine(this.specializedSolverConfig.MigrationInterval);
+                stream.WriteLine(this.specializedSolverConfig.MigrantsCount);
+                stream.WriteLine(this.specializedSolverConfig.SteadyState ? 1 : 0);
+                stream.WriteLine(this.specializedSolverConfig.SeedsFraction);
+                stream.WriteLine(this.specializedSolverConfig.MutationCandidatesCount);
             }
         }
 
@@ -70,6 +79,65 @@ namespace Iirc.EnergyStatesAndCostsScheduling.Shared.Solvers
             
             [DefaultValue(10)]
             public int AverageStallMax { get; set; }
+            
+            /// <summary>
+            /// Threads evaluating the chromosomes concurrently, if less than 1 then the number of workers.
+            /// </summary>
+            [DefaultValue(0)]
+            public int PopulationThreadsCount { get; set; }
+            
+            /// <summary>
+            /// Threads computing one level of the cost computation, if less than 1 then the workers left per population
+            /// thread.
+            /// </summary>
+            [DefaultValue(0)]
+            public int LevelThreadsCount { get; set; }
+            
+            /// <summary>
+            /// Maximum number of the evaluated permutations whose costs are cached, 0 disables the cache.
+            /// </summary>
+            [DefaultValue(20000)]
+            public int CostCacheCapacity { get; set; }
+            
+            /// <summary>
+            /// Number of independent populations exchanging their best chromosomes over a ring, 1 is a single population.
+            /// </summary>
+            [DefaultValue(1)]
+            public int IslandsCount { get; set; }
+            
+            /// <summary>
+            /// Number of generations between the migrations of the islands, 0 disables the migration.
+            /// </summary>
+            [DefaultValue(10)]
+            public int MigrationInterval { get; set; }
+            
+            /// <summary>
+            /// Number of the best chromosomes of an island migrating to the next one.
+            /// </summary>
+            [DefaultValue(2)]
+            public int MigrantsCount { get; set; }
+            
+            /// <summary>
+            /// If true, each offspring replaces the worst chromosome as soon as it is evaluated (if better), without
+            /// waiting for the whole generation.
+            /// </summary>
+            [DefaultValue(false)]
+            public bool SteadyState { get; set; }
+
+            /// <summary>
+            /// Share of the initial population seeded by the constructive orderings of the processing times (SPT, LPT
+            /// and the alternating ones), at most one chromosome per ordering. The initial start times are always
+            /// seeded if given.
+            /// </summary>
+            [DefaultValue(0.2)]
+            public double SeedsFraction { get; set; }
+
+            /// <summary>
+            /// Number of the random candidate moves of a mutation step (e.g., the destinations of a swap) whose costs
+            /// are computed, the best one is applied. 1 is a single random move.
+            /// </summary>
+            [DefaultValue(1)]
+            public int MutationCandidatesCount { get; set; }
         }
         
         public enum MutationStrategy
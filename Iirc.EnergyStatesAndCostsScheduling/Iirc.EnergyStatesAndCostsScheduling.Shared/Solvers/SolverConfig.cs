@@ -22,6 +22,7 @@ namespace Iirc.EnergyStatesAndCostsScheduling.Shared.Solvers
             this.StopOnFeasibleSolution = false;
             this.Random = new Random();
             this.PresolveLevel = PresolveLevel.Auto;
+            this.UseMongeTransitions = true;
         }
         
         /// <summary>
@@ -61,6 +62,12 @@ namespace Iirc.EnergyStatesAndCostsScheduling.Shared.Solvers
         /// </summary>
         public PresolveLevel PresolveLevel { get; set; }
 
+        /// <summary>
+        /// Gets or sets a value indicating whether the Cpp solvers use the Monge transitions of the cost computation
+        /// when the switching costs are Monge. Default is true.
+        /// </summary>
+        public bool UseMongeTransitions { get; set; }
+
         public SolverConfig ShallowCopy()
         {
             return (SolverConfig)this.MemberwiseClone();
@@ -0,0 +1,99 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <algorithm>
+#include "ProcessingTimesOrdering.h"
+
+namespace escs {
+    vector<int> ProcessingTimesOrdering::create(
+            const Instance &instance,
+            OrderingStrategy strategy,
+            mt19937_64 &random) {
+        vector<int> processingTimes;
+        for (auto &pJob : instance.mJobs) {
+            processingTimes.push_back(pJob->mProcessingTime);
+        }
+
+        switch (strategy) {
+            case Random:
+                shuffle(processingTimes.begin(), processingTimes.end(), random);
+                break;
+
+            case LongestProcessingTimeFirst:
+                sort(processingTimes.begin(), processingTimes.end());
+                reverse(processingTimes.begin(), processingTimes.end());
+                break;
+
+            case ShortestProcessingTimeFirst:
+                sort(processingTimes.begin(), processingTimes.end());
+                break;
+
+            case AlternateShortestLongestProcessingTime:
+                {
+                    sort(processingTimes.begin(), processingTimes.end());
+                    vector<int> newProcessingTimes;
+                    int left = 0;
+                    int right = (int)processingTimes.size() - 1;
+                    while (left <= right) {
+                        newProcessingTimes.push_back(processingTimes[left]);
+                        if (left < right) {
+                            newProcessingTimes.push_back(processingTimes[right]);
+                        }
+
+                        left++;
+                        right--;
+                    }
+
+                    processingTimes = newProcessingTimes;
+                }
+                break;
+
+            case AlternateHalvesShortLongProcessingTime:
+                {
+                    sort(processingTimes.begin(), processingTimes.end());
+                    vector<int> newProcessingTimes;
+                    int half = processingTimes.size() / 2;
+                    int left = 0;
+                    int right = half;
+                    while (left < half || right < (int)processingTimes.size()) {
+                        if (left < half) {
+                            newProcessingTimes.push_back(processingTimes[left]);
+                        }
+
+                        if (right < (int)processingTimes.size()) {
+                            newProcessingTimes.push_back(processingTimes[right]);
+                        }
+
+                        left++;
+                        right++;
+                    }
+
+                    processingTimes = newProcessingTimes;
+                }
+                break;
+        }
+
+        return processingTimes;
+    }
+
+    vector<int> ProcessingTimesOrdering::fromStartTimes(const Instance &instance, const vector<int> &startTimes) {
+        vector<pair<int, int>> procTimeWithStart; // (procTime, startTime)
+        for (auto pJob : instance.mJobs) {
+            procTimeWithStart.push_back(make_pair(pJob->mProcessingTime, startTimes.at(pJob->mIndex)));
+        }
+
+        sort(
+                procTimeWithStart.begin(),
+                procTimeWithStart.end(),
+                [&](const pair<int, int> &lhs, const pair<int, int> &rhs) {
+                    return lhs.second < rhs.second;
+                });
+
+        vector<int> processingTimes;
+        for (auto &procTimeAndStart : procTimeWithStart) {
+            processingTimes.push_back(procTimeAndStart.first);
+        }
+
+        return processingTimes;
+    }
+}
@@ -0,0 +1,35 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#ifndef ENERGYSTATESANDCOSTSSCHEDULING_PROCESSINGTIMESORDERING_H
+#define ENERGYSTATESANDCOSTSSCHEDULING_PROCESSINGTIMESORDERING_H
+
+#include <random>
+#include <vector>
+
+#include "../input/Instance.h"
+
+using namespace std;
+
+namespace escs {
+    // The orderings of the proc times of the jobs used to construct the permutations (e.g., the insertion order of the
+    // constructive heuristic or the seeds of the genetic algorithm).
+    class ProcessingTimesOrdering {
+    public:
+        enum OrderingStrategy
+        {
+            Random = 0,
+            ShortestProcessingTimeFirst = 1,
+            LongestProcessingTimeFirst = 2,
+            AlternateShortestLongestProcessingTime = 3,
+            AlternateHalvesShortLongProcessingTime = 4
+        };
+
+        static vector<int> create(const Instance &instance, OrderingStrategy strategy, mt19937_64 &random);
+
+        // The proc times of the jobs ordered by their start times.
+        static vector<int> fromStartTimes(const Instance &instance, const vector<int> &startTimes);
+    };
+}
+
+#endif //ENERGYSTATESANDCOSTSSCHEDULING_PROCESSINGTIMESORDERING_H
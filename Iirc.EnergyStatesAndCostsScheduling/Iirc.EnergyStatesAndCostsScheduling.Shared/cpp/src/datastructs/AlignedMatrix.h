@@ -0,0 +1,113 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#ifndef ENERGYSTATESANDCOSTSSCHEDULING_ALIGNEDMATRIX_H
+#define ENERGYSTATESANDCOSTSSCHEDULING_ALIGNEDMATRIX_H
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+namespace escs {
+    // Matrix stored in a single allocation, row by row. Each row starts on a cache line boundary (the rows are padded
+    // to a multiple of the cache line size), so that the rows can be scanned by aligned vector loads and do not share
+    // cache lines.
+    template<typename T>
+    class AlignedMatrix {
+    public:
+        static constexpr size_t ALIGNMENT = 64;
+
+    private:
+        static_assert(is_trivially_copyable<T>::value, "AlignedMatrix supports only trivially copyable types.");
+        static_assert(ALIGNMENT % sizeof(T) == 0, "The size of the type must divide the alignment.");
+
+        struct Deleter {
+            void operator()(T *data) const {
+                ::operator delete(data, align_val_t(ALIGNMENT));
+            }
+        };
+
+        int mRowsCount;
+        int mColsCount;
+        size_t mRowStride;
+        unique_ptr<T[], Deleter> mData;
+
+    public:
+        AlignedMatrix(): mRowsCount(0), mColsCount(0), mRowStride(0), mData() {}
+
+        AlignedMatrix(int rowsCount, int colsCount, T value)
+                : mRowsCount(rowsCount),
+                  mColsCount(colsCount),
+                  mRowStride((colsCount * sizeof(T) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT / sizeof(T)),
+                  mData() {
+            size_t size = max<size_t>(1, mRowsCount * mRowStride);
+            mData.reset(static_cast<T*>(::operator new(size * sizeof(T), align_val_t(ALIGNMENT))));
+            std::fill(mData.get(), mData.get() + size, value);
+        }
+
+        T *operator[](int row) {
+            return mData.get() + row * mRowStride;
+        }
+
+        const T *operator[](int row) const {
+            return mData.get() + row * mRowStride;
+        }
+
+        int getRowsCount() const {
+            return mRowsCount;
+        }
+
+        int getColsCount() const {
+            return mColsCount;
+        }
+
+        void fillRow(int row, T value) {
+            std::fill((*this)[row], (*this)[row] + mColsCount, value);
+        }
+    };
+
+    // Rows of an AlignedMatrix allocated on demand in chunks of CHUNK_ROWS_COUNT rows. The chunks are never freed nor
+    // moved, so a row keeps its address when the pool grows and the rows are reused instead of reallocated.
+    template<typename T>
+    class AlignedRowPool {
+    public:
+        static constexpr int CHUNK_ROWS_COUNT = 16;
+
+    private:
+        int mColsCount;
+        T mValue;
+        vector<AlignedMatrix<T>> mChunks;
+
+    public:
+        AlignedRowPool(int colsCount, T value): mColsCount(colsCount), mValue(value), mChunks() {}
+
+        // Makes the rows [0, rowsCount) available.
+        void reserve(int rowsCount) {
+            while ((int)mChunks.size() * CHUNK_ROWS_COUNT < rowsCount) {
+                mChunks.emplace_back(CHUNK_ROWS_COUNT, mColsCount, mValue);
+            }
+        }
+
+        T *operator[](int row) {
+            return mChunks[row / CHUNK_ROWS_COUNT][row % CHUNK_ROWS_COUNT];
+        }
+
+        const T *operator[](int row) const {
+            return mChunks[row / CHUNK_ROWS_COUNT][row % CHUNK_ROWS_COUNT];
+        }
+
+        int getRowsCount() const {
+            return mChunks.size() * CHUNK_ROWS_COUNT;
+        }
+
+        void fillRow(int row, T value) {
+            mChunks[row / CHUNK_ROWS_COUNT].fillRow(row % CHUNK_ROWS_COUNT, value);
+        }
+    };
+}
+
+#endif //ENERGYSTATESANDCOSTSSCHEDULING_ALIGNEDMATRIX_H
@@ -0,0 +1,375 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include "BidirectionalPermCostComputation.h"
+
+namespace escs {
+    BidirectionalPermCostComputation::BidirectionalPermCostComputation(
+            int maxTotalProcTime,
+            int numIntervals,
+            int earliestOnIntervalIdx,
+            int latestOnIntervalIdx,
+            shared_ptr<const InstanceCostTables> costTables,
+            const vector<bool> &processableIntervals,
+            const SwitchingCostsGraph *switchingCostsGraph,
+            const MongeSwitchingCosts *mongeSwitchingCosts)
+                : mTransitions(
+                        maxTotalProcTime,
+                        numIntervals,
+                        earliestOnIntervalIdx,
+                        latestOnIntervalIdx,
+                        costTables,
+                        processableIntervals,
+                        switchingCostsGraph,
+                        mongeSwitchingCosts),
+                  mPermProcTimes(),
+                  mPermLevels(),
+                  mPermTotalProcTime(0),
+                  mPrefixCosts(numIntervals, Instance::NO_VALUE),
+                  mSuffixCosts(numIntervals, Instance::NO_VALUE),
+                  mSuffixNextStarts(numIntervals, -1),
+                  mPrefixValidCount(0),
+                  mSuffixValidCount(0),
+                  mReplacementCostsTmp(2, numIntervals, Instance::NO_VALUE),
+                  mIntervalsTmp(numIntervals, Instance::NO_VALUE),
+                  mIntervalsArgTmp(numIntervals, -1) {
+    }
+
+    void BidirectionalPermCostComputation::setPermutation(const vector<int> &procTimes) {
+        int totalProcTime = accumulate(procTimes.begin(), procTimes.end(), 0);
+        if (procTimes.empty() || totalProcTime > mTransitions.mTotalProcTime) {
+            throw invalid_argument("The permutation must be non-empty and fit the max total proc time.");
+        }
+
+        int commonPrefixCount = 0;
+        while (commonPrefixCount < (int)min(procTimes.size(), mPermProcTimes.size())
+               && procTimes[commonPrefixCount] == mPermProcTimes[commonPrefixCount]) {
+            commonPrefixCount++;
+        }
+
+        int commonSuffixCount = 0;
+        while (commonSuffixCount < (int)min(procTimes.size(), mPermProcTimes.size())
+               && procTimes.rbegin()[commonSuffixCount] == mPermProcTimes.rbegin()[commonSuffixCount]) {
+            commonSuffixCount++;
+        }
+
+        mPrefixValidCount = min(mPrefixValidCount, commonPrefixCount);
+        mSuffixValidCount = min(mSuffixValidCount, commonSuffixCount);
+
+        mPermProcTimes = procTimes;
+        mPermLevels.resize(procTimes.size());
+        int level = 0;
+        for (int position = 0; position < (int)procTimes.size(); position++) {
+            mPermLevels[position] = level;
+            level += procTimes[position];
+        }
+
+        mPermTotalProcTime = totalProcTime;
+    }
+
+    int BidirectionalPermCostComputation::getLevelMaxStart(int remainingProcTime) const {
+        return mTransitions.mLatestOnIntervalIdx - remainingProcTime + 1;
+    }
+
+    void BidirectionalPermCostComputation::computeLevelCosts(
+            const int *prevLevelCosts,
+            int prevLevelMinStart,
+            int prevProcTime,
+            int procTime,
+            int levelMinStart,
+            int levelMaxStart,
+            int *levelCosts) {
+        // The costs of the positions up to the level (with the energy cost of the level), prevLevelCosts is nullptr for
+        // the first position (from first off).
+        fill(levelCosts, levelCosts + mTransitions.mNumIntervals, Instance::NO_VALUE);
+        if (levelMinStart > levelMaxStart) {
+            return;
+        }
+
+        if (prevLevelCosts == nullptr) {
+            for (int levelStart = levelMinStart; levelStart <= levelMaxStart; levelStart++) {
+                levelCosts[levelStart] = mTransitions.mOptSwitchingCosts[1][levelStart];
+            }
+        }
+        else {
+            mTransitions.computeTransition(
+                    prevLevelCosts,
+                    prevLevelMinStart,
+                    prevProcTime,
+                    0,
+                    levelMinStart,
+                    levelMaxStart,
+                    levelCosts,
+                    mIntervalsArgTmp.data());
+        }
+
+        for (int levelStart = levelMinStart; levelStart <= levelMaxStart; levelStart++) {
+            if (levelCosts[levelStart] == Instance::NO_VALUE
+                || mTransitions.mMaxProcessableIntervals[levelStart] < procTime) {
+                levelCosts[levelStart] = Instance::NO_VALUE;
+            }
+            else {
+                levelCosts[levelStart] += mTransitions.mCumulOnEnergyCostPerProcTime[procTime][levelStart];
+            }
+        }
+    }
+
+    void BidirectionalPermCostComputation::computeSuffixLevelCosts(
+            const int *nextLevelCosts,
+            int nextLevelMaxStart,
+            int procTime,
+            int levelMinStart,
+            int levelMaxStart,
+            int *levelCosts,
+            int *levelNextStarts) {
+        // The costs of the positions from the level (with the energy cost of the level), nextLevelCosts is nullptr for
+        // the last position (to last off).
+        fill(levelCosts, levelCosts + mTransitions.mNumIntervals, Instance::NO_VALUE);
+        fill(levelNextStarts, levelNextStarts + mTransitions.mNumIntervals, -1);
+        if (levelMinStart > levelMaxStart) {
+            return;
+        }
+
+        if (nextLevelCosts == nullptr) {
+            for (int levelStart = levelMinStart; levelStart <= levelMaxStart; levelStart++) {
+                levelCosts[levelStart] =
+                        mTransitions.mOptSwitchingCostsTrans[mTransitions.mNumIntervals][levelStart + procTime];
+            }
+        }
+        else {
+            mTransitions.computeSuffixTransition(
+                    nextLevelCosts,
+                    nextLevelMaxStart,
+                    procTime,
+                    levelMinStart,
+                    levelMaxStart,
+                    levelCosts,
+                    levelNextStarts);
+        }
+
+        for (int levelStart = levelMinStart; levelStart <= levelMaxStart; levelStart++) {
+            if (levelCosts[levelStart] == Instance::NO_VALUE
+                || mTransitions.mMaxProcessableIntervals[levelStart] < procTime) {
+                levelCosts[levelStart] = Instance::NO_VALUE;
+            }
+            else {
+                levelCosts[levelStart] += mTransitions.mCumulOnEnergyCostPerProcTime[procTime][levelStart];
+            }
+        }
+    }
+
+    void BidirectionalPermCostComputation::computePrefixCosts(int toPosition) {
+        mPrefixCosts.reserve(toPosition + 1);
+        for (; mPrefixValidCount <= toPosition; mPrefixValidCount++) {
+            int position = mPrefixValidCount;
+            int procTime = mPermProcTimes[position];
+            int levelMinStart = mTransitions.mEarliestOnIntervalIdx + mPermLevels[position];
+            if (position == 0) {
+                this->computeLevelCosts(
+                        nullptr, 0, 0, procTime, levelMinStart, this->getLevelMaxStart(procTime), mPrefixCosts[position]);
+            }
+            else {
+                this->computeLevelCosts(
+                        mPrefixCosts[position - 1],
+                        mTransitions.mEarliestOnIntervalIdx + mPermLevels[position - 1],
+                        mPermProcTimes[position - 1],
+                        procTime,
+                        levelMinStart,
+                        this->getLevelMaxStart(procTime),
+                        mPrefixCosts[position]);
+            }
+        }
+    }
+
+    void BidirectionalPermCostComputation::computeSuffixCosts(int fromPosition) {
+        int lastPosition = mPermProcTimes.size() - 1;
+        mSuffixCosts.reserve(lastPosition - fromPosition + 1);
+        mSuffixNextStarts.reserve(lastPosition - fromPosition + 1);
+        for (; mSuffixValidCount <= lastPosition - fromPosition; mSuffixValidCount++) {
+            int row = mSuffixValidCount;
+            int position = lastPosition - row;
+            int remainingProcTime = mPermTotalProcTime - mPermLevels[position];
+            this->computeSuffixLevelCosts(
+                    row == 0 ? nullptr : mSuffixCosts[row - 1],
+                    this->getLevelMaxStart(remainingProcTime - mPermProcTimes[position]),
+                    mPermProcTimes[position],
+                    mTransitions.mEarliestOnIntervalIdx,
+                    this->getLevelMaxStart(remainingProcTime),
+                    mSuffixCosts[row],
+                    mSuffixNextStarts[row]);
+        }
+    }
+
+    int BidirectionalPermCostComputation::joinCosts(
+            const int *prevLevelCosts,
+            int prevLevelMinStart,
+            int prevLevelMaxStart,
+            int prevProcTime,
+            const int *nextLevelCosts,
+            int nextLevelMinStart,
+            int nextLevelMaxStart) {
+        // Min over the starts of the next level of the prefix costs joined with the suffix costs; without the prefix
+        // (suffix), from first off (to last off).
+        int minCost = Instance::NO_VALUE;
+        if (prevLevelCosts == nullptr) {
+            for (int nextLevelStart = nextLevelMinStart; nextLevelStart <= nextLevelMaxStart; nextLevelStart++) {
+                int switchingCost = mTransitions.mOptSwitchingCosts[1][nextLevelStart];
+                if (switchingCost != Instance::NO_VALUE && nextLevelCosts[nextLevelStart] != Instance::NO_VALUE) {
+                    minCost = min(minCost, switchingCost + nextLevelCosts[nextLevelStart]);
+                }
+            }
+        }
+        else if (nextLevelCosts == nullptr) {
+            for (int prevLevelStart = prevLevelMinStart; prevLevelStart <= prevLevelMaxStart; prevLevelStart++) {
+                int switchingCost =
+                        mTransitions.mOptSwitchingCostsTrans[mTransitions.mNumIntervals][prevLevelStart + prevProcTime];
+                if (switchingCost != Instance::NO_VALUE && prevLevelCosts[prevLevelStart] != Instance::NO_VALUE) {
+                    minCost = min(minCost, prevLevelCosts[prevLevelStart] + switchingCost);
+                }
+            }
+        }
+        else if (nextLevelMinStart <= nextLevelMaxStart) {
+            mTransitions.computeTransition(
+                    prevLevelCosts,
+                    prevLevelMinStart,
+                    prevProcTime,
+                    0,
+                    nextLevelMinStart,
+                    nextLevelMaxStart,
+                    mIntervalsTmp.data(),
+                    mIntervalsArgTmp.data());
+            for (int nextLevelStart = nextLevelMinStart; nextLevelStart <= nextLevelMaxStart; nextLevelStart++) {
+                if (mIntervalsTmp[nextLevelStart] != Instance::NO_VALUE
+                    && nextLevelCosts[nextLevelStart] != Instance::NO_VALUE) {
+                    minCost = min(minCost, mIntervalsTmp[nextLevelStart] + nextLevelCosts[nextLevelStart]);
+                }
+            }
+        }
+
+        return minCost;
+    }
+
+    int BidirectionalPermCostComputation::computeReplacementCost(
+            int fromPosition,
+            int toPosition,
+            const vector<int> &procTimes) {
+        int positionsCount = mPermProcTimes.size();
+        if (fromPosition < 0 || fromPosition > toPosition || toPosition > positionsCount) {
+            throw invalid_argument("Invalid range of the replaced positions.");
+        }
+
+        int fromLevel = fromPosition < positionsCount ? mPermLevels[fromPosition] : mPermTotalProcTime;
+        int toLevel = toPosition < positionsCount ? mPermLevels[toPosition] : mPermTotalProcTime;
+        int totalProcTime = mPermTotalProcTime - (toLevel - fromLevel)
+                + accumulate(procTimes.begin(), procTimes.end(), 0);
+        if (totalProcTime == 0 || totalProcTime > mTransitions.mTotalProcTime) {
+            throw invalid_argument("The permutation must be non-empty and fit the max total proc time.");
+        }
+
+        this->computePrefixCosts(fromPosition - 1);
+        this->computeSuffixCosts(toPosition);
+
+        const int *prevLevelCosts = nullptr;
+        int prevLevelMinStart = 0;
+        int prevLevelMaxStart = 0;
+        int prevProcTime = 0;
+        if (fromPosition > 0) {
+            prevLevelCosts = mPrefixCosts[fromPosition - 1];
+            prevProcTime = mPermProcTimes[fromPosition - 1];
+            prevLevelMinStart = mTransitions.mEarliestOnIntervalIdx + mPermLevels[fromPosition - 1];
+            prevLevelMaxStart = this->getLevelMaxStart(prevProcTime);
+        }
+
+        // The replaced range, level by level.
+        int level = fromLevel;
+        for (int i = 0; i < (int)procTimes.size(); i++) {
+            int levelMinStart = mTransitions.mEarliestOnIntervalIdx + level;
+            int levelMaxStart = this->getLevelMaxStart(totalProcTime - level);
+            int *levelCosts = mReplacementCostsTmp[i % 2];
+            this->computeLevelCosts(
+                    prevLevelCosts,
+                    prevLevelMinStart,
+                    prevProcTime,
+                    procTimes[i],
+                    levelMinStart,
+                    levelMaxStart,
+                    levelCosts);
+
+            prevLevelCosts = levelCosts;
+            prevLevelMinStart = levelMinStart;
+            prevLevelMaxStart = levelMaxStart;
+            prevProcTime = procTimes[i];
+            level += procTimes[i];
+        }
+
+        const int *nextLevelCosts = nullptr;
+        if (toPosition < positionsCount) {
+            nextLevelCosts = mSuffixCosts[positionsCount - 1 - toPosition];
+        }
+
+        return this->joinCosts(
+                prevLevelCosts,
+                prevLevelMinStart,
+                prevLevelMaxStart,
+                prevProcTime,
+                nextLevelCosts,
+                mTransitions.mEarliestOnIntervalIdx + level,
+                this->getLevelMaxStart(totalProcTime - level));
+    }
+
+    int BidirectionalPermCostComputation::computeInsertionCost(int position, int procTime) {
+        return this->computeReplacementCost(position, position, vector<int> {procTime});
+    }
+
+    int BidirectionalPermCostComputation::computeRemovalCost(int position) {
+        return this->computeReplacementCost(position, position + 1, vector<int>());
+    }
+
+    int BidirectionalPermCostComputation::computeSwapCost(int position1, int position2) {
+        int fromPosition = min(position1, position2);
+        int toPosition = max(position1, position2);
+        if (mPermProcTimes[fromPosition] == mPermProcTimes[toPosition]) {
+            return this->getCost();
+        }
+
+        vector<int> procTimes(mPermProcTimes.begin() + fromPosition, mPermProcTimes.begin() + toPosition + 1);
+        swap(procTimes.front(), procTimes.back());
+        return this->computeReplacementCost(fromPosition, toPosition + 1, procTimes);
+    }
+
+    int BidirectionalPermCostComputation::getCost() {
+        return this->computeReplacementCost(0, 0, vector<int>());
+    }
+
+    vector<int> BidirectionalPermCostComputation::reconstructStartTimes() {
+        if (this->getCost() == Instance::NO_VALUE) {
+            throw logic_error("Cannot reconstruct start times, does not have feasible schedule.");
+        }
+
+        // The first start is the leftmost argmin of the join from first off, the others follow the suffix next starts.
+        int positionsCount = mPermProcTimes.size();
+        const int *firstLevelCosts = mSuffixCosts[positionsCount - 1];
+        int minCost = Instance::NO_VALUE;
+        vector<int> permStartTimes(positionsCount, Instance::NO_VALUE);
+        for (int start = mTransitions.mEarliestOnIntervalIdx;
+             start <= this->getLevelMaxStart(mPermTotalProcTime);
+             start++) {
+            int switchingCost = mTransitions.mOptSwitchingCosts[1][start];
+            if (switchingCost != Instance::NO_VALUE
+                && firstLevelCosts[start] != Instance::NO_VALUE
+                && switchingCost + firstLevelCosts[start] < minCost) {
+                minCost = switchingCost + firstLevelCosts[start];
+                permStartTimes[0] = start;
+            }
+        }
+
+        for (int position = 1; position < positionsCount; position++) {
+            permStartTimes[position] = mSuffixNextStarts[positionsCount - position][permStartTimes[position - 1]];
+        }
+
+        return permStartTimes;
+    }
+}
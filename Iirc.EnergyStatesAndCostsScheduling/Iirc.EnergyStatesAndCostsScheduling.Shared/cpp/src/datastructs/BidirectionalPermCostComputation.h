@@ -0,0 +1,109 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#ifndef ENERGYSTATESANDCOSTSSCHEDULING_BIDIRECTIONALPERMCOSTCOMPUTATION_H
+#define ENERGYSTATESANDCOSTSSCHEDULING_BIDIRECTIONALPERMCOSTCOMPUTATION_H
+
+#include <vector>
+#include "../input/Instance.h"
+#include "FixedPermCostComputation.h"
+#include "AlignedMatrix.h"
+
+using namespace std;
+
+namespace escs {
+    // Cost computation of the permutations near a given one. Keeps the forward (prefix) and the backward (suffix) DP
+    // costs of the permutation, so that the cost of the permutation with a range of positions replaced (e.g., by an
+    // insertion, a removal or a swap) is computed by the transitions of the replaced range only, joining the prefix
+    // before the range with the suffix after it.
+    //
+    // The windows of the prefix costs do not depend on the positions after them and vice versa (the prefix costs of a
+    // position are computed for all the starts after its level, the suffix costs for all the starts before its
+    // remaining proc time), hence the costs stay exact when the total proc time changes by the replacement.
+    class BidirectionalPermCostComputation {
+    private:
+        // Provides the transitions and the cost tables of the instance. Its total proc time bounds the total proc time
+        // of the permutations.
+        FixedPermCostComputation mTransitions;
+
+        vector<int> mPermProcTimes;
+        vector<int> mPermLevels;
+        int mPermTotalProcTime;
+
+        // Prefix costs indexed by position: the optimal cost of the positions up to the position, given its start.
+        AlignedRowPool<int> mPrefixCosts;
+        // Suffix costs indexed by the count of the positions after the position (so that the rows of a common suffix
+        // are kept when the permutation changes): the optimal cost of the positions from the position, given its start.
+        AlignedRowPool<int> mSuffixCosts;
+        AlignedRowPool<int> mSuffixNextStarts;
+        int mPrefixValidCount;
+        int mSuffixValidCount;
+
+        AlignedMatrix<int> mReplacementCostsTmp;
+        vector<int> mIntervalsTmp;
+        vector<int> mIntervalsArgTmp;
+
+        int getLevelMaxStart(int remainingProcTime) const;
+        void computePrefixCosts(int toPosition);
+        void computeSuffixCosts(int fromPosition);
+        void computeLevelCosts(
+                const int *prevLevelCosts,
+                int prevLevelMinStart,
+                int prevProcTime,
+                int procTime,
+                int levelMinStart,
+                int levelMaxStart,
+                int *levelCosts);
+        void computeSuffixLevelCosts(
+                const int *nextLevelCosts,
+                int nextLevelMaxStart,
+                int procTime,
+                int levelMinStart,
+                int levelMaxStart,
+                int *levelCosts,
+                int *levelNextStarts);
+        int joinCosts(
+                const int *prevLevelCosts,
+                int prevLevelMinStart,
+                int prevLevelMaxStart,
+                int prevProcTime,
+                const int *nextLevelCosts,
+                int nextLevelMinStart,
+                int nextLevelMaxStart);
+
+    public:
+        BidirectionalPermCostComputation(
+                int maxTotalProcTime,
+                int numIntervals,
+                int earliestOnIntervalIdx,
+                int latestOnIntervalIdx,
+                shared_ptr<const InstanceCostTables> costTables,
+                const vector<bool> &processableIntervals,
+                const SwitchingCostsGraph *switchingCostsGraph,
+                const MongeSwitchingCosts *mongeSwitchingCosts);
+
+        // Only the costs of the positions that differ from the previous permutation are recomputed (lazily).
+        void setPermutation(const vector<int> &procTimes);
+
+        // Cost of the permutation with the positions [fromPosition, toPosition) replaced by the given proc times, or
+        // Instance::NO_VALUE if not feasible. The permutation itself is not changed.
+        int computeReplacementCost(int fromPosition, int toPosition, const vector<int> &procTimes);
+        int computeInsertionCost(int position, int procTime);
+        int computeRemovalCost(int position);
+        int computeSwapCost(int position1, int position2);
+
+        int getCost();
+        vector<int> reconstructStartTimes();
+
+        const vector<int> &getPermProcTimes() const {
+            return mPermProcTimes;
+        }
+
+        long long getMongeTransitionsCount() const {
+            return mTransitions.getMongeTransitionsCount();
+        }
+    };
+}
+
+
+#endif //ENERGYSTATESANDCOSTSSCHEDULING_BIDIRECTIONALPERMCOSTCOMPUTATION_H
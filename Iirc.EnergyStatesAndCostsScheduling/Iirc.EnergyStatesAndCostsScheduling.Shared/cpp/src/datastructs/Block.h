@@ -27,11 +27,31 @@ namespace escs {
             return Block::getProcBlocks(startTimes, permProcTimes, fromPosition);
         }
 
+        // As above, into the given vectors (reusing their memory).
+        static void getProcBlocks(
+                FixedPermCostComputation &fixedPermCostComputation,
+                int fromPosition,
+                vector<int> &startTimes,
+                vector<Block> &blocks) {
+            fixedPermCostComputation.reconstructStartTimes(startTimes);
+            Block::getProcBlocks(startTimes, fixedPermCostComputation.getPermProcTimes(), fromPosition, blocks);
+        }
+
         static vector<Block> getProcBlocks(
                 const vector<int> &startTimes,
                 const vector<int> &permProcTimes,
                 int fromPosition) {
             vector<Block> blocks;
+            Block::getProcBlocks(startTimes, permProcTimes, fromPosition, blocks);
+            return blocks;
+        }
+
+        static void getProcBlocks(
+                const vector<int> &startTimes,
+                const vector<int> &permProcTimes,
+                int fromPosition,
+                vector<Block> &blocks) {
+            blocks.clear();
             for (int position = fromPosition; position < (int)permProcTimes.size(); position++) {
                 int blockStart = startTimes[position];
                 int blockCompletion = blockStart + permProcTimes[position];
@@ -50,8 +70,6 @@ namespace escs {
                     }
                 }
             }
-
-            return blocks;
         }
     };
 }
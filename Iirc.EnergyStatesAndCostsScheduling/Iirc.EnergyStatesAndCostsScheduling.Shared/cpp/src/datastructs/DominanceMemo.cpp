@@ -0,0 +1,138 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <algorithm>
+#include "DominanceMemo.h"
+#include "../input/Instance.h"
+
+namespace escs {
+    DominanceMemo::DominanceMemo(int capacity, int shardsCount)
+            : mShardCapacity(max(1, capacity / max(1, shardsCount))),
+              mShards(),
+              mDominatedCount(0) {
+        for (int shardIdx = 0; shardIdx < max(1, shardsCount); shardIdx++) {
+            mShards.emplace_back(new Shard());
+            mShards.back()->mFrontiersCount = 0;
+            mShards.back()->mNextId = 0;
+        }
+    }
+
+    size_t DominanceMemo::computeHash(const vector<int> &key) {
+        // FNV-1a over the key.
+        size_t hash = 14695981039346656037ULL;
+        for (int value : key) {
+            hash ^= (size_t)value;
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+    DominanceMemo::Shard &DominanceMemo::getShard(size_t hash) {
+        return *mShards[(hash >> 32) % mShards.size()];
+    }
+
+    bool DominanceMemo::isDominatedBy(int minCompletion, const int *costs, int costsCount, const Frontier &frontier) {
+        for (int idx = 0; idx < costsCount; idx++) {
+            if (costs[idx] == Instance::NO_VALUE) {
+                continue;
+            }
+
+            int frontierIdx = minCompletion + idx - frontier.mMinCompletion;
+            if (frontierIdx < 0 || frontierIdx >= (int)frontier.mCosts.size()
+                || frontier.mCosts[frontierIdx] == Instance::NO_VALUE
+                || frontier.mCosts[frontierIdx] > costs[idx]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool DominanceMemo::checkAndInsert(const vector<int> &key, int minCompletion, const vector<int> &costs) {
+        int first = 0;
+        while (first < (int)costs.size() && costs[first] == Instance::NO_VALUE) {
+            first++;
+        }
+        int last = (int)costs.size() - 1;
+        while (last >= first && costs[last] == Instance::NO_VALUE) {
+            last--;
+        }
+
+        // No feasible completion at all.
+        if (first > last) {
+            mDominatedCount++;
+            return true;
+        }
+
+        minCompletion += first;
+        const int *trimmedCosts = costs.data() + first;
+        int trimmedCostsCount = last - first + 1;
+
+        size_t hash = computeHash(key);
+        auto &shard = getShard(hash);
+        lock_guard<mutex> lock(shard.mMutex);
+        auto &entry = shard.mEntries[hash];
+        if (entry.mKey != key) {
+            // New or a collision, the newer key replaces the older one.
+            shard.mFrontiersCount -= entry.mFrontiers.size();
+            entry.mKey = key;
+            entry.mFrontiers.clear();
+        }
+
+        for (auto &frontier : entry.mFrontiers) {
+            if (isDominatedBy(minCompletion, trimmedCosts, trimmedCostsCount, frontier)) {
+                mDominatedCount++;
+                return true;
+            }
+        }
+
+        Frontier newFrontier {
+            shard.mNextId++, minCompletion, vector<int>(trimmedCosts, trimmedCosts + trimmedCostsCount)};
+        int frontiersCount = entry.mFrontiers.size();
+        entry.mFrontiers.erase(
+                remove_if(
+                        entry.mFrontiers.begin(),
+                        entry.mFrontiers.end(),
+                        [&](const Frontier &frontier) {
+                            return isDominatedBy(
+                                    frontier.mMinCompletion,
+                                    frontier.mCosts.data(),
+                                    frontier.mCosts.size(),
+                                    newFrontier);
+                        }),
+                entry.mFrontiers.end());
+        shard.mFrontiersCount -= frontiersCount - (int)entry.mFrontiers.size();
+
+        shard.mInsertionOrder.emplace_back(hash, newFrontier.mId);
+        entry.mFrontiers.push_back(move(newFrontier));
+        shard.mFrontiersCount++;
+
+        // The records of the dropped frontiers are skipped (and bounded by evicting earlier).
+        while (shard.mFrontiersCount > mShardCapacity
+               || (int)shard.mInsertionOrder.size() > 2 * mShardCapacity) {
+            auto oldest = shard.mInsertionOrder.front();
+            shard.mInsertionOrder.pop_front();
+
+            auto it = shard.mEntries.find(oldest.first);
+            if (it == shard.mEntries.end()) {
+                continue;
+            }
+
+            auto &frontiers = it->second.mFrontiers;
+            auto frontierIt = find_if(
+                    frontiers.begin(),
+                    frontiers.end(),
+                    [&](const Frontier &frontier) { return frontier.mId == oldest.second; });
+            if (frontierIt != frontiers.end()) {
+                frontiers.erase(frontierIt);
+                shard.mFrontiersCount--;
+                if (frontiers.empty()) {
+                    shard.mEntries.erase(it);
+                }
+            }
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,68 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#ifndef ENERGYSTATESANDCOSTSSCHEDULING_DOMINANCEMEMO_H
+#define ENERGYSTATESANDCOSTSSCHEDULING_DOMINANCEMEMO_H
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace escs {
+    // Bounded store of the frontiers of the searched prefixes, safe for concurrent use. A frontier is the cost of a
+    // prefix by the completion of its last block (Instance::NO_VALUE if pruned or infeasible), and prefixes with the
+    // same key (e.g., the same remaining proc times) are interchangeable for the suffix. Hence, a prefix whose frontier
+    // is pointwise not less than a stored one cannot lead to a better solution. The frontiers are stored without their
+    // leading and trailing Instance::NO_VALUE, several per key (a new frontier drops the stored ones it dominates). As
+    // PermutationCostCache, the entries are split into shards each evicting its oldest frontiers when full.
+    class DominanceMemo {
+    private:
+        struct Frontier {
+            long long mId;
+            int mMinCompletion;
+            vector<int> mCosts; // Indexed by the completion minus mMinCompletion.
+        };
+
+        struct Entry {
+            vector<int> mKey;
+            vector<Frontier> mFrontiers;
+        };
+
+        struct Shard {
+            mutex mMutex;
+            unordered_map<size_t, Entry> mEntries;
+            deque<pair<size_t, long long>> mInsertionOrder; // (hash, frontier id), dropped frontiers included.
+            int mFrontiersCount;
+            long long mNextId;
+        };
+
+        const int mShardCapacity;
+        vector<unique_ptr<Shard>> mShards;
+        atomic<long long> mDominatedCount;
+
+        static size_t computeHash(const vector<int> &key);
+        Shard &getShard(size_t hash);
+
+        // Whether the costs (from minCompletion, trimmed) are pointwise not less than the frontier.
+        static bool isDominatedBy(int minCompletion, const int *costs, int costsCount, const Frontier &frontier);
+
+    public:
+        DominanceMemo(int capacity, int shardsCount);
+
+        // Returns true if the frontier (the costs indexed by the completion minus minCompletion) is dominated by a
+        // stored frontier with the same key, otherwise stores it.
+        bool checkAndInsert(const vector<int> &key, int minCompletion, const vector<int> &costs);
+
+        long long getDominatedCount() const {
+            return mDominatedCount;
+        }
+    };
+}
+
+
+#endif //ENERGYSTATESANDCOSTSSCHEDULING_DOMINANCEMEMO_H
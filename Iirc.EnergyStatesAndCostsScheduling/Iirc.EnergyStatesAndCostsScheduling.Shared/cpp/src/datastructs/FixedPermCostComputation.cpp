@@ -2,67 +2,128 @@
 // See file LICENSE.txt for more information.
 
 #include <algorithm>
+#include <cmath>
 #include <numeric>
 #include <stdexcept>
 #include <cassert>
 #include "FixedPermCostComputation.h"
 #include "../input/Instance.h"
+#include "../utils/MinPlusKernel.h"
 
 namespace escs {
+    namespace {
+        // Tiling of the generic transition, see computeTransition.
+        const int CURR_STARTS_BLOCK_SIZE = 32;
+        const int PREV_STARTS_TILE_SIZE = 2048;
+
+        // Computes the min and the leftmost argmin of each row in [fromRow, toRow] over the columns in
+        // [fromCol, toCol] intersected with the window of the row, assuming that the leftmost argmins are non-decreasing
+        // in the row (e.g., the matrix is Monge on its finite entries) and that both bounds of the windows are
+        // non-decreasing. The rows are solved by divide and conquer, each level of the recursion scans O(rows + cols)
+        // entries. Rows without a finite entry get Instance::NO_VALUE and -1.
+        template<typename Window, typename Cost>
+        void computeMonotoneRowsArgmin(
+                int fromRow,
+                int toRow,
+                int fromCol,
+                int toCol,
+                const Window &window,
+                const Cost &cost,
+                int *rowsMin,
+                int *rowsArgmin) {
+            if (fromRow > toRow) {
+                return;
+            }
+
+            int row = fromRow + (toRow - fromRow) / 2;
+            auto [windowFromCol, windowToCol] = window(row);
+            int minCost = Instance::NO_VALUE;
+            int argmin = -1;
+            for (int col = max(fromCol, windowFromCol); col <= min(toCol, windowToCol); col++) {
+                int colCost = cost(row, col);
+                if (colCost < minCost) {
+                    minCost = colCost;
+                    argmin = col;
+                }
+            }
+
+            rowsMin[row] = minCost;
+            rowsArgmin[row] = argmin;
+
+            // Without an argmin, the windows still bound the argmins of the other rows.
+            computeMonotoneRowsArgmin(
+                    fromRow, row - 1, fromCol, min(toCol, argmin >= 0 ? argmin : windowToCol),
+                    window, cost, rowsMin, rowsArgmin);
+            computeMonotoneRowsArgmin(
+                    row + 1, toRow, max(fromCol, argmin >= 0 ? argmin : windowFromCol), toCol,
+                    window, cost, rowsMin, rowsArgmin);
+        }
+    }
 
     FixedPermCostComputation::FixedPermCostComputation(
             int totalProcTime,
             int numIntervals,
             int earliestOnIntervalIdx,
             int latestOnIntervalIdx,
-            int onPowerConsumption,
-            const vector<vector<int>> &optSwitchingCosts,
-            const vector<vector<int>> &cumulEnergyCost,
-            const vector<bool> &processableIntervals)
+            shared_ptr<const InstanceCostTables> costTables,
+            const vector<bool> &processableIntervals,
+            const SwitchingCostsGraph *switchingCostsGraph,
+            const MongeSwitchingCosts *mongeSwitchingCosts)
                 : mTotalProcTime(totalProcTime),
                   mOptCost(Instance::NO_VALUE),
+                  mPrunedByBound(false),
                   mLastLevelOptStart(Instance::NO_VALUE),
-                  mOptPath(totalProcTime, vector<int>(numIntervals, Instance::NO_VALUE)),
-                  mCostsOnLevels(totalProcTime, vector<int>(numIntervals, Instance::NO_VALUE)),
+                  mOptPath(numIntervals, Instance::NO_VALUE),
+                  mCostsOnPositions(numIntervals, Instance::NO_VALUE),
                   mPermProcTimes(totalProcTime, 1),
                   mPermLevels(totalProcTime, -1),
                   mPermForcedSpaces(totalProcTime, 0),
+                  mCostOnly(false),
+                  mKeptCostsRows(),
+                  mKeptCostsRowsCount(0),
                   mCostsValidLevel(-1),
                   mCostsValidPosition(-1),
+                  mCostsFirstValidPosition(0),
+                  mCostsEmptyPosition(-1),
+                  mCostsBoundPrunedPosition(-1),
+                  mCostsUpperBounds(totalProcTime, Instance::NO_VALUE),
+                  mRelaxedSuffixPosition(-1),
+                  mRelaxedSuffixOptStart(Instance::NO_VALUE),
+                  mRelaxedSuffixes(),
+                  mRelaxedCompletionBounds(true),
                   mNumIntervals(numIntervals),
                   mEarliestOnIntervalIdx(earliestOnIntervalIdx),
                   mLatestOnIntervalIdx(latestOnIntervalIdx),
-                  mOnPowerConsumption(onPowerConsumption),
-                  mOptSwitchingCosts(optSwitchingCosts),
-                  mOptSwitchingCostsTrans(),
-                  mCumulEnergyCost(cumulEnergyCost),
-                  mCumulOnEnergyCostPerProcTime(totalProcTime + 1, vector<int>(numIntervals, Instance::NO_VALUE)),
+                  mCostTables(costTables),
+                  mOptSwitchingCosts(costTables->getOptSwitchingCosts()),
+                  mOptSwitchingCostsTrans(costTables->getOptSwitchingCostsTrans()),
+                  mSwitchingCostsGraph(switchingCostsGraph),
+                  mMongeSwitchingCosts(mongeSwitchingCosts),
+                  mCumulOnEnergyCostPerProcTime(costTables->getCumulOnEnergyCostPerProcTime()),
                   mProcessableIntervals(processableIntervals),
                   mIntervalsTmp(numIntervals, Instance::NO_VALUE),
-                  mStopwatch() {
-        // Transpose of the opt switching costs.
-        int optSwitchingCostsRowsCount = optSwitchingCosts.size();
-        int optSwitchingCostsColsCount = optSwitchingCosts[0].size();
-        mOptSwitchingCostsTrans = vector<vector<int>>(
-                optSwitchingCostsColsCount,
-                vector<int>(optSwitchingCostsRowsCount, Instance::NO_VALUE));
-        for (int row = 0; row < optSwitchingCostsRowsCount; row++) {
-            for (int col = 0; col < optSwitchingCostsColsCount; col++) {
-                mOptSwitchingCostsTrans[col][row] = mOptSwitchingCosts[row][col];
-            }
+                  mIntervalsArgTmp(numIntervals, -1),
+                  mPrevLevelCostsTmp(numIntervals, Instance::NO_VALUE),
+                  mStateCostsTmp(),
+                  mStateOriginsTmp(),
+                  mStopwatch(),
+                  mMongeTransitionsCount(0) {
+        if (totalProcTime > mCostTables->getMaxProcTime()) {
+            throw invalid_argument("The total proc time exceeds the max proc time of the cost tables.");
         }
 
-        for (int procTime = 0; procTime <= totalProcTime; procTime++) {
-            for (int startIntervalIdx = 0; startIntervalIdx < mNumIntervals; startIntervalIdx++) {
-               int endIntervalIdx = startIntervalIdx + procTime - 1;
-               if (endIntervalIdx >= mNumIntervals) {
-                   continue;
-               }
-               mCumulOnEnergyCostPerProcTime[procTime][startIntervalIdx] =
-                       mCumulEnergyCost[startIntervalIdx][endIntervalIdx] * mOnPowerConsumption;
+        // Splitting the positions into unit ones is a relaxation only if staying on between two adjacent units is free.
+        for (int interval = mEarliestOnIntervalIdx + 1; interval <= mLatestOnIntervalIdx; interval++) {
+            if (mOptSwitchingCosts[interval][interval] != 0) {
+                mRelaxedCompletionBounds = false;
             }
         }
 
+        if (mSwitchingCostsGraph != nullptr) {
+            mStateCostsTmp = vector<long long>(numIntervals * mSwitchingCostsGraph->getStatesCount());
+            mStateOriginsTmp = vector<int>(mStateCostsTmp.size());
+        }
+
         reset();
     }
 
@@ -174,42 +235,649 @@ namespace escs {
         this->invalidateCosts(fromPosition);
     }
 
+    void FixedPermCostComputation::setPermutation(const vector<int> &procTimes) {
+        if (procTimes.empty() || accumulate(procTimes.begin(), procTimes.end(), 0) != mTotalProcTime) {
+            throw invalid_argument("The proc times of the permutation must sum to the total proc time.");
+        }
+
+        int commonPrefixCount = 0;
+        while (commonPrefixCount < (int)min(procTimes.size(), mPermProcTimes.size())
+               && procTimes[commonPrefixCount] == mPermProcTimes[commonPrefixCount]) {
+            commonPrefixCount++;
+        }
+
+        if (commonPrefixCount == (int)procTimes.size() && procTimes.size() == mPermProcTimes.size()) {
+            return;
+        }
+
+        mPermProcTimes.assign(procTimes.begin(), procTimes.end());
+        mPermLevels.resize(procTimes.size());
+        int currLevel = commonPrefixCount == 0 ? 0 : mPermLevels[commonPrefixCount - 1] + procTimes[commonPrefixCount - 1];
+        for (int position = commonPrefixCount; position < (int)procTimes.size(); position++) {
+            mPermLevels[position] = currLevel;
+            currLevel += procTimes[position];
+        }
+
+        this->invalidateCosts(commonPrefixCount);
+    }
+
     void FixedPermCostComputation::invalidateCosts(int fromPosition) {
-        if (fromPosition == 0) {
+        if (fromPosition <= mCostsFirstValidPosition) {
             mCostsValidLevel = -1;
             mCostsValidPosition = -1;
+            mCostsFirstValidPosition = 0;
         }
         else {
             if (mPermLevels[fromPosition - 1] < mCostsValidLevel) {
-                mCostsValidLevel = mPermLevels[fromPosition - 1];
-                mCostsValidPosition = fromPosition - 1;
+                int validPosition = this->findKeptCostsPosition(fromPosition - 1);
+                mCostsValidLevel = mPermLevels[validPosition];
+                mCostsValidPosition = validPosition;
             }
         }
 
+        if (mCostsEmptyPosition > mCostsValidPosition) {
+            mCostsEmptyPosition = -1;
+        }
+        if (mCostsBoundPrunedPosition > mCostsValidPosition) {
+            mCostsBoundPrunedPosition = -1;
+        }
+
         mOptCost = Instance::NO_VALUE;
     }
 
-    int FixedPermCostComputation::recomputeCost() {
-        if (mOptCost != Instance::NO_VALUE) {
-            return mOptCost;
+    void FixedPermCostComputation::computeTransition(
+            const int *prevLevelCosts,
+            int prevLevelMinStart,
+            int prevProcTime,
+            int prevForcedSpace,
+            int currLevelMinStart,
+            int currLevelMaxStart,
+            int *transitionCosts,
+            int *transitionOptPath) {
+        // For each start on the curr level, computes the min of the prev level cost plus the switching cost over the
+        // prev level starts (without the energy cost of the curr level).
+        if (mSwitchingCostsGraph != nullptr
+            && this->computeTransitionByGraph(
+                    prevLevelCosts,
+                    prevLevelMinStart,
+                    prevProcTime,
+                    prevForcedSpace,
+                    currLevelMinStart,
+                    currLevelMaxStart,
+                    transitionCosts,
+                    transitionOptPath)) {
+            return;
         }
 
-        mStopwatch.start();
+        if (mMongeSwitchingCosts != nullptr) {
+            this->computeTransitionByMonge(
+                    prevLevelCosts,
+                    prevLevelMinStart,
+                    prevProcTime,
+                    prevForcedSpace,
+                    currLevelMinStart,
+                    currLevelMaxStart,
+                    transitionCosts,
+                    transitionOptPath);
+            mMongeTransitionsCount++;
+            return;
+        }
+
+        // The prev level starts that cannot be processed are masked out of the costs, so the inner loop is a plain
+        // min-plus product of the costs and a row of the transposed switching costs. The kernel adds the costs as
+        // unsigned: they must be non-negative, and the costs of the levels (sums of them) must fit an int as everywhere.
+        assert(mCostTables->hasNonNegativeCosts());
+        int prevLevelLastStart = currLevelMaxStart - prevProcTime - prevForcedSpace;
+        #pragma omp simd
+        for (int prevLevelStart = prevLevelMinStart; prevLevelStart <= prevLevelLastStart; prevLevelStart++) {
+            mPrevLevelCostsTmp[prevLevelStart] =
+                    mMaxProcessableIntervals[prevLevelStart] >= prevProcTime
+                    ? prevLevelCosts[prevLevelStart]
+                    : Instance::NO_VALUE;
+        }
+
+        // Tiled: each block of the curr level starts (one block per thread at a time) sweeps the tiles of the prev level
+        // starts, so a tile of the masked costs stays in the L1 cache while it is combined with the rows of the whole
+        // block. The tiles are swept in increasing order and merged by strict comparison, hence the argmins are still
+        // the leftmost ones.
+        int blocksCount = (currLevelMaxStart - currLevelMinStart + CURR_STARTS_BLOCK_SIZE) / CURR_STARTS_BLOCK_SIZE;
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int block = 0; block < blocksCount; block++) {
+            int blockMinStart = currLevelMinStart + block * CURR_STARTS_BLOCK_SIZE;
+            int blockMaxStart = min(currLevelMaxStart, blockMinStart + CURR_STARTS_BLOCK_SIZE - 1);
+            fill(transitionCosts + blockMinStart, transitionCosts + blockMaxStart + 1, Instance::NO_VALUE);
+            fill(transitionOptPath + blockMinStart, transitionOptPath + blockMaxStart + 1, -1);
+
+            int blockPrevLevelMaxStart = blockMaxStart - prevProcTime - prevForcedSpace;
+            for (int tileMinStart = prevLevelMinStart;
+                 tileMinStart <= blockPrevLevelMaxStart;
+                 tileMinStart += PREV_STARTS_TILE_SIZE) {
+                for (int currLevelStart = blockMinStart; currLevelStart <= blockMaxStart; currLevelStart++) {
+                    int prevLevelMaxStart = min(
+                            tileMinStart + PREV_STARTS_TILE_SIZE - 1,
+                            currLevelStart - prevProcTime - prevForcedSpace);
+                    if (prevLevelMaxStart < tileMinStart) {
+                        continue;
+                    }
+
+                    int tileArgmin;
+                    int tileCost = computeMinPlusArgmin(
+                            mPrevLevelCostsTmp.data() + tileMinStart,
+                            mOptSwitchingCostsTrans[currLevelStart] + tileMinStart + prevProcTime,
+                            prevLevelMaxStart - tileMinStart + 1,
+                            tileArgmin);
+                    if (tileCost < transitionCosts[currLevelStart]) {
+                        transitionCosts[currLevelStart] = tileCost;
+                        transitionOptPath[currLevelStart] = tileMinStart + tileArgmin;
+                    }
+                }
+            }
+        }
+    }
+
+    bool FixedPermCostComputation::computeTransitionByGraph(
+            const int *prevLevelCosts,
+            int prevLevelMinStart,
+            int prevProcTime,
+            int prevForcedSpace,
+            int currLevelMinStart,
+            int currLevelMaxStart,
+            int *transitionCosts,
+            int *transitionOptPath) {
+        // All the prev level completions are sources of one shortest paths pass over the (interval, state) nodes, the
+        // origin of each node is the prev level start of its shortest path. Valid only if all the completions have a
+        // switching cost to each curr level start, i.e., the windows of the completions do not cut the prev level.
+        auto &graph = *mSwitchingCostsGraph;
+        int firstIntervalIdx = prevLevelMinStart + prevProcTime;
+        if (prevForcedSpace > 1 || graph.getMinCompletion(currLevelMaxStart) > firstIntervalIdx) {
+            return false;
+        }
+
+        int statesCount = graph.getStatesCount();
+        int onStateIdx = graph.getOnStateIdx();
+        int rowsCount = max(0, currLevelMaxStart - firstIntervalIdx + 1);
+        fill(mStateCostsTmp.begin(), mStateCostsTmp.begin() + rowsCount * statesCount, SwitchingCostsGraph::NO_COST);
+        for (int currLevelStart = currLevelMinStart; currLevelStart < firstIntervalIdx; currLevelStart++) {
+            transitionCosts[currLevelStart] = Instance::NO_VALUE;
+            transitionOptPath[currLevelStart] = -1;
+        }
+
+        auto readTransition = [&](int currLevelStart, long long *stateCosts, int *stateOrigins) {
+            if (currLevelStart < currLevelMinStart) {
+                return;
+            }
+
+            bool hasCost = stateCosts[onStateIdx] != SwitchingCostsGraph::NO_COST;
+            transitionCosts[currLevelStart] = hasCost ? stateCosts[onStateIdx] : Instance::NO_VALUE;
+            transitionOptPath[currLevelStart] = hasCost ? stateOrigins[onStateIdx] : -1;
+        };
+
+        for (int intervalIdx = firstIntervalIdx; intervalIdx <= currLevelMaxStart; intervalIdx++) {
+            long long *stateCosts = mStateCostsTmp.data() + (intervalIdx - firstIntervalIdx) * statesCount;
+            int *stateOrigins = mStateOriginsTmp.data() + (intervalIdx - firstIntervalIdx) * statesCount;
+            graph.relaxZeroTimeEdges(stateCosts, stateOrigins);
+            if (prevForcedSpace == 1) {
+                readTransition(intervalIdx, stateCosts, stateOrigins);
+            }
+
+            int prevLevelStart = intervalIdx - prevProcTime;
+            if (prevLevelCosts[prevLevelStart] != Instance::NO_VALUE
+                && mMaxProcessableIntervals[prevLevelStart] >= prevProcTime
+                && prevLevelCosts[prevLevelStart] < stateCosts[onStateIdx]) {
+                stateCosts[onStateIdx] = prevLevelCosts[prevLevelStart];
+                stateOrigins[onStateIdx] = prevLevelStart;
+                graph.relaxZeroTimeEdges(stateCosts, stateOrigins);
+            }
+
+            if (prevForcedSpace == 0) {
+                readTransition(intervalIdx, stateCosts, stateOrigins);
+            }
+
+            for (auto &edge : graph.getEdges()) {
+                int toIntervalIdx = intervalIdx + edge.mTime;
+                if (toIntervalIdx > currLevelMaxStart || stateCosts[edge.mFromStateIdx] == SwitchingCostsGraph::NO_COST) {
+                    continue;
+                }
+
+                int toIdx = (toIntervalIdx - firstIntervalIdx) * statesCount + edge.mToStateIdx;
+                long long cost = stateCosts[edge.mFromStateIdx] + graph.getEdgeCost(edge, intervalIdx);
+                if (cost < mStateCostsTmp[toIdx]) {
+                    mStateCostsTmp[toIdx] = cost;
+                    mStateOriginsTmp[toIdx] = stateOrigins[edge.mFromStateIdx];
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void FixedPermCostComputation::computeTransitionByMonge(
+            const int *prevLevelCosts,
+            int prevLevelMinStart,
+            int prevProcTime,
+            int prevForcedSpace,
+            int currLevelMinStart,
+            int currLevelMaxStart,
+            int *transitionCosts,
+            int *transitionOptPath) {
+        // Rows: curr level starts, columns: prev level starts. The prev level costs and the processable intervals only
+        // add to (or forbid) whole columns, which keeps the matrix Monge.
+        auto &monge = *mMongeSwitchingCosts;
+        computeMonotoneRowsArgmin(
+                currLevelMinStart,
+                currLevelMaxStart,
+                prevLevelMinStart,
+                currLevelMaxStart - prevProcTime - prevForcedSpace,
+                [&](int currLevelStart) {
+                    return make_pair(
+                            monge.getMinCompletion(currLevelStart) - prevProcTime,
+                            min(monge.getMaxCompletion(currLevelStart), currLevelStart - prevForcedSpace) - prevProcTime);
+                },
+                [&](int currLevelStart, int prevLevelStart) {
+                    int switchingCost = mOptSwitchingCostsTrans[currLevelStart][prevLevelStart + prevProcTime];
+                    if (prevLevelCosts[prevLevelStart] == Instance::NO_VALUE
+                        || switchingCost == Instance::NO_VALUE
+                        || mMaxProcessableIntervals[prevLevelStart] < prevProcTime) {
+                        return Instance::NO_VALUE;
+                    }
+
+                    return prevLevelCosts[prevLevelStart] + switchingCost;
+                },
+                transitionCosts,
+                transitionOptPath);
+    }
+
+    void FixedPermCostComputation::computeSuffixTransition(
+            const int *nextLevelCosts,
+            int nextLevelMaxStart,
+            int procTime,
+            int levelMinStart,
+            int levelMaxStart,
+            int *transitionCosts,
+            int *transitionNextStarts) {
+        // For each start on the level, computes the min of the switching cost plus the next level cost over the next
+        // level starts (without the energy cost of the level).
+        if (mSwitchingCostsGraph != nullptr
+            && this->computeSuffixTransitionByGraph(
+                    nextLevelCosts,
+                    nextLevelMaxStart,
+                    procTime,
+                    levelMinStart,
+                    levelMaxStart,
+                    transitionCosts,
+                    transitionNextStarts)) {
+            return;
+        }
+
+        if (mMongeSwitchingCosts != nullptr) {
+            this->computeSuffixTransitionByMonge(
+                    nextLevelCosts,
+                    nextLevelMaxStart,
+                    procTime,
+                    levelMinStart,
+                    levelMaxStart,
+                    transitionCosts,
+                    transitionNextStarts);
+            mMongeTransitionsCount++;
+            return;
+        }
+
+        // The precondition of the kernel, see computeTransition.
+        assert(mCostTables->hasNonNegativeCosts());
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int levelStart = levelMinStart; levelStart <= levelMaxStart; levelStart++) {
+            if (mMaxProcessableIntervals[levelStart] < procTime) {
+                continue;
+            }
+
+            // The switching costs from the completion form a row of the (non-transposed) switching costs.
+            int levelCompletion = levelStart + procTime;
+            transitionCosts[levelStart] = computeMinPlusArgmin(
+                    nextLevelCosts + levelCompletion,
+                    mOptSwitchingCosts[levelCompletion].data() + levelCompletion,
+                    nextLevelMaxStart - levelCompletion + 1,
+                    transitionNextStarts[levelStart]);
+            if (transitionNextStarts[levelStart] >= 0) {
+                transitionNextStarts[levelStart] += levelCompletion;
+            }
+        }
+    }
+
+    bool FixedPermCostComputation::computeSuffixTransitionByGraph(
+            const int *nextLevelCosts,
+            int nextLevelMaxStart,
+            int procTime,
+            int levelMinStart,
+            int levelMaxStart,
+            int *transitionCosts,
+            int *transitionNextStarts) {
+        // Mirror of computeTransitionByGraph: all the next level starts are sinks of one backward shortest paths pass,
+        // the origin of each node is the next level start of its shortest path.
+        auto &graph = *mSwitchingCostsGraph;
+        int firstIntervalIdx = levelMinStart + procTime;
+        if (graph.getMaxStart(firstIntervalIdx) < nextLevelMaxStart) {
+            return false;
+        }
+
+        int statesCount = graph.getStatesCount();
+        int onStateIdx = graph.getOnStateIdx();
+        int rowsCount = max(0, nextLevelMaxStart - firstIntervalIdx + 1);
+        fill(mStateCostsTmp.begin(), mStateCostsTmp.begin() + rowsCount * statesCount, SwitchingCostsGraph::NO_COST);
+
+        for (int intervalIdx = nextLevelMaxStart; intervalIdx >= firstIntervalIdx; intervalIdx--) {
+            long long *stateCosts = mStateCostsTmp.data() + (intervalIdx - firstIntervalIdx) * statesCount;
+            int *stateOrigins = mStateOriginsTmp.data() + (intervalIdx - firstIntervalIdx) * statesCount;
+            for (auto &edge : graph.getEdges()) {
+                int toIntervalIdx = intervalIdx + edge.mTime;
+                if (toIntervalIdx > nextLevelMaxStart) {
+                    continue;
+                }
+
+                int toIdx = (toIntervalIdx - firstIntervalIdx) * statesCount + edge.mToStateIdx;
+                if (mStateCostsTmp[toIdx] == SwitchingCostsGraph::NO_COST) {
+                    continue;
+                }
+
+                long long cost = mStateCostsTmp[toIdx] + graph.getEdgeCost(edge, intervalIdx);
+                if (cost < stateCosts[edge.mFromStateIdx]) {
+                    stateCosts[edge.mFromStateIdx] = cost;
+                    stateOrigins[edge.mFromStateIdx] = mStateOriginsTmp[toIdx];
+                }
+            }
+
+            if (nextLevelCosts[intervalIdx] != Instance::NO_VALUE && nextLevelCosts[intervalIdx] < stateCosts[onStateIdx]) {
+                stateCosts[onStateIdx] = nextLevelCosts[intervalIdx];
+                stateOrigins[onStateIdx] = intervalIdx;
+            }
+
+            graph.relaxZeroTimeEdgesBackward(stateCosts, stateOrigins);
+
+            int levelStart = intervalIdx - procTime;
+            if (levelStart <= levelMaxStart
+                && mMaxProcessableIntervals[levelStart] >= procTime
+                && stateCosts[onStateIdx] != SwitchingCostsGraph::NO_COST) {
+                transitionCosts[levelStart] = stateCosts[onStateIdx];
+                transitionNextStarts[levelStart] = stateOrigins[onStateIdx];
+            }
+        }
+
+        return true;
+    }
+
+    void FixedPermCostComputation::computeSuffixTransitionByMonge(
+            const int *nextLevelCosts,
+            int nextLevelMaxStart,
+            int procTime,
+            int levelMinStart,
+            int levelMaxStart,
+            int *transitionCosts,
+            int *transitionNextStarts) {
+        // Rows: level starts, columns: next level starts.
+        auto &monge = *mMongeSwitchingCosts;
+        computeMonotoneRowsArgmin(
+                levelMinStart,
+                levelMaxStart,
+                levelMinStart + procTime,
+                nextLevelMaxStart,
+                [&](int levelStart) {
+                    int levelCompletion = levelStart + procTime;
+                    return make_pair(
+                            max(monge.getMinStart(levelCompletion), levelCompletion),
+                            monge.getMaxStart(levelCompletion));
+                },
+                [&](int levelStart, int nextLevelStart) {
+                    int switchingCost = mOptSwitchingCostsTrans[nextLevelStart][levelStart + procTime];
+                    if (nextLevelCosts[nextLevelStart] == Instance::NO_VALUE || switchingCost == Instance::NO_VALUE) {
+                        return Instance::NO_VALUE;
+                    }
+
+                    return nextLevelCosts[nextLevelStart] + switchingCost;
+                },
+                transitionCosts,
+                transitionNextStarts);
+
+        for (int levelStart = levelMinStart; levelStart <= levelMaxStart; levelStart++) {
+            if (mMaxProcessableIntervals[levelStart] < procTime) {
+                transitionCosts[levelStart] = Instance::NO_VALUE;
+                transitionNextStarts[levelStart] = -1;
+            }
+        }
+    }
+
+    int FixedPermCostComputation::findRelaxedSuffixPosition() const {
+        int lastPosition = mPermProcTimes.size() - 1;
+        int procTime = mPermProcTimes[lastPosition];
+        int position = lastPosition;
+        while (position > 0
+               && mPermProcTimes[position - 1] == procTime
+               && mPermForcedSpaces[position - 1] == 0) {
+            position--;
+        }
+
+        return position;
+    }
+
+    void FixedPermCostComputation::setCostOnly(bool costOnly, const vector<int> &checkpointPositions) {
+        mCostOnly = costOnly;
+
+        int keptPositionsInterval = max(1, (int)ceil(sqrt(mTotalProcTime)));
+        mKeptCostsRows.assign(mTotalProcTime, -1);
+        for (int position = 0; position < mTotalProcTime; position += keptPositionsInterval) {
+            mKeptCostsRows[position] = 0;
+        }
+        for (int position : checkpointPositions) {
+            if (position >= 0 && position < mTotalProcTime) {
+                mKeptCostsRows[position] = 0;
+            }
+        }
+
+        mKeptCostsRowsCount = 0;
+        for (auto &keptCostsRow : mKeptCostsRows) {
+            if (keptCostsRow >= 0) {
+                keptCostsRow = mKeptCostsRowsCount++;
+            }
+        }
+
+        // The pools only grow, the rows of the other mode are released.
+        mOptPath = AlignedRowPool<int>(mNumIntervals, Instance::NO_VALUE);
+        mCostsOnPositions = AlignedRowPool<int>(mNumIntervals, Instance::NO_VALUE);
+        this->invalidateCosts(0);
+    }
+
+    int FixedPermCostComputation::getCostsRow(int position) const {
+        // In the cost-only mode, the kept rows are followed by the row of the restored position and by two rows that
+        // the other positions alternate in (the costs of a position are computed from the ones of the previous one).
+        if (!mCostOnly) {
+            return position;
+        }
+        else if (mKeptCostsRows[position] >= 0) {
+            return mKeptCostsRows[position];
+        }
+        else if (position == mCostsFirstValidPosition) {
+            return mKeptCostsRowsCount;
+        }
+        else {
+            return mKeptCostsRowsCount + 1 + position % 2;
+        }
+    }
+
+    bool FixedPermCostComputation::isCostsRowKept(int position) const {
+        // Of the valid positions.
+        return !mCostOnly
+               || mKeptCostsRows[position] >= 0
+               || position == mCostsFirstValidPosition
+               || position == mCostsValidPosition;
+    }
+
+    int FixedPermCostComputation::findKeptCostsPosition(int position) const {
+        // The last valid position not after the given one whose costs are kept, assuming that the given one is valid
+        // and that it is not the last computed one.
+        if (mCostOnly) {
+            while (position > mCostsFirstValidPosition && mKeptCostsRows[position] < 0) {
+                position--;
+            }
+        }
+
+        return position;
+    }
+
+    void FixedPermCostComputation::reserveCostsRows(int toPosition) {
+        mCostsOnPositions.reserve(mCostOnly ? mKeptCostsRowsCount + 3 : toPosition + 1);
+    }
+
+    FixedPermCostComputation::RelaxedSuffix &FixedPermCostComputation::getRelaxedSuffix(
+            int procTime,
+            int positionsCount) {
+        auto &suffix = mRelaxedSuffixes[procTime];
+        if (suffix.mCosts.empty()) {
+            // Row 0 (empty suffix) is not used.
+            suffix.mCosts.emplace_back();
+            suffix.mNextStarts.emplace_back();
+        }
+
+        while ((int)suffix.mCosts.size() <= positionsCount) {
+            int suffixPositionsCount = suffix.mCosts.size();
+            int level = mTotalProcTime - suffixPositionsCount * procTime;
+            int levelMinStart = mEarliestOnIntervalIdx + level;
+            int levelMaxStart = mLatestOnIntervalIdx - (mTotalProcTime - level) + 1;
+
+            vector<int> costs(mNumIntervals, Instance::NO_VALUE);
+            vector<int> nextStarts(mNumIntervals, -1);
+
+            if (suffixPositionsCount == 1) {
+                // To last off.
+                for (int levelStart = levelMinStart; levelStart <= levelMaxStart; levelStart++) {
+                    int switchingCost = mOptSwitchingCostsTrans[mNumIntervals][levelStart + procTime];
+                    if (switchingCost != Instance::NO_VALUE && mMaxProcessableIntervals[levelStart] >= procTime) {
+                        costs[levelStart] = switchingCost + mCumulOnEnergyCostPerProcTime[procTime][levelStart];
+                    }
+                }
+            }
+            else {
+                auto &nextLevelCosts = suffix.mCosts[suffixPositionsCount - 1];
+                int nextLevel = level + procTime;
+                int nextLevelMaxStart = mLatestOnIntervalIdx - (mTotalProcTime - nextLevel) + 1;
+
+                this->computeSuffixTransition(
+                        nextLevelCosts.data(),
+                        nextLevelMaxStart,
+                        procTime,
+                        levelMinStart,
+                        levelMaxStart,
+                        costs.data(),
+                        nextStarts.data());
+                for (int levelStart = levelMinStart; levelStart <= levelMaxStart; levelStart++) {
+                    if (costs[levelStart] != Instance::NO_VALUE) {
+                        costs[levelStart] += mCumulOnEnergyCostPerProcTime[procTime][levelStart];
+                    }
+                }
+            }
+
+            suffix.mCosts.push_back(move(costs));
+            suffix.mNextStarts.push_back(move(nextStarts));
+        }
+
+        return suffix;
+    }
+
+    bool FixedPermCostComputation::pruneLevelCosts(
+            int position,
+            int levelMinStart,
+            int levelMaxStart,
+            int upperBound) {
+        bool boundPruned = false;
+        bool hasStates = this->pruneStates(
+                position,
+                mCostsOnPositions[this->getCostsRow(position)],
+                levelMinStart,
+                levelMaxStart,
+                upperBound,
+                boundPruned);
+
+        mCostsUpperBounds[position] = upperBound;
+        if (boundPruned && mCostsBoundPrunedPosition < 0) {
+            mCostsBoundPrunedPosition = position;
+        }
+        if (!hasStates) {
+            mCostsEmptyPosition = position;
+        }
+
+        return hasStates;
+    }
+
+    bool FixedPermCostComputation::pruneStates(
+            int position,
+            int *levelCosts,
+            int levelMinStart,
+            int levelMaxStart,
+            int upperBound,
+            bool &boundPruned) const {
+        // The completion bound of a state is the cost-to-go of the remaining proc time split into unit positions, read
+        // from the unit relaxed suffix: the row of (remaining + 1) units starting by the last interval of the state, less
+        // the energy of that interval. It does not depend on the permutation, hence the states pruned under a bound are
+        // also pruned under any lower bound. Without the relaxed completion bounds, zero is used.
+        int procTime = mPermProcTimes[position];
+        int remainingProcTime = mTotalProcTime - mPermLevels[position] - procTime;
+        const int *unitSuffixCosts = nullptr;
+        if (upperBound != Instance::NO_VALUE && mRelaxedCompletionBounds) {
+            unitSuffixCosts = mRelaxedSuffixes.at(1).mCosts[remainingProcTime + 1].data();
+        }
+        const int *unitOnEnergyCosts = mCumulOnEnergyCostPerProcTime[1];
+
+        bool hasStates = false;
+        for (int levelStart = levelMinStart; levelStart <= levelMaxStart; levelStart++) {
+            if (levelCosts[levelStart] == Instance::NO_VALUE) {
+                continue;
+            }
+
+            long long completionBound = 0;
+            if (unitSuffixCosts != nullptr) {
+                int lastInterval = levelStart + procTime - 1;
+                completionBound = unitSuffixCosts[lastInterval] == Instance::NO_VALUE
+                        ? Instance::NO_VALUE
+                        : unitSuffixCosts[lastInterval] - unitOnEnergyCosts[lastInterval];
+            }
+
+            if (levelCosts[levelStart] + completionBound >= upperBound) {
+                // Without any completion, the state is infeasible rather than pruned by the bound.
+                boundPruned |= completionBound != Instance::NO_VALUE;
+                levelCosts[levelStart] = Instance::NO_VALUE;
+            }
+            else {
+                hasStates = true;
+            }
+        }
+
+        return hasStates;
+    }
+
+    bool FixedPermCostComputation::computeLevelsCosts(int toPosition, int upperBound) {
+        if (toPosition < 0) {
+            return true;
+        }
+
+        if (mCostsEmptyPosition >= 0) {
+            // A valid position without any state, the next positions would not have any either.
+            return mCostsEmptyPosition > toPosition;
+        }
 
         // prevLevel: the last level having valid costs.
         // currLevel: for this level the costs are computed in the iteration.
         //
         // Recall that "currLevel = total proc time that must be scheduled before the curr level can start".
 
-        int prevLevel = mCostsValidLevel;
-        int currLevel = mCostsValidLevel < 0 ? 0 : prevLevel + mPermProcTimes[mCostsValidPosition];
+        this->reserveCostsRows(toPosition);
+        if (!mCostOnly) {
+            mOptPath.reserve(toPosition + 1);
+        }
 
         // From first off.
-        if (currLevel == 0) {
-            int currProcTime = mPermProcTimes[0];
+        if (mCostsValidPosition < 0) {
+            int currPosition = 0;
+            int currProcTime = mPermProcTimes[currPosition];
 
-            auto &currLevelCosts = mCostsOnLevels[currLevel];
-            fill(currLevelCosts.begin(), currLevelCosts.end(), Instance::NO_VALUE);
+            int *currLevelCosts = mCostsOnPositions[this->getCostsRow(currPosition)];
+            fill(currLevelCosts, currLevelCosts + mNumIntervals, Instance::NO_VALUE);
 
             int currLevelMinStart = mEarliestOnIntervalIdx;
             int currLevelMaxStart = mLatestOnIntervalIdx - mTotalProcTime + 1;
@@ -228,108 +896,343 @@ namespace escs {
 
             mCostsValidLevel = 0;
             mCostsValidPosition = 0;
-            currLevel = currLevel + currProcTime;
+            if (!this->pruneLevelCosts(currPosition, currLevelMinStart, currLevelMaxStart, upperBound)) {
+                return false;
+            }
         }
 
-        while (currLevel < mTotalProcTime) {
-            int prevProcTime = mPermProcTimes[mCostsValidPosition];
-            int currProcTime = mPermProcTimes[mCostsValidPosition + 1];
+        while (mCostsValidPosition < toPosition) {
+            int currPosition = mCostsValidPosition + 1;
+            int currLevel = mPermLevels[currPosition];
+            int currLevelMinStart = mEarliestOnIntervalIdx + currLevel;
+            int currLevelMaxStart = mLatestOnIntervalIdx - (mTotalProcTime - currLevel) + 1;
+
+            this->computeLevelCosts(
+                    currPosition,
+                    mCostsOnPositions[this->getCostsRow(mCostsValidPosition)],
+                    mCostsOnPositions[this->getCostsRow(currPosition)],
+                    mCostOnly ? mIntervalsArgTmp.data() : mOptPath[currPosition]);
+
+            mCostsValidLevel = currLevel;
+            mCostsValidPosition++;
+            if (!this->pruneLevelCosts(currPosition, currLevelMinStart, currLevelMaxStart, upperBound)) {
+                return false;
+            }
+        }
 
-            prevLevel = currLevel - prevProcTime;
+        return true;
+    }
 
-            auto &prevLevelCosts = mCostsOnLevels[prevLevel];
-            auto &currLevelCosts = mCostsOnLevels[currLevel];
-            fill(currLevelCosts.begin(), currLevelCosts.end(), Instance::NO_VALUE);
+    void FixedPermCostComputation::computeLevelCosts(
+            int position,
+            const int *prevLevelCosts,
+            int *levelCosts,
+            int *levelOptPath) {
+        // From the costs of the previous position, without pruning.
+        int prevPosition = position - 1;
+        int prevLevel = mPermLevels[prevPosition];
+        int level = mPermLevels[position];
+        int procTime = mPermProcTimes[position];
+        int levelMinStart = mEarliestOnIntervalIdx + level;
+        int levelMaxStart = mLatestOnIntervalIdx - (mTotalProcTime - level) + 1;
+        fill(levelCosts, levelCosts + mNumIntervals, Instance::NO_VALUE);
 
-            int currLevelMinStart = mEarliestOnIntervalIdx + currLevel;
-            int currLevelMaxStart = mLatestOnIntervalIdx - (mTotalProcTime - currLevel) + 1;
+        this->computeTransition(
+                prevLevelCosts,
+                mEarliestOnIntervalIdx + prevLevel,
+                mPermProcTimes[prevPosition],
+                mPermForcedSpaces[prevPosition],
+                levelMinStart,
+                levelMaxStart,
+                levelCosts,
+                levelOptPath);
 
-            #pragma omp parallel for schedule(dynamic, 1)
-            for (int currLevelStart = currLevelMinStart; currLevelStart <= currLevelMaxStart; currLevelStart++) {
-                int prevLevelMinStart = mEarliestOnIntervalIdx + prevLevel;
-                int prevLevelMaxStart = currLevelStart - prevProcTime - mPermForcedSpaces[mCostsValidPosition];
+        #pragma omp simd
+        for (int levelStart = levelMinStart; levelStart <= levelMaxStart; levelStart++) {
+            if (levelCosts[levelStart] != Instance::NO_VALUE) {
+                levelCosts[levelStart] += mCumulOnEnergyCostPerProcTime[procTime][levelStart];
+            }
+        }
+    }
 
-                int currLevelStartCumulCost = mCumulOnEnergyCostPerProcTime[currProcTime][currLevelStart];
+    void FixedPermCostComputation::computeSegmentOptPath(int fromPosition, int toPosition) {
+        // Cost-only mode: the opt path of the positions in (fromPosition, toPosition] into the rows of mOptPath from 0,
+        // recomputed from the kept costs of fromPosition (the costs of the segment alternate in the two rows after it).
+        // The states are pruned as when they were computed, hence the argmins are the same.
+        int optPathRowsCount = toPosition - fromPosition;
+        mOptPath.reserve(optPathRowsCount + 2);
+        bool boundPruned = false;
 
-                int minCost = Instance::NO_VALUE;
-                int minOptPath = -1;
+        const int *prevLevelCosts = mCostsOnPositions[this->getCostsRow(fromPosition)];
+        for (int position = fromPosition + 1; position <= toPosition; position++) {
+            int level = mPermLevels[position];
+            int *levelCosts = mOptPath[optPathRowsCount + position % 2];
+            this->computeLevelCosts(position, prevLevelCosts, levelCosts, mOptPath[position - fromPosition - 1]);
+            this->pruneStates(
+                    position,
+                    levelCosts,
+                    mEarliestOnIntervalIdx + level,
+                    mLatestOnIntervalIdx - (mTotalProcTime - level) + 1,
+                    mCostsUpperBounds[position],
+                    boundPruned);
+            prevLevelCosts = levelCosts;
+        }
+    }
 
-                for (int prevLevelStart = prevLevelMinStart; prevLevelStart <= prevLevelMaxStart; prevLevelStart++) {
-                    int switchingCost = mOptSwitchingCostsTrans[currLevelStart][prevLevelStart + prevProcTime];
-                    if (prevLevelCosts[prevLevelStart] != Instance::NO_VALUE
-                        && switchingCost != Instance::NO_VALUE
-                        && mMaxProcessableIntervals[prevLevelStart] >= prevProcTime) {
-                        int cost = prevLevelCosts[prevLevelStart]
-                                   + switchingCost
-                                   + currLevelStartCumulCost;
-                        if (cost < minCost) {
-                            minCost = cost;
-                            minOptPath = prevLevelStart;
-                        }
-                    }
-                }
+    int FixedPermCostComputation::recomputeCost() {
+        return this->recomputeCost(Instance::NO_VALUE);
+    }
 
-                currLevelCosts[currLevelStart] = minCost;
-                mOptPath[currLevel][currLevelStart] = minOptPath;
+    int FixedPermCostComputation::recomputeCost(int upperBound) {
+        if (mOptCost != Instance::NO_VALUE) {
+            mPrunedByBound = mOptCost >= upperBound;
+            return mPrunedByBound ? Instance::NO_VALUE : mOptCost;
+        }
+
+        mStopwatch.start();
+
+        // The costs pruned under a lower bound than the requested one may miss the states that are needed now.
+        for (int position = mCostsFirstValidPosition; position <= mCostsValidPosition; position++) {
+            if (mCostsUpperBounds[position] < upperBound) {
+                this->invalidateCosts(position);
+                break;
             }
+        }
 
-            mCostsValidLevel = currLevel;
-            mCostsValidPosition++;
-            currLevel = currLevel + currProcTime;
+        // The trailing positions of the same proc time without forced spaces (in branch-and-bound, these are the
+        // relaxed positions) are not computed level by level; their cost-to-go is read from the relaxed suffix table,
+        // which is shared by all the permutations having the same suffix. Hence, only the levels of the positions
+        // before the suffix are computed (or reused if still valid).
+        int lastPosition = mPermProcTimes.size() - 1;
+        int suffixPosition = this->findRelaxedSuffixPosition();
+        int suffixPositionsCount = lastPosition - suffixPosition + 1;
+        int suffixProcTime = mPermProcTimes[suffixPosition];
+        if (upperBound != Instance::NO_VALUE && mRelaxedCompletionBounds && suffixPosition > 0) {
+            // Completion bounds of the positions before the suffix (must precede taking the suffix costs, the unit
+            // relaxed suffix may be the same table).
+            this->getRelaxedSuffix(1, mTotalProcTime - mPermProcTimes[0] + 1);
+        }
+        auto &suffixCosts = this->getRelaxedSuffix(suffixProcTime, suffixPositionsCount).mCosts[suffixPositionsCount];
+
+        if (suffixPosition > 0 && suffixPosition - 1 < mCostsValidPosition && !this->isCostsRowKept(suffixPosition - 1)) {
+            // Cost-only mode: the costs before the suffix (now shorter) are not kept.
+            this->invalidateCosts(suffixPosition);
+        }
+
+        if (!this->computeLevelsCosts(suffixPosition - 1, upperBound)) {
+            mPrunedByBound = mCostsBoundPrunedPosition >= 0;
+            mStopwatch.stop();
+            return Instance::NO_VALUE;
         }
 
-        // To last off.
         mOptCost = Instance::NO_VALUE;
         mLastLevelOptStart = Instance::NO_VALUE;
-        {
-            prevLevel = mCostsValidLevel;
-            int prevProcTime = mPermProcTimes[mCostsValidPosition];
-            auto &prevLevelCosts = mCostsOnLevels[prevLevel];
+        mRelaxedSuffixPosition = suffixPosition;
+        mRelaxedSuffixOptStart = Instance::NO_VALUE;
 
-            int prevLevelMinStart = mEarliestOnIntervalIdx + prevLevel;
-            int prevLevelMaxStart = mLatestOnIntervalIdx - prevProcTime + 1;
+        int suffixLevel = mPermLevels[suffixPosition];
+        int suffixLevelMinStart = mEarliestOnIntervalIdx + suffixLevel;
+        int suffixLevelMaxStart = mLatestOnIntervalIdx - (mTotalProcTime - suffixLevel) + 1;
 
-            #pragma omp simd
-            for (int prevLevelStart = prevLevelMinStart; prevLevelStart <= prevLevelMaxStart; prevLevelStart++) {
-                int switchingCost = mOptSwitchingCostsTrans[mNumIntervals][prevLevelStart + prevProcTime];
-                if (prevLevelCosts[prevLevelStart] >= Instance::NO_VALUE
-                    || switchingCost >= Instance::NO_VALUE
-                    || mMaxProcessableIntervals[prevLevelStart] < prevProcTime) {
-                    mIntervalsTmp[prevLevelStart] = Instance::NO_VALUE;
-                }
-                else {
-                    mIntervalsTmp[prevLevelStart] =
-                            prevLevelCosts[prevLevelStart]
-                            + switchingCost;
+        if (suffixPosition == 0) {
+            // From first off directly to the suffix.
+            for (int suffixLevelStart = suffixLevelMinStart; suffixLevelStart <= suffixLevelMaxStart; suffixLevelStart++) {
+                int switchingCost = mOptSwitchingCosts[1][suffixLevelStart];
+                if (switchingCost != Instance::NO_VALUE && suffixCosts[suffixLevelStart] != Instance::NO_VALUE) {
+                    int cost = switchingCost + suffixCosts[suffixLevelStart];
+                    if (cost < mOptCost) {
+                        mOptCost = cost;
+                        mRelaxedSuffixOptStart = suffixLevelStart;
+                    }
                 }
             }
+        }
+        else {
+            // Join the last computed level with the suffix.
+            int prevPosition = suffixPosition - 1;
+            int prevLevel = mPermLevels[prevPosition];
+
+            this->computeTransition(
+                    mCostsOnPositions[this->getCostsRow(prevPosition)],
+                    mEarliestOnIntervalIdx + prevLevel,
+                    mPermProcTimes[prevPosition],
+                    mPermForcedSpaces[prevPosition],
+                    suffixLevelMinStart,
+                    suffixLevelMaxStart,
+                    mIntervalsTmp.data(),
+                    mIntervalsArgTmp.data());
+
+            for (int suffixLevelStart = suffixLevelMinStart; suffixLevelStart <= suffixLevelMaxStart; suffixLevelStart++) {
+                if (mIntervalsTmp[suffixLevelStart] == Instance::NO_VALUE
+                    || suffixCosts[suffixLevelStart] == Instance::NO_VALUE) {
+                    continue;
+                }
 
-            for (int prevLevelStart = prevLevelMinStart; prevLevelStart <= prevLevelMaxStart; prevLevelStart++) {
-                int cost = mIntervalsTmp[prevLevelStart];
-                if (cost != Instance::NO_VALUE && mOptCost > cost) {
+                int cost = mIntervalsTmp[suffixLevelStart] + suffixCosts[suffixLevelStart];
+                if (mOptCost > cost) {
                     mOptCost = cost;
-                    mLastLevelOptStart = prevLevelStart;
+                    mLastLevelOptStart = mIntervalsArgTmp[suffixLevelStart];
+                    mRelaxedSuffixOptStart = suffixLevelStart;
                 }
             }
         }
 
+        // The pruned states might have completed to a cost less than the bound.
+        mPrunedByBound = (mOptCost != Instance::NO_VALUE && mOptCost >= upperBound)
+                || (mOptCost == Instance::NO_VALUE && mCostsBoundPrunedPosition >= 0);
+        if (mOptCost >= upperBound) {
+            mOptCost = Instance::NO_VALUE;
+        }
+
         mStopwatch.stop();
 
         return mOptCost;
     }
 
+    vector<int> FixedPermCostComputation::findPrefixTrieOrder(const vector<vector<int>> &permutations) {
+        // In the lexicographic order, the common prefixes of the adjacent permutations are the branchings of the trie,
+        // the costs of the positions before them are reused by setPermutation.
+        vector<int> order(permutations.size());
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+            return permutations[lhs] < permutations[rhs];
+        });
+
+        return order;
+    }
+
+    vector<int> FixedPermCostComputation::computeCosts(const vector<vector<int>> &permutations, int upperBound) {
+        return this->computeCosts(
+                permutations,
+                upperBound,
+                vector<const PrefixCheckpoint*>(permutations.size(), nullptr),
+                [](int /*idx*/, int /*cost*/) {});
+    }
+
+    vector<int> FixedPermCostComputation::computeCosts(
+            const vector<vector<int>> &permutations,
+            int upperBound,
+            const vector<const PrefixCheckpoint*> &checkpoints,
+            const function<void(int, int)> &evaluated) {
+        vector<int> costs(permutations.size(), Instance::NO_VALUE);
+        for (int idx : this->findPrefixTrieOrder(permutations)) {
+            if (checkpoints[idx] != nullptr) {
+                this->restoreCheckpoint(permutations[idx], *checkpoints[idx]);
+            }
+            else {
+                this->setPermutation(permutations[idx]);
+            }
+
+            costs[idx] = this->recomputeCost(upperBound);
+            evaluated(idx, costs[idx]);
+        }
+
+        return costs;
+    }
+
+    vector<pair<int, vector<int>>> FixedPermCostComputation::computeCostsWithStartTimes(
+            const vector<vector<int>> &permutations) {
+        vector<pair<int, vector<int>>> costsWithStartTimes(permutations.size(), make_pair(Instance::NO_VALUE, vector<int>()));
+        for (int idx : this->findPrefixTrieOrder(permutations)) {
+            this->setPermutation(permutations[idx]);
+            int cost = this->recomputeCost();
+            if (cost != Instance::NO_VALUE) {
+                costsWithStartTimes[idx] = make_pair(cost, this->reconstructStartTimes());
+            }
+        }
+
+        return costsWithStartTimes;
+    }
+
+    bool FixedPermCostComputation::saveCheckpoint(int position, PrefixCheckpoint &checkpoint) const {
+        if (position < mCostsFirstValidPosition || position > mCostsValidPosition
+            || (mCostsEmptyPosition >= 0 && mCostsEmptyPosition <= position)
+            || !this->isCostsRowKept(position)) {
+            return false;
+        }
+
+        int level = mPermLevels[position];
+        int levelMinStart = mEarliestOnIntervalIdx + level;
+        int levelMaxStart = mLatestOnIntervalIdx - (mTotalProcTime - level) + 1;
+        const int *levelCosts = mCostsOnPositions[this->getCostsRow(position)];
+
+        checkpoint.mPosition = position;
+        checkpoint.mUpperBound = mCostsUpperBounds[position];
+        checkpoint.mBoundPruned = mCostsBoundPrunedPosition >= 0 && mCostsBoundPrunedPosition <= position;
+        checkpoint.mMinStart = levelMinStart;
+        checkpoint.mCosts.assign(levelCosts + levelMinStart, levelCosts + max(levelMinStart, levelMaxStart + 1));
+
+        return true;
+    }
+
+    void FixedPermCostComputation::restoreCheckpoint(const vector<int> &procTimes, const PrefixCheckpoint &checkpoint) {
+        this->setPermutation(procTimes);
+        if (checkpoint.mPosition <= mCostsValidPosition) {
+            return;
+        }
+
+        this->invalidateCosts(0);
+        mCostsValidLevel = mPermLevels[checkpoint.mPosition];
+        mCostsValidPosition = checkpoint.mPosition;
+        mCostsFirstValidPosition = checkpoint.mPosition;
+        mCostsEmptyPosition = -1;
+        mCostsBoundPrunedPosition = checkpoint.mBoundPruned ? checkpoint.mPosition : -1;
+
+        this->reserveCostsRows(checkpoint.mPosition);
+        int *levelCosts = mCostsOnPositions[this->getCostsRow(checkpoint.mPosition)];
+        fill(levelCosts, levelCosts + mNumIntervals, Instance::NO_VALUE);
+        copy(checkpoint.mCosts.begin(), checkpoint.mCosts.end(), levelCosts + checkpoint.mMinStart);
+        mCostsUpperBounds[checkpoint.mPosition] = checkpoint.mUpperBound;
+    }
+
     vector<int> FixedPermCostComputation::reconstructStartTimes() {
+        vector<int> permStartTimes;
+        this->reconstructStartTimes(permStartTimes);
+        return permStartTimes;
+    }
+
+    void FixedPermCostComputation::reconstructStartTimes(vector<int> &permStartTimes) {
+        if (mCostsFirstValidPosition > 0) {
+            // The opt path goes through the positions before the restored checkpoint.
+            this->invalidateCosts(0);
+        }
+
         if (this->recomputeCost() == Instance::NO_VALUE) {
             throw logic_error("Cannot reconstruct start times, does not have feasible schedule.");
         }
 
-        vector<int> permStartTimes(mPermLevels.size(), Instance::NO_VALUE);
+        permStartTimes.assign(mPermLevels.size(), Instance::NO_VALUE);
 
-        permStartTimes[permStartTimes.size() - 1] = mLastLevelOptStart;
-        for (int position = mPermLevels.size() - 1; position > 0; position--) {
-            permStartTimes[position - 1] = mOptPath[mPermLevels[position]][permStartTimes[position]];
+        // Suffix: follow the next starts of the relaxed suffix table.
+        int lastPosition = mPermLevels.size() - 1;
+        auto &suffix = mRelaxedSuffixes.at(mPermProcTimes[mRelaxedSuffixPosition]);
+        permStartTimes[mRelaxedSuffixPosition] = mRelaxedSuffixOptStart;
+        for (int position = mRelaxedSuffixPosition + 1; position <= lastPosition; position++) {
+            int suffixPositionsCount = lastPosition - position + 2;
+            permStartTimes[position] = suffix.mNextStarts[suffixPositionsCount][permStartTimes[position - 1]];
         }
 
-        return permStartTimes;
+        // Prefix: follow the opt path of the computed levels.
+        if (mRelaxedSuffixPosition > 0) {
+            permStartTimes[mRelaxedSuffixPosition - 1] = mLastLevelOptStart;
+        }
+        if (!mCostOnly) {
+            for (int position = mRelaxedSuffixPosition - 1; position > 0; position--) {
+                permStartTimes[position - 1] = mOptPath[position][permStartTimes[position]];
+            }
+            return;
+        }
+
+        // Cost-only mode: segment by segment from the end, each from the last kept costs before it.
+        int segmentLastPosition = mRelaxedSuffixPosition - 1;
+        while (segmentLastPosition > 0) {
+            int segmentFirstPosition = this->findKeptCostsPosition(segmentLastPosition - 1);
+            this->computeSegmentOptPath(segmentFirstPosition, segmentLastPosition);
+            for (int position = segmentLastPosition; position > segmentFirstPosition; position--) {
+                permStartTimes[position - 1] = mOptPath[position - segmentFirstPosition - 1][permStartTimes[position]];
+            }
+
+            segmentLastPosition = segmentFirstPosition;
+        }
     }
 }
@@ -4,9 +4,15 @@
 #ifndef ENERGYSTATESANDCOSTSSCHEDULING_FIXEDPERMCOSTCOMPUTATION_H
 #define ENERGYSTATESANDCOSTSSCHEDULING_FIXEDPERMCOSTCOMPUTATION_H
 
+#include <functional>
+#include <map>
 #include <vector>
 #include "../input/Instance.h"
 #include "../utils/Stopwatch.h"
+#include "SwitchingCostsGraph.h"
+#include "MongeSwitchingCosts.h"
+#include "AlignedMatrix.h"
+#include "InstanceCostTables.h"
 
 using namespace std;
 
@@ -14,56 +20,207 @@ namespace escs {
     class FixedPermCostComputation {
         // Position: position into permutation.
         // Level: vertical index.
+        friend class BidirectionalPermCostComputation; // Uses the transitions and the cost tables.
+
     private:
+        // Backward cost-to-go over the trailing positions having the same proc time and no forced spaces (e.g., the
+        // relaxed unit or gcd-sized positions in branch-and-bound). Row r (r >= 1) contains the optimal cost of
+        // scheduling the last r positions given the start of the first of them, i.e., the row is indexed by the start
+        // interval on level (totalProcTime - r * procTime). Rows are added lazily as longer suffixes are requested.
+        struct RelaxedSuffix {
+            vector<vector<int>> mCosts;
+            vector<vector<int>> mNextStarts;
+        };
+
         const int mTotalProcTime;
 
         int mOptCost;
+        bool mPrunedByBound; // See isPrunedByBound.
         int mLastLevelOptStart;
-        vector<vector<int>> mOptPath;
-        vector<vector<int>> mCostsOnLevels;
+        // Rows indexed by position (not by level), allocated only for the positions whose costs were computed. Since
+        // the positions before an invalidated one do not change, their rows stay valid. In the cost-only mode, see
+        // getCostsRow and computeSegmentOptPath.
+        AlignedRowPool<int> mOptPath;
+        AlignedRowPool<int> mCostsOnPositions;
         vector<int> mPermProcTimes;
         vector<int> mPermLevels;
         vector<int> mPermForcedSpaces;
         vector<int> mMaxProcessableIntervals;
+        bool mCostOnly; // If true, mOptPath is not written, the opt path is recomputed from the costs when needed.
+        // In the cost-only mode, the row of mCostsOnPositions of each position whose costs are kept, -1 if they are not.
+        vector<int> mKeptCostsRows;
+        int mKeptCostsRowsCount;
         int mCostsValidLevel; // On this level, the costs are valid.
         int mCostsValidPosition; // On this level, the costs are valid.
+        int mCostsFirstValidPosition; // The costs of the positions before it are not valid (0 unless restored).
+        int mCostsEmptyPosition; // The first valid position without any (unpruned) state, or -1 if none.
+        // The first valid position where a state that might complete to a feasible schedule was pruned by the bound, or
+        // -1 if none.
+        int mCostsBoundPrunedPosition;
+        vector<int> mCostsUpperBounds; // The upper bound under which the costs of the position were pruned.
+        int mRelaxedSuffixPosition; // The first position of the relaxed suffix used for mOptCost (or perm size if none).
+        int mRelaxedSuffixOptStart;
+        map<int, RelaxedSuffix> mRelaxedSuffixes; // Key: proc time of the suffix positions.
+        bool mRelaxedCompletionBounds; // If true, the completion bounds are taken from the unit relaxed suffix.
 
         const int mNumIntervals;
         const int mEarliestOnIntervalIdx;
         const int mLatestOnIntervalIdx;
 
-        const int mOnPowerConsumption;
+        const shared_ptr<const InstanceCostTables> mCostTables;
         const vector<vector<int>> &mOptSwitchingCosts;
-        vector<vector<int>> mOptSwitchingCostsTrans;
-        const vector<vector<int>> &mCumulEnergyCost;
-        vector<vector<int>> mCumulOnEnergyCostPerProcTime;
+        const AlignedMatrix<int> &mOptSwitchingCostsTrans;
+        const SwitchingCostsGraph *mSwitchingCostsGraph; // If not nullptr, used for the transitions where applicable.
+        const MongeSwitchingCosts *mMongeSwitchingCosts; // If not nullptr, used for the transitions not using the graph.
+        const AlignedMatrix<int> &mCumulOnEnergyCostPerProcTime;
         vector<bool> mProcessableIntervals;
 
         vector<int> mIntervalsTmp;
+        vector<int> mIntervalsArgTmp;
+        vector<int> mPrevLevelCostsTmp;
+        vector<long long> mStateCostsTmp;
+        vector<int> mStateOriginsTmp;
 
         Stopwatch mStopwatch;
+        long long mMongeTransitionsCount;
 
         int findNextProcessableInterval(const vector<bool> &processableIntervals, int fromIdx);
+        int findRelaxedSuffixPosition() const;
+        int getCostsRow(int position) const;
+        bool isCostsRowKept(int position) const;
+        int findKeptCostsPosition(int position) const;
+        void reserveCostsRows(int toPosition);
+        RelaxedSuffix &getRelaxedSuffix(int procTime, int positionsCount);
+        bool computeLevelsCosts(int toPosition, int upperBound);
+        void computeLevelCosts(int position, const int *prevLevelCosts, int *levelCosts, int *levelOptPath);
+        void computeSegmentOptPath(int fromPosition, int toPosition);
+        bool pruneLevelCosts(int position, int levelMinStart, int levelMaxStart, int upperBound);
+        bool pruneStates(
+                int position,
+                int *levelCosts,
+                int levelMinStart,
+                int levelMaxStart,
+                int upperBound,
+                bool &boundPruned) const;
+        void computeTransition(
+                const int *prevLevelCosts,
+                int prevLevelMinStart,
+                int prevProcTime,
+                int prevForcedSpace,
+                int currLevelMinStart,
+                int currLevelMaxStart,
+                int *transitionCosts,
+                int *transitionOptPath);
+        bool computeTransitionByGraph(
+                const int *prevLevelCosts,
+                int prevLevelMinStart,
+                int prevProcTime,
+                int prevForcedSpace,
+                int currLevelMinStart,
+                int currLevelMaxStart,
+                int *transitionCosts,
+                int *transitionOptPath);
+        void computeTransitionByMonge(
+                const int *prevLevelCosts,
+                int prevLevelMinStart,
+                int prevProcTime,
+                int prevForcedSpace,
+                int currLevelMinStart,
+                int currLevelMaxStart,
+                int *transitionCosts,
+                int *transitionOptPath);
+        void computeSuffixTransition(
+                const int *nextLevelCosts,
+                int nextLevelMaxStart,
+                int procTime,
+                int levelMinStart,
+                int levelMaxStart,
+                int *transitionCosts,
+                int *transitionNextStarts);
+        bool computeSuffixTransitionByGraph(
+                const int *nextLevelCosts,
+                int nextLevelMaxStart,
+                int procTime,
+                int levelMinStart,
+                int levelMaxStart,
+                int *transitionCosts,
+                int *transitionNextStarts);
+        void computeSuffixTransitionByMonge(
+                const int *nextLevelCosts,
+                int nextLevelMaxStart,
+                int procTime,
+                int levelMinStart,
+                int levelMaxStart,
+                int *transitionCosts,
+                int *transitionNextStarts);
 
     public:
+        // The costs of a position of a permutation, from which the computation of another permutation having the same
+        // prefix can continue (also in another instance sharing the cost tables).
+        struct PrefixCheckpoint {
+            int mPosition;
+            int mUpperBound; // The costs were pruned under this bound.
+            bool mBoundPruned; // Some states of the prefix were pruned by the bound (not for infeasibility).
+            int mMinStart;
+            vector<int> mCosts; // Indexed by the start minus mMinStart.
+        };
 
         FixedPermCostComputation(
                 int totalProcTime,
                 int numIntervals,
                 int earliestOnIntervalIdx,
                 int latestOnIntervalIdx,
-                int onPowerConsumption,
-                const vector<vector<int>> &optSwitchingCosts,
-                const vector<vector<int>> &cumulEnergyCost,
-                const vector<bool> &processableIntervals);
+                shared_ptr<const InstanceCostTables> costTables,
+                const vector<bool> &processableIntervals,
+                const SwitchingCostsGraph *switchingCostsGraph,
+                const MongeSwitchingCosts *mongeSwitchingCosts);
 
         void join(int fromPosition, int positionsCount);
         void split(int fromPosition, int positionsCount);
         void split(int fromPosition, const vector<int> &procTimes);
         void setProcTimes(int fromPosition, int procTime);
+        // Sets the whole permutation (its proc times must sum to the total proc time), the forced spaces are kept. The
+        // costs of the common prefix with the previous permutation stay valid.
+        void setPermutation(const vector<int> &procTimes);
         void invalidateCosts(int fromPosition);
         int recomputeCost();
+        // Returns the opt cost if it is less than upperBound, otherwise Instance::NO_VALUE (the permutation is dominated
+        // by the bound or infeasible). The states whose cost plus a lower bound on their completion is not less than
+        // upperBound are pruned, and the computation stops as soon as all the states of a position are pruned.
+        int recomputeCost(int upperBound);
+        // Whether the last recomputeCost returned Instance::NO_VALUE only because of the bound: either the opt cost is
+        // not less than it, or some states were pruned by it (the permutation might be feasible). If false, the
+        // permutation is infeasible (or its cost was returned).
+        bool isPrunedByBound() const {
+            return mPrunedByBound;
+        }
+        // Batch evaluation: the costs (as by recomputeCost(upperBound)) of the permutations, in their order. The
+        // permutations are evaluated in the order of findPrefixTrieOrder, so the costs of each distinct prefix are
+        // computed once. The last of them is left set.
+        vector<int> computeCosts(const vector<vector<int>> &permutations, int upperBound);
+        // As computeCosts, each permutation continues from its checkpoint if not nullptr (see restoreCheckpoint), and
+        // evaluated(idx, cost) is called right after its cost, while it is set (e.g., to read isPrunedByBound or to save
+        // its checkpoints).
+        vector<int> computeCosts(
+                const vector<vector<int>> &permutations,
+                int upperBound,
+                const vector<const PrefixCheckpoint*> &checkpoints,
+                const function<void(int, int)> &evaluated);
+        // As computeCosts without a bound, with the start times of the feasible permutations (empty if infeasible).
+        vector<pair<int, vector<int>>> computeCostsWithStartTimes(const vector<vector<int>> &permutations);
+        // The order of the batch evaluation: the lexicographic order, i.e., the depth-first order of their prefix trie,
+        // so that setPermutation computes the costs of each distinct prefix once.
+        static vector<int> findPrefixTrieOrder(const vector<vector<int>> &permutations);
+        // Returns false if the costs of the position are not computed (e.g., it is in the relaxed suffix or the
+        // computation stopped before it).
+        bool saveCheckpoint(int position, PrefixCheckpoint &checkpoint) const;
+        // Sets the permutation as setPermutation and continues from the checkpoint unless more positions are valid
+        // already. The permutation of the checkpoint must have the same proc times and forced spaces up to its position.
+        // The positions before the checkpoint have no costs, reconstructStartTimes computes them from scratch.
+        void restoreCheckpoint(const vector<int> &procTimes, const PrefixCheckpoint &checkpoint);
         vector<int> reconstructStartTimes();
+        // As reconstructStartTimes, into the given vector (reusing its memory).
+        void reconstructStartTimes(vector<int> &permStartTimes);
         void reset();
 
         int getOptCost() {
@@ -82,6 +239,18 @@ namespace escs {
             return mStopwatch.totalDuration();
         }
 
+        long long getMongeTransitionsCount() const {
+            return mMongeTransitionsCount;
+        }
+
+        // In the cost-only mode, the transitions do not store the opt path (the argmins), and the costs are kept only
+        // for every ceil(sqrt(total proc time))-th position, the given checkpoint positions (e.g., the ones passed to
+        // saveCheckpoint), the restored one and the last computed one. This takes O(sqrt(positions) * intervals)
+        // memory instead of O(positions * intervals) if mostly the costs are needed. A changed permutation continues
+        // from the last kept position before the change, and reconstructStartTimes recomputes the opt path segment by
+        // segment from the kept costs (the same start times as without the mode).
+        void setCostOnly(bool costOnly, const vector<int> &checkpointPositions = vector<int>());
+
         void setForcedSpace(int position, int space) {
             mPermForcedSpaces[position] = space;
             this->invalidateCosts(position);
@@ -2,69 +2,29 @@
 // See file LICENSE.txt for more information.
 
 #include <algorithm>
+#include <numeric>
 #include <vector>
-#include <set>
 #include "GcdOfValues.h"
 
 using namespace std;
 
 namespace escs {
 
-    GcdOfValues::GcdOfValues(vector<int> allValues) : mGcd()
+    GcdOfValues::GcdOfValues(vector<int> allValues) : mValues(), mCounts(), mLeavesCount(1), mTree()
     {
         // Replace duplicates in allValues
-        {
-            set<int> setAllValues(allValues.begin(), allValues.end());
-            allValues = vector<int>(setAllValues.begin(), setAllValues.end());
-        }
-
-        int maxValue = *(max_element(allValues.begin(), allValues.end()));
-        mGcd = vector<vector<int>>(maxValue + 1, vector<int>(maxValue + 1, -1));
+        sort(allValues.begin(), allValues.end());
+        allValues.erase(unique(allValues.begin(), allValues.end()), allValues.end());
+        mValues = allValues;
+        mCounts = vector<int>(mValues.size(), 0);
 
-        // Compute the gcd of every ordered pair.
-        // Gcd is computed using Euclidean algorithm (modulo version) with caching of intermediate gcds. This way,
-        // the computation of gcd for all pairs should be faster since we can lookup the already computed gcds.
-        for (int i = 0; i < (int)allValues.size(); i++) {
-            int iValue = allValues[i];
-            mGcd[iValue][iValue] = iValue;
-
-            for (int j = i + 1; j < (int)allValues.size(); j++) {
-                int jValue = allValues[j];
-                if (iValue >= jValue) {
-                    computeGcdTrace(iValue, jValue);
-                }
-                else {
-                    computeGcdTrace(jValue, iValue);
-                }
-            }
+        while (mLeavesCount < (int)mValues.size()) {
+            mLeavesCount *= 2;
         }
+        mTree = vector<int>(2 * mLeavesCount, 0);
     }
 
-    int GcdOfValues::computeGcdTrace(int a, int b) {
-        // Expects: a >= b
-        int gcd = mGcd[a][b];
-
-        if (gcd >= 1) {
-            // Already computed.
-            return gcd;
-        }
-
-        if (b == 0) {
-            gcd = a;
-            mGcd[a][b] = gcd;
-            mGcd[b][a] = gcd;
-            return a;
-        }
-
-        gcd = computeGcdTrace(b, a % b);
-        mGcd[a][b] = gcd;
-        mGcd[b][a] = gcd;
-        return gcd;
-    }
-
-    int GcdOfValues::gcd(const vector<int> &values) {
-        // The values must be a subset of allValues passed in constructor.
-
+    int GcdOfValues::gcd(const vector<int> &values) const {
         // Exploits the following property
         // gcd(a, b, c) = gcd(gcd(a, b), c)
         int currGcd = values[0];
@@ -74,16 +34,38 @@ namespace escs {
                 return currGcd;
             }
 
-            int value = values[i];
-
-            if (currGcd >= value) {
-                currGcd = computeGcdTrace(currGcd, value);
-            }
-            else {
-                currGcd = computeGcdTrace(value, currGcd);
-            }
+            currGcd = std::gcd(currGcd, values[i]);
         }
 
         return currGcd;
     }
+
+    void GcdOfValues::setLeaf(int valueIdx, int value) {
+        int node = mLeavesCount + valueIdx;
+        mTree[node] = value;
+        for (node /= 2; node >= 1; node /= 2) {
+            mTree[node] = std::gcd(mTree[2 * node], mTree[2 * node + 1]);
+        }
+    }
+
+    void GcdOfValues::setCounts(const vector<int> &counts) {
+        mCounts = counts;
+        fill(mTree.begin(), mTree.end(), 0);
+        for (int valueIdx = 0; valueIdx < (int)mValues.size(); valueIdx++) {
+            mTree[mLeavesCount + valueIdx] = mCounts[valueIdx] > 0 ? mValues[valueIdx] : 0;
+        }
+        for (int node = mLeavesCount - 1; node >= 1; node--) {
+            mTree[node] = std::gcd(mTree[2 * node], mTree[2 * node + 1]);
+        }
+    }
+
+    void GcdOfValues::addCount(int valueIdx, int delta) {
+        bool present = mCounts[valueIdx] > 0;
+        mCounts[valueIdx] += delta;
+
+        // The gcd changes only if the value appears or disappears.
+        if (present != (mCounts[valueIdx] > 0)) {
+            this->setLeaf(valueIdx, mCounts[valueIdx] > 0 ? mValues[valueIdx] : 0);
+        }
+    }
 }
@@ -9,16 +9,33 @@
 using namespace std;
 
 namespace escs {
+    // Gcd of the values, and incrementally of a multiset of them given by the counts of the distinct values (indexed
+    // in the ascending order of the values). The multiset is kept as a segment tree over the distinct values, each
+    // node holding the gcd of the values of its range with nonzero counts (0 if none), so that a count change updates
+    // the gcd in O(log k) for k distinct values.
     class GcdOfValues {
     private:
-        vector<vector<int>> mGcd;
+        vector<int> mValues; // Distinct, ascending.
+        vector<int> mCounts;
+        int mLeavesCount;
+        vector<int> mTree; // The root is 1, the children of i are 2i and 2i + 1, the leaves start at mLeavesCount.
 
-        int computeGcdTrace(int a, int b);
+        void setLeaf(int valueIdx, int value);
 
     public:
         GcdOfValues(vector<int> allValues);
 
-        int gcd(const vector<int> &values) ;
+        int gcd(const vector<int> &values) const;
+
+        // Sets the counts of the distinct values (the multiset).
+        void setCounts(const vector<int> &counts);
+
+        void addCount(int valueIdx, int delta);
+
+        // The gcd of the multiset, 0 if empty.
+        int getGcd() const {
+            return mTree[1];
+        }
     };
 }
 
@@ -0,0 +1,59 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include "InstanceCostTables.h"
+#include "../input/Instance.h"
+
+namespace escs {
+    InstanceCostTables::InstanceCostTables(
+            const vector<vector<int>> &optSwitchingCosts,
+            shared_ptr<const AlignedMatrix<int>> cumulOnEnergyCostPerProcTime)
+                : mOptSwitchingCosts(optSwitchingCosts),
+                  mOptSwitchingCostsTrans(),
+                  mCumulOnEnergyCostPerProcTime(cumulOnEnergyCostPerProcTime),
+                  mNonNegativeCosts(true) {
+        int optSwitchingCostsRowsCount = optSwitchingCosts.size();
+        int optSwitchingCostsColsCount = optSwitchingCosts[0].size();
+        mOptSwitchingCostsTrans = AlignedMatrix<int>(
+                optSwitchingCostsColsCount,
+                optSwitchingCostsRowsCount,
+                Instance::NO_VALUE);
+        for (int row = 0; row < optSwitchingCostsRowsCount; row++) {
+            for (int col = 0; col < optSwitchingCostsColsCount; col++) {
+                mOptSwitchingCostsTrans[col][row] = optSwitchingCosts[row][col];
+                mNonNegativeCosts &= optSwitchingCosts[row][col] >= 0;
+            }
+        }
+
+        auto &cumulOnEnergyCost = *mCumulOnEnergyCostPerProcTime;
+        for (int procTime = 0; procTime < cumulOnEnergyCost.getRowsCount(); procTime++) {
+            for (int col = 0; col < cumulOnEnergyCost.getColsCount(); col++) {
+                mNonNegativeCosts &= cumulOnEnergyCost[procTime][col] >= 0;
+            }
+        }
+    }
+
+    shared_ptr<const AlignedMatrix<int>> InstanceCostTables::createCumulOnEnergyCostPerProcTime(
+            const vector<vector<int>> &cumulEnergyCost,
+            int onPowerConsumption,
+            int maxProcTime) {
+        int numIntervals = cumulEnergyCost.size();
+        auto cumulOnEnergyCostPerProcTime = make_shared<AlignedMatrix<int>>(
+                maxProcTime + 1,
+                numIntervals,
+                Instance::NO_VALUE);
+        cumulOnEnergyCostPerProcTime->fillRow(0, 0);
+        for (int procTime = 1; procTime <= maxProcTime; procTime++) {
+            for (int startIntervalIdx = 0; startIntervalIdx < numIntervals; startIntervalIdx++) {
+                int endIntervalIdx = startIntervalIdx + procTime - 1;
+                if (endIntervalIdx >= numIntervals) {
+                    continue;
+                }
+                (*cumulOnEnergyCostPerProcTime)[procTime][startIntervalIdx] =
+                        cumulEnergyCost[startIntervalIdx][endIntervalIdx] * onPowerConsumption;
+            }
+        }
+
+        return cumulOnEnergyCostPerProcTime;
+    }
+}
@@ -0,0 +1,61 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#ifndef ENERGYSTATESANDCOSTSSCHEDULING_INSTANCECOSTTABLES_H
+#define ENERGYSTATESANDCOSTSSCHEDULING_INSTANCECOSTTABLES_H
+
+#include <memory>
+#include <vector>
+#include "AlignedMatrix.h"
+
+using namespace std;
+
+namespace escs {
+    // The tables derived from the switching costs and the energy costs of an instance that are read by the cost
+    // computations. Built once per instance and switching costs, then shared read-only by all the cost computations
+    // (and threads); the energy table is shared by the tables of all the switching costs of an instance.
+    class InstanceCostTables {
+    private:
+        const vector<vector<int>> &mOptSwitchingCosts;
+        AlignedMatrix<int> mOptSwitchingCostsTrans;
+        shared_ptr<const AlignedMatrix<int>> mCumulOnEnergyCostPerProcTime;
+        bool mNonNegativeCosts;
+
+    public:
+        // The switching costs must outlive the tables (they are owned by the instance).
+        InstanceCostTables(
+                const vector<vector<int>> &optSwitchingCosts,
+                shared_ptr<const AlignedMatrix<int>> cumulOnEnergyCostPerProcTime);
+
+        // Row: proc time (up to maxProcTime), column: start interval. The on energy cost of processing from the start
+        // for the proc time, Instance::NO_VALUE if the processing does not fit the intervals.
+        static shared_ptr<const AlignedMatrix<int>> createCumulOnEnergyCostPerProcTime(
+                const vector<vector<int>> &cumulEnergyCost,
+                int onPowerConsumption,
+                int maxProcTime);
+
+        const vector<vector<int>> &getOptSwitchingCosts() const {
+            return mOptSwitchingCosts;
+        }
+
+        // Row: start, column: completion.
+        const AlignedMatrix<int> &getOptSwitchingCostsTrans() const {
+            return mOptSwitchingCostsTrans;
+        }
+
+        const AlignedMatrix<int> &getCumulOnEnergyCostPerProcTime() const {
+            return *mCumulOnEnergyCostPerProcTime;
+        }
+
+        // The precondition of the min-plus kernel (see computeMinPlusArgmin) on the costs of the cost computations.
+        bool hasNonNegativeCosts() const {
+            return mNonNegativeCosts;
+        }
+
+        int getMaxProcTime() const {
+            return mCumulOnEnergyCostPerProcTime->getRowsCount() - 1;
+        }
+    };
+}
+
+#endif //ENERGYSTATESANDCOSTSSCHEDULING_INSTANCECOSTTABLES_H
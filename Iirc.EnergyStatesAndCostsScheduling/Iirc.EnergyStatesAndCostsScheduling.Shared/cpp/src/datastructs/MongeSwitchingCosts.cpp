@@ -0,0 +1,131 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <functional>
+#include "MongeSwitchingCosts.h"
+#include "../input/Instance.h"
+
+namespace escs {
+    namespace {
+        // Computes the window [mins[row], maxs[row]] of the columns having a switching cost for each row in
+        // [minIdx, maxIdx]. Returns false if some window is not contiguous or the windows are not non-decreasing.
+        bool computeWindows(
+                int minIdx,
+                int maxIdx,
+                const function<bool(int, int)> &hasCost,
+                vector<int> &mins,
+                vector<int> &maxs) {
+            int prevMin = minIdx;
+            int prevMax = minIdx - 1;
+            for (int row = minIdx; row <= maxIdx; row++) {
+                int min = minIdx;
+                while (min <= maxIdx && !hasCost(row, min)) {
+                    min++;
+                }
+
+                int max = min;
+                while (max + 1 <= maxIdx && hasCost(row, max + 1)) {
+                    max++;
+                }
+
+                for (int col = max + 1; col <= maxIdx; col++) {
+                    if (hasCost(row, col)) {
+                        return false;
+                    }
+                }
+
+                if (min > maxIdx) {
+                    // Empty window, filled below.
+                    mins[row] = Instance::NO_VALUE;
+                    maxs[row] = prevMax;
+                    continue;
+                }
+
+                if (min < prevMin || max < prevMax) {
+                    return false;
+                }
+
+                mins[row] = min;
+                maxs[row] = max;
+                prevMin = min;
+                prevMax = max;
+            }
+
+            int nextMin = maxIdx + 1;
+            for (int row = maxIdx; row >= minIdx; row--) {
+                if (mins[row] == Instance::NO_VALUE) {
+                    mins[row] = nextMin;
+                }
+                else {
+                    nextMin = mins[row];
+                }
+            }
+
+            return true;
+        }
+    }
+
+    shared_ptr<const MongeSwitchingCosts> MongeSwitchingCosts::create(
+            const vector<vector<int>> &optSwitchingCosts,
+            int earliestOnIntervalIdx,
+            int latestOnIntervalIdx) {
+        int minIntervalIdx = earliestOnIntervalIdx + 1;
+        int maxIntervalIdx = latestOnIntervalIdx;
+        if (minIntervalIdx > maxIntervalIdx || (int)optSwitchingCosts.size() <= maxIntervalIdx) {
+            return nullptr;
+        }
+
+        auto hasCost = [&](int completion, int start) {
+            return completion <= start && optSwitchingCosts[completion][start] != Instance::NO_VALUE;
+        };
+
+        auto monge = make_shared<MongeSwitchingCosts>();
+        int numIndices = optSwitchingCosts.size();
+        monge->mMinCompletions = vector<int>(numIndices, Instance::NO_VALUE);
+        monge->mMaxCompletions = vector<int>(numIndices, Instance::NO_VALUE);
+        monge->mMinStarts = vector<int>(numIndices, Instance::NO_VALUE);
+        monge->mMaxStarts = vector<int>(numIndices, Instance::NO_VALUE);
+
+        bool hasWindows =
+                computeWindows(
+                        minIntervalIdx,
+                        maxIntervalIdx,
+                        [&](int start, int completion) { return hasCost(completion, start); },
+                        monge->mMinCompletions,
+                        monge->mMaxCompletions)
+                && computeWindows(
+                        minIntervalIdx,
+                        maxIntervalIdx,
+                        [&](int completion, int start) { return hasCost(completion, start); },
+                        monge->mMinStarts,
+                        monge->mMaxStarts);
+        if (!hasWindows) {
+            return nullptr;
+        }
+
+        // Since both the windows of the starts and of the completions are contiguous, every submatrix having the
+        // switching costs in its corners has all the switching costs, hence it suffices to check the adjacent ones.
+        for (int completion = minIntervalIdx; completion < maxIntervalIdx; completion++) {
+            for (int start = completion; start < maxIntervalIdx; start++) {
+                if (!hasCost(completion, start)
+                    || !hasCost(completion + 1, start + 1)
+                    || !hasCost(completion + 1, start)
+                    || !hasCost(completion, start + 1)) {
+                    continue;
+                }
+
+                long long diagonal =
+                        (long long)optSwitchingCosts[completion][start]
+                        + optSwitchingCosts[completion + 1][start + 1];
+                long long antiDiagonal =
+                        (long long)optSwitchingCosts[completion + 1][start]
+                        + optSwitchingCosts[completion][start + 1];
+                if (diagonal > antiDiagonal) {
+                    return nullptr;
+                }
+            }
+        }
+
+        return monge;
+    }
+}
@@ -0,0 +1,53 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#ifndef ENERGYSTATESANDCOSTSSCHEDULING_MONGESWITCHINGCOSTS_H
+#define ENERGYSTATESANDCOSTSSCHEDULING_MONGESWITCHINGCOSTS_H
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+namespace escs {
+    // The windows of the switching costs matrix if it is Monge on its finite entries, i.e.,
+    //   sw[c][s] + sw[c + 1][s + 1] <= sw[c + 1][s] + sw[c][s + 1]
+    // for all the completions c and starts s in [earliestOnIntervalIdx + 1, latestOnIntervalIdx] where the four entries
+    // have a switching cost. Then, the leftmost argmin of (cost of completion + switching cost) is non-decreasing in the
+    // start (and vice versa), so a DP transition can be computed by divide and conquer in O(intervals log intervals).
+    //
+    // The matrix is accepted only if the completions having a switching cost to a start form a contiguous window with
+    // non-decreasing begin and end over the starts, and the same holds for the starts of each completion. The windows
+    // of the rows without any switching cost are filled so that both window bounds stay non-decreasing.
+    class MongeSwitchingCosts {
+    private:
+        vector<int> mMinCompletions;
+        vector<int> mMaxCompletions;
+        vector<int> mMinStarts;
+        vector<int> mMaxStarts;
+
+    public:
+        static shared_ptr<const MongeSwitchingCosts> create(
+                const vector<vector<int>> &optSwitchingCosts,
+                int earliestOnIntervalIdx,
+                int latestOnIntervalIdx);
+
+        int getMinCompletion(int start) const {
+            return mMinCompletions[start];
+        }
+
+        int getMaxCompletion(int start) const {
+            return mMaxCompletions[start];
+        }
+
+        int getMinStart(int completion) const {
+            return mMinStarts[completion];
+        }
+
+        int getMaxStart(int completion) const {
+            return mMaxStarts[completion];
+        }
+    };
+}
+
+#endif //ENERGYSTATESANDCOSTSSCHEDULING_MONGESWITCHINGCOSTS_H
@@ -0,0 +1,62 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <algorithm>
+#include "OpenNodeQueue.h"
+
+namespace escs {
+    OpenNodeQueue::OpenNodeQueue(optional<long long> memoryLimit)
+            : mMemoryLimit(memoryLimit.value_or(-1)), mMemory(0) {
+    }
+
+    long long OpenNodeQueue::estimateMemory(const OpenNode &openNode) {
+        // The node, its step (allocated with the shared pointer control block) and the inherited blocks.
+        return sizeof(OpenNode)
+               + sizeof(PathStep) + 2 * sizeof(long)
+               + openNode.mRemProcBlocksReversed.capacity() * sizeof(Block);
+    }
+
+    bool OpenNodeQueue::push(OpenNode openNode) {
+        long long memory = this->estimateMemory(openNode);
+        if (mMemoryLimit >= 0 && mMemory + memory > mMemoryLimit) {
+            return false;
+        }
+
+        mMemory += memory;
+        mOpenNodes.push_back(move(openNode));
+        push_heap(mOpenNodes.begin(), mOpenNodes.end(), OpenNodeComparer());
+        return true;
+    }
+
+    bool OpenNodeQueue::pop(int upperBound, OpenNode &openNode) {
+        while (!mOpenNodes.empty()) {
+            pop_heap(mOpenNodes.begin(), mOpenNodes.end(), OpenNodeComparer());
+            openNode = move(mOpenNodes.back());
+            mOpenNodes.pop_back();
+            mMemory -= this->estimateMemory(openNode);
+            if (openNode.mLowerBound < upperBound) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    optional<int> OpenNodeQueue::getMinLowerBound() const {
+        if (mOpenNodes.empty()) {
+            return optional<int>();
+        }
+
+        return mOpenNodes.front().mLowerBound;
+    }
+
+    vector<const OpenNodeQueue::PathStep*> OpenNodeQueue::getSteps(const shared_ptr<const PathStep> &path) {
+        vector<const PathStep*> steps;
+        for (auto *pStep = path.get(); pStep != nullptr; pStep = pStep->mParent.get()) {
+            steps.push_back(pStep);
+        }
+        reverse(steps.begin(), steps.end());
+
+        return steps;
+    }
+}
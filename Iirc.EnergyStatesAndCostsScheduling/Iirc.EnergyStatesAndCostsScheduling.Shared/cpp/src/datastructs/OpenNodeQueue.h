@@ -0,0 +1,76 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#ifndef ENERGYSTATESANDCOSTSSCHEDULING_OPENNODEQUEUE_H
+#define ENERGYSTATESANDCOSTSSCHEDULING_OPENNODEQUEUE_H
+
+#include <memory>
+#include <optional>
+#include <vector>
+#include "Block.h"
+
+using namespace std;
+
+namespace escs {
+    // The open nodes of the best-first search of the branch-and-bound, the node with the least lower bound first (the
+    // deeper one on ties). A node is stored compactly: its fixed proc times are a single step appended to the path of
+    // its parent (shared by all the siblings), the remaining proc times follow from the path. The queue is not
+    // thread-safe.
+    class OpenNodeQueue {
+    public:
+        struct PathStep {
+            shared_ptr<const PathStep> mParent;
+            int mProcTime;
+            bool mStartsBlock; // Otherwise joined to the block of the previous proc time.
+        };
+
+        struct OpenNode {
+            shared_ptr<const PathStep> mPath;
+            int mDepth;
+            int mLowerBound;
+            bool mLowerBoundInherited;
+            bool mJoinToPrevBlock;
+            int mJoinedGcd;
+            vector<Block> mRemProcBlocksReversed; // Only if the lower bound is inherited.
+        };
+
+    private:
+        struct OpenNodeComparer {
+            bool operator()(const OpenNode &lhs, const OpenNode &rhs) const {
+                if (lhs.mLowerBound != rhs.mLowerBound) {
+                    return lhs.mLowerBound > rhs.mLowerBound;
+                }
+
+                return lhs.mDepth < rhs.mDepth;
+            }
+        };
+
+        const long long mMemoryLimit;
+        long long mMemory;
+        vector<OpenNode> mOpenNodes; // A heap by OpenNodeComparer.
+
+        static long long estimateMemory(const OpenNode &openNode);
+
+    public:
+        // The memory limit (in bytes, estimated) of the stored nodes, none if unlimited.
+        OpenNodeQueue(optional<long long> memoryLimit);
+
+        // Returns false if the memory limit is reached, the node is not stored then.
+        bool push(OpenNode openNode);
+
+        // Takes the best node whose lower bound is less than upperBound, the others are dropped. Returns false if none.
+        bool pop(int upperBound, OpenNode &openNode);
+
+        optional<int> getMinLowerBound() const;
+
+        bool empty() const {
+            return mOpenNodes.empty();
+        }
+
+        // The steps of the path from the first one.
+        static vector<const PathStep*> getSteps(const shared_ptr<const PathStep> &path);
+    };
+}
+
+
+#endif //ENERGYSTATESANDCOSTSSCHEDULING_OPENNODEQUEUE_H
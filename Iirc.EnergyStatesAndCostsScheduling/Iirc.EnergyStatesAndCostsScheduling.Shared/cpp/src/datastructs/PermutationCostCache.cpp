@@ -0,0 +1,98 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <algorithm>
+#include "PermutationCostCache.h"
+#include "../input/Instance.h"
+
+namespace escs {
+    PermutationCostCache::PermutationCostCache(int capacity, int shardsCount)
+            : mShardCapacity(max(1, capacity / max(1, shardsCount))),
+              mShards(),
+              mHitsCount(0),
+              mMissesCount(0) {
+        for (int shardIdx = 0; shardIdx < max(1, shardsCount); shardIdx++) {
+            mShards.emplace_back(new Shard());
+        }
+    }
+
+    size_t PermutationCostCache::computeHash(const vector<int> &procTimes) {
+        // FNV-1a over the proc times.
+        size_t hash = 14695981039346656037ULL;
+        for (int procTime : procTimes) {
+            hash ^= (size_t)procTime;
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+    PermutationCostCache::Shard &PermutationCostCache::getShard(size_t hash) {
+        // The high bits, the low ones select the bucket within the shard.
+        return *mShards[(hash >> 32) % mShards.size()];
+    }
+
+    bool PermutationCostCache::find(const vector<int> &procTimes, int upperBound, int &cost) {
+        bool prunedByBound;
+        return this->find(procTimes, upperBound, cost, prunedByBound);
+    }
+
+    bool PermutationCostCache::find(const vector<int> &procTimes, int upperBound, int &cost, bool &prunedByBound) {
+        size_t hash = computeHash(procTimes);
+        auto &shard = getShard(hash);
+        {
+            lock_guard<mutex> lock(shard.mMutex);
+            auto it = shard.mEntries.find(hash);
+            if (it != shard.mEntries.end() && it->second.mProcTimes == procTimes) {
+                auto &entry = it->second;
+                if (entry.mCost != Instance::NO_VALUE) {
+                    cost = entry.mCost < upperBound ? entry.mCost : Instance::NO_VALUE;
+                    prunedByBound = entry.mCost >= upperBound;
+                    mHitsCount++;
+                    return true;
+                }
+
+                // Not less than the recorded bound, hence neither less than a lower bound.
+                if (upperBound <= entry.mUpperBound) {
+                    cost = Instance::NO_VALUE;
+                    prunedByBound = entry.mUpperBound != Instance::NO_VALUE;
+                    mHitsCount++;
+                    return true;
+                }
+            }
+        }
+
+        mMissesCount++;
+        return false;
+    }
+
+    void PermutationCostCache::insert(const vector<int> &procTimes, int upperBound, int cost) {
+        size_t hash = computeHash(procTimes);
+        auto &shard = getShard(hash);
+        lock_guard<mutex> lock(shard.mMutex);
+        auto it = shard.mEntries.find(hash);
+        if (it != shard.mEntries.end()) {
+            auto &entry = it->second;
+            if (entry.mProcTimes != procTimes) {
+                // Collision, the newer sequence replaces the older one.
+                entry = Entry {procTimes, cost, upperBound};
+            }
+            else if (cost != Instance::NO_VALUE) {
+                entry.mCost = cost;
+            }
+            else if (entry.mCost == Instance::NO_VALUE) {
+                entry.mUpperBound = max(entry.mUpperBound, upperBound);
+            }
+
+            return;
+        }
+
+        while ((int)shard.mEntries.size() >= mShardCapacity) {
+            shard.mEntries.erase(shard.mInsertionOrder.front());
+            shard.mInsertionOrder.pop_front();
+        }
+
+        shard.mEntries.emplace(hash, Entry {procTimes, cost, upperBound});
+        shard.mInsertionOrder.push_back(hash);
+    }
+}
@@ -0,0 +1,65 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#ifndef ENERGYSTATESANDCOSTSSCHEDULING_PERMUTATIONCOSTCACHE_H
+#define ENERGYSTATESANDCOSTSSCHEDULING_PERMUTATIONCOSTCACHE_H
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace escs {
+    // Bounded cache of the costs of the permutations (sequences of proc times), safe for concurrent use. The entries
+    // are split into shards by the hash of the sequence, each shard has its own lock and evicts its oldest entries
+    // when full. The sequences are stored with the entries, hence a hash collision is a miss, never a wrong cost.
+    class PermutationCostCache {
+    private:
+        struct Entry {
+            vector<int> mProcTimes;
+            int mCost; // The cost, or Instance::NO_VALUE if the cost is not less than mUpperBound.
+            int mUpperBound;
+        };
+
+        struct Shard {
+            mutex mMutex;
+            unordered_map<size_t, Entry> mEntries;
+            deque<size_t> mInsertionOrder;
+        };
+
+        const int mShardCapacity;
+        vector<unique_ptr<Shard>> mShards;
+        atomic<long long> mHitsCount;
+        atomic<long long> mMissesCount;
+
+        static size_t computeHash(const vector<int> &procTimes);
+        Shard &getShard(size_t hash);
+
+    public:
+        PermutationCostCache(int capacity, int shardsCount);
+
+        // If known, sets cost to the result of FixedPermCostComputation::recomputeCost(upperBound) and returns true.
+        bool find(const vector<int> &procTimes, int upperBound, int &cost);
+        // As find, also sets prunedByBound to the result of FixedPermCostComputation::isPrunedByBound. The infeasible
+        // permutations must be recorded under the bound Instance::NO_VALUE to be told from the pruned ones.
+        bool find(const vector<int> &procTimes, int upperBound, int &cost, bool &prunedByBound);
+
+        // Records the result of FixedPermCostComputation::recomputeCost(upperBound).
+        void insert(const vector<int> &procTimes, int upperBound, int cost);
+
+        long long getHitsCount() const {
+            return mHitsCount;
+        }
+
+        long long getMissesCount() const {
+            return mMissesCount;
+        }
+    };
+}
+
+
+#endif //ENERGYSTATESANDCOSTSSCHEDULING_PERMUTATIONCOSTCACHE_H
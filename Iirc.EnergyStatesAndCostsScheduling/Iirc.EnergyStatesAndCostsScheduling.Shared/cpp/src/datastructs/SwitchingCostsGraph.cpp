@@ -0,0 +1,174 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <limits>
+#include "SwitchingCostsGraph.h"
+#include "../input/Instance.h"
+
+namespace escs {
+    namespace {
+        // Outside the debug builds, the shortest paths are verified only from this many completions (evenly spaced,
+        // including the first and the last one): each costs O(intervals * edges).
+        const int VERIFIED_COMPLETIONS_COUNT = 16;
+    }
+
+    const long long SwitchingCostsGraph::NO_COST = numeric_limits<long long>::max() / 4;
+
+    shared_ptr<const SwitchingCostsGraph> SwitchingCostsGraph::create(
+            const StateDiagram &stateDiagram,
+            int lengthInterval,
+            int earliestOnIntervalIdx,
+            int latestOnIntervalIdx,
+            const vector<vector<int>> &optSwitchingCosts,
+            const vector<vector<int>> &cumulEnergyCost) {
+        int numIntervals = cumulEnergyCost.size();
+        int minIntervalIdx = earliestOnIntervalIdx + 1;
+        int maxIntervalIdx = latestOnIntervalIdx;
+        if (numIntervals == 0 || minIntervalIdx > maxIntervalIdx || (int)optSwitchingCosts.size() <= maxIntervalIdx) {
+            return nullptr;
+        }
+
+        auto graph = make_shared<SwitchingCostsGraph>();
+        graph->mStatesCount = stateDiagram.getStatesCount();
+        graph->mOnStateIdx = stateDiagram.mOnStateIdx;
+
+        graph->mPrefixEnergyCost = vector<long long>(numIntervals + 1, 0);
+        for (int intervalIdx = 0; intervalIdx < numIntervals; intervalIdx++) {
+            graph->mPrefixEnergyCost[intervalIdx + 1] = cumulEnergyCost[0][intervalIdx];
+        }
+
+        for (int fromStateIdx = 0; fromStateIdx < graph->mStatesCount; fromStateIdx++) {
+            for (int toStateIdx = 0; toStateIdx < graph->mStatesCount; toStateIdx++) {
+                if (stateDiagram.mTransitionTimes[fromStateIdx][toStateIdx] == Instance::NO_VALUE) {
+                    continue;
+                }
+
+                Edge edge;
+                edge.mFromStateIdx = fromStateIdx;
+                edge.mToStateIdx = toStateIdx;
+                if (fromStateIdx == toStateIdx) {
+                    // Remaining in the state.
+                    edge.mTime = 1;
+                    edge.mPowerConsumption =
+                            (long long)lengthInterval * stateDiagram.mStatesPowerConsumption[fromStateIdx];
+                }
+                else {
+                    edge.mTime = stateDiagram.mTransitionTimes[fromStateIdx][toStateIdx];
+                    edge.mPowerConsumption =
+                            (long long)lengthInterval
+                            * stateDiagram.mTransitionPowerConsumptions[fromStateIdx][toStateIdx];
+                }
+
+                if (edge.mTime == 0) {
+                    graph->mZeroTimeEdges.push_back(edge);
+                }
+                else {
+                    graph->mEdges.push_back(edge);
+                }
+            }
+        }
+
+        // Verification of the shortest paths against the switching costs, from all the completions in the debug builds
+        // (O(intervals^2 * edges)), otherwise from a sample of them.
+        int statesCount = graph->mStatesCount;
+        vector<long long> stateCosts((maxIntervalIdx - minIntervalIdx + 1) * statesCount);
+        vector<int> stateOrigins(stateCosts.size());
+        vector<int> verifiedCompletions;
+#ifdef DEBUG
+        for (int completion = minIntervalIdx; completion <= maxIntervalIdx; completion++) {
+            verifiedCompletions.push_back(completion);
+        }
+#else
+        int completionsCount = maxIntervalIdx - minIntervalIdx + 1;
+        for (int sampleIdx = 0; sampleIdx < VERIFIED_COMPLETIONS_COUNT; sampleIdx++) {
+            int completion = minIntervalIdx
+                    + (int)((long long)sampleIdx * (completionsCount - 1) / (VERIFIED_COMPLETIONS_COUNT - 1));
+            if (verifiedCompletions.empty() || verifiedCompletions.back() != completion) {
+                verifiedCompletions.push_back(completion);
+            }
+        }
+#endif
+        for (int completion : verifiedCompletions) {
+            fill(stateCosts.begin(), stateCosts.end(), NO_COST);
+            stateCosts[(completion - minIntervalIdx) * statesCount + graph->mOnStateIdx] = 0;
+            for (int intervalIdx = completion; intervalIdx <= maxIntervalIdx; intervalIdx++) {
+                long long *intervalStateCosts = stateCosts.data() + (intervalIdx - minIntervalIdx) * statesCount;
+                graph->relaxZeroTimeEdges(intervalStateCosts, stateOrigins.data());
+
+                long long switchingCost = intervalStateCosts[graph->mOnStateIdx];
+                if (optSwitchingCosts[completion][intervalIdx] != Instance::NO_VALUE
+                    && optSwitchingCosts[completion][intervalIdx] != switchingCost) {
+                    return nullptr;
+                }
+
+                for (auto &edge : graph->mEdges) {
+                    int toIntervalIdx = intervalIdx + edge.mTime;
+                    if (toIntervalIdx > maxIntervalIdx || intervalStateCosts[edge.mFromStateIdx] == NO_COST) {
+                        continue;
+                    }
+
+                    long long &toStateCost =
+                            stateCosts[(toIntervalIdx - minIntervalIdx) * statesCount + edge.mToStateIdx];
+                    toStateCost = min(
+                            toStateCost,
+                            intervalStateCosts[edge.mFromStateIdx] + graph->getEdgeCost(edge, intervalIdx));
+                }
+            }
+        }
+
+        graph->mMinCompletions = vector<int>(numIntervals + 1, Instance::NO_VALUE);
+        graph->mMaxStarts = vector<int>(numIntervals + 1, Instance::NO_VALUE);
+        for (int start = minIntervalIdx; start <= maxIntervalIdx; start++) {
+            int minCompletion = start;
+            while (minCompletion >= minIntervalIdx && optSwitchingCosts[minCompletion][start] != Instance::NO_VALUE) {
+                minCompletion--;
+            }
+            minCompletion++;
+
+            for (int completion = minIntervalIdx; completion < minCompletion; completion++) {
+                if (optSwitchingCosts[completion][start] != Instance::NO_VALUE) {
+                    return nullptr;
+                }
+            }
+
+            if (start > minIntervalIdx && minCompletion < graph->mMinCompletions[start - 1]) {
+                return nullptr;
+            }
+
+            graph->mMinCompletions[start] = minCompletion;
+        }
+
+        int maxStart = minIntervalIdx - 1;
+        for (int completion = minIntervalIdx; completion <= maxIntervalIdx; completion++) {
+            while (maxStart < maxIntervalIdx && graph->mMinCompletions[maxStart + 1] <= completion) {
+                maxStart++;
+            }
+
+            graph->mMaxStarts[completion] = maxStart;
+        }
+
+        return graph;
+    }
+
+    void SwitchingCostsGraph::relaxZeroTimeEdges(long long *stateCosts, int *stateOrigins) const {
+        for (int iteration = 1; iteration < mStatesCount; iteration++) {
+            for (auto &edge : mZeroTimeEdges) {
+                if (stateCosts[edge.mFromStateIdx] < stateCosts[edge.mToStateIdx]) {
+                    stateCosts[edge.mToStateIdx] = stateCosts[edge.mFromStateIdx];
+                    stateOrigins[edge.mToStateIdx] = stateOrigins[edge.mFromStateIdx];
+                }
+            }
+        }
+    }
+
+    void SwitchingCostsGraph::relaxZeroTimeEdgesBackward(long long *stateCosts, int *stateOrigins) const {
+        for (int iteration = 1; iteration < mStatesCount; iteration++) {
+            for (auto &edge : mZeroTimeEdges) {
+                if (stateCosts[edge.mToStateIdx] < stateCosts[edge.mFromStateIdx]) {
+                    stateCosts[edge.mFromStateIdx] = stateCosts[edge.mToStateIdx];
+                    stateOrigins[edge.mFromStateIdx] = stateOrigins[edge.mToStateIdx];
+                }
+            }
+        }
+    }
+}
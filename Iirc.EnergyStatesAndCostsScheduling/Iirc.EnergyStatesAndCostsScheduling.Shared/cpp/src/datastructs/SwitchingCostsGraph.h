@@ -0,0 +1,83 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#ifndef ENERGYSTATESANDCOSTSSCHEDULING_SWITCHINGCOSTSGRAPH_H
+#define ENERGYSTATESANDCOSTSSCHEDULING_SWITCHINGCOSTSGRAPH_H
+
+#include <memory>
+#include <vector>
+#include "../input/StateDiagram.h"
+
+using namespace std;
+
+namespace escs {
+    // The optimal switching costs as the shortest paths in the graph of (interval, state) nodes, from the on state at
+    // a completion (the first interval after a block) to the on state at a start (the first interval of the next
+    // block). The cost of each edge is a prefix-sum difference of the interval energy costs times its power, so the
+    // min over all completions of (cost + switching cost) can be computed by one pass over the intervals in
+    // O(intervals * edges) instead of O(intervals^2).
+    //
+    // The graph is created only if its shortest paths reproduce the given switching costs exactly for the completions
+    // and starts in [earliestOnIntervalIdx + 1, latestOnIntervalIdx] (all the completions in the debug builds, a sample
+    // of them otherwise), and if the completions having a switching cost to a start form a contiguous window ending at
+    // the start (with non-decreasing window begins).
+    class SwitchingCostsGraph {
+    public:
+        const static long long NO_COST;
+
+        struct Edge {
+            int mFromStateIdx;
+            int mToStateIdx;
+            int mTime;
+            long long mPowerConsumption; // Multiplied by the interval length.
+        };
+
+    private:
+        int mStatesCount;
+        int mOnStateIdx;
+        vector<Edge> mEdges; // Including remaining in the state for one interval.
+        vector<Edge> mZeroTimeEdges;
+        vector<long long> mPrefixEnergyCost;
+        vector<int> mMinCompletions; // The smallest completion having a switching cost to the start.
+        vector<int> mMaxStarts; // The largest start having a switching cost from the completion.
+
+    public:
+        static shared_ptr<const SwitchingCostsGraph> create(
+                const StateDiagram &stateDiagram,
+                int lengthInterval,
+                int earliestOnIntervalIdx,
+                int latestOnIntervalIdx,
+                const vector<vector<int>> &optSwitchingCosts,
+                const vector<vector<int>> &cumulEnergyCost);
+
+        void relaxZeroTimeEdges(long long *stateCosts, int *stateOrigins) const;
+        void relaxZeroTimeEdgesBackward(long long *stateCosts, int *stateOrigins) const;
+
+        long long getEdgeCost(const Edge &edge, int intervalIdx) const {
+            return edge.mPowerConsumption
+                   * (mPrefixEnergyCost[intervalIdx + edge.mTime] - mPrefixEnergyCost[intervalIdx]);
+        }
+
+        const vector<Edge> &getEdges() const {
+            return mEdges;
+        }
+
+        int getStatesCount() const {
+            return mStatesCount;
+        }
+
+        int getOnStateIdx() const {
+            return mOnStateIdx;
+        }
+
+        int getMinCompletion(int start) const {
+            return mMinCompletions[start];
+        }
+
+        int getMaxStart(int completion) const {
+            return mMaxStarts[completion];
+        }
+    };
+}
+
+#endif //ENERGYSTATESANDCOSTSSCHEDULING_SWITCHINGCOSTSGRAPH_H
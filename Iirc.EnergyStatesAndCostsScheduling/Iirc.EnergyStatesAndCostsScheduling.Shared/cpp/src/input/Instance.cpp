@@ -17,7 +17,8 @@ namespace escs {
             int latestOnIntervalIdx,
             const vector<vector<int>> optimalSwitchingCosts,
             const vector<vector<int>> fullOptimalSwitchingCosts,
-            const vector<vector<int>> cumulativeEnergyCost)
+            const vector<vector<int>> cumulativeEnergyCost,
+            const optional<StateDiagram> stateDiagram)
             : mMachinesCount(machinesCount),
             mJobs(jobs),
             mIntervals(intervals),
@@ -27,12 +28,53 @@ namespace escs {
             mLatestOnIntervalIdx(latestOnIntervalIdx),
             mOptimalSwitchingCosts(optimalSwitchingCosts),
             mFullOptimalSwitchingCosts(fullOptimalSwitchingCosts),
-            mCumulativeEnergyCost(cumulativeEnergyCost)
+            mCumulativeEnergyCost(cumulativeEnergyCost),
+            mStateDiagram(stateDiagram)
     {
         mTotalProcTime = 0;
         for (auto pJob : mJobs) {
             mTotalProcTime += pJob->mProcessingTime;
         }
+
+        if (mStateDiagram.has_value()) {
+            mOptimalSwitchingCostsGraph = SwitchingCostsGraph::create(
+                    mStateDiagram.value(),
+                    mLengthInterval,
+                    mEarliestOnIntervalIdx,
+                    mLatestOnIntervalIdx,
+                    mOptimalSwitchingCosts,
+                    mCumulativeEnergyCost);
+            // Usually the same switching costs, the graph is then created (and verified) once.
+            mFullOptimalSwitchingCostsGraph = mFullOptimalSwitchingCosts == mOptimalSwitchingCosts
+                    ? mOptimalSwitchingCostsGraph
+                    : SwitchingCostsGraph::create(
+                            mStateDiagram.value(),
+                            mLengthInterval,
+                            mEarliestOnIntervalIdx,
+                            mLatestOnIntervalIdx,
+                            mFullOptimalSwitchingCosts,
+                            mCumulativeEnergyCost);
+        }
+
+        mOptimalSwitchingCostsMonge = MongeSwitchingCosts::create(
+                mOptimalSwitchingCosts,
+                mEarliestOnIntervalIdx,
+                mLatestOnIntervalIdx);
+        mFullOptimalSwitchingCostsMonge = MongeSwitchingCosts::create(
+                mFullOptimalSwitchingCosts,
+                mEarliestOnIntervalIdx,
+                mLatestOnIntervalIdx);
+
+        auto cumulOnEnergyCostPerProcTime = InstanceCostTables::createCumulOnEnergyCostPerProcTime(
+                mCumulativeEnergyCost,
+                mOnPowerConsumption,
+                mTotalProcTime);
+        mOptimalSwitchingCostsTables = make_shared<const InstanceCostTables>(
+                mOptimalSwitchingCosts,
+                cumulOnEnergyCostPerProcTime);
+        mFullOptimalSwitchingCostsTables = make_shared<const InstanceCostTables>(
+                mFullOptimalSwitchingCosts,
+                cumulOnEnergyCostPerProcTime);
     }
 
     Instance::~Instance() {
@@ -4,9 +4,15 @@
 #ifndef ENERGYSTATESANDCOSTSSCHEDULING_INSTANCE_H
 #define ENERGYSTATESANDCOSTSSCHEDULING_INSTANCE_H
 
+#include <memory>
+#include <optional>
 #include <vector>
 #include "Job.h"
 #include "Interval.h"
+#include "StateDiagram.h"
+#include "../datastructs/SwitchingCostsGraph.h"
+#include "../datastructs/MongeSwitchingCosts.h"
+#include "../datastructs/InstanceCostTables.h"
 
 using namespace std;
 
@@ -29,7 +35,19 @@ namespace escs {
         const vector<vector<int>> mOptimalSwitchingCosts;
         const vector<vector<int>> mFullOptimalSwitchingCosts;
         const vector<vector<int>> mCumulativeEnergyCost;
+        const optional<StateDiagram> mStateDiagram;
 
+        // Graphs of the switching costs, nullptr if not reproducing the switching costs (or no state diagram).
+        shared_ptr<const SwitchingCostsGraph> mOptimalSwitchingCostsGraph;
+        shared_ptr<const SwitchingCostsGraph> mFullOptimalSwitchingCostsGraph;
+
+        // Windows of the switching costs, nullptr if the switching costs are not Monge.
+        shared_ptr<const MongeSwitchingCosts> mOptimalSwitchingCostsMonge;
+        shared_ptr<const MongeSwitchingCosts> mFullOptimalSwitchingCostsMonge;
+
+        // Cost tables shared by all the cost computations of the instance (up to the total proc time).
+        shared_ptr<const InstanceCostTables> mOptimalSwitchingCostsTables;
+        shared_ptr<const InstanceCostTables> mFullOptimalSwitchingCostsTables;
 
         Instance(
                 int machinesCount,
@@ -41,7 +59,8 @@ namespace escs {
                 int latestOnIntervalIdx,
                 const vector<vector<int>> optimalSwitchingCosts,
                 const vector<vector<int>> fullOptimalSwitchingCosts,
-                const vector<vector<int>> cumulativeEnergyCost);
+                const vector<vector<int>> cumulativeEnergyCost,
+                const optional<StateDiagram> stateDiagram);
 
         int getTotalProcTime() const {
             return mTotalProcTime;
@@ -0,0 +1,18 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include "StateDiagram.h"
+
+namespace escs {
+    StateDiagram::StateDiagram(
+            int onStateIdx,
+            int idleStateIdx,
+            const vector<int> &statesPowerConsumption,
+            const vector<vector<int>> &transitionTimes,
+            const vector<vector<int>> &transitionPowerConsumptions)
+        : mOnStateIdx(onStateIdx),
+          mIdleStateIdx(idleStateIdx),
+          mStatesPowerConsumption(statesPowerConsumption),
+          mTransitionTimes(transitionTimes),
+          mTransitionPowerConsumptions(transitionPowerConsumptions) {}
+}
@@ -0,0 +1,33 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#ifndef ENERGYSTATESANDCOSTSSCHEDULING_STATEDIAGRAM_H
+#define ENERGYSTATESANDCOSTSSCHEDULING_STATEDIAGRAM_H
+
+#include <vector>
+
+using namespace std;
+
+namespace escs {
+    class StateDiagram {
+    public:
+        const int mOnStateIdx;
+        const int mIdleStateIdx;
+        const vector<int> mStatesPowerConsumption;
+        const vector<vector<int>> mTransitionTimes; // Instance::NO_VALUE if the transition is forbidden.
+        const vector<vector<int>> mTransitionPowerConsumptions; // Instance::NO_VALUE if the transition is forbidden.
+
+        StateDiagram(
+                int onStateIdx,
+                int idleStateIdx,
+                const vector<int> &statesPowerConsumption,
+                const vector<vector<int>> &transitionTimes,
+                const vector<vector<int>> &transitionPowerConsumptions);
+
+        int getStatesCount() const {
+            return mStatesPowerConsumption.size();
+        }
+    };
+}
+
+#endif //ENERGYSTATESANDCOSTSSCHEDULING_STATEDIAGRAM_H
@@ -103,6 +103,41 @@ namespace escs {
             }
         }
 
+        // The state diagram is optional (older instance files do not contain it).
+        optional<StateDiagram> stateDiagram;
+        int statesCount;
+        if (stream >> statesCount) {
+            int onStateIdx, idleStateIdx;
+            stream >> onStateIdx;
+            stream >> idleStateIdx;
+
+            vector<int> statesPowerConsumption(statesCount, 0);
+            for (int state = 0; state < statesCount; state++) {
+                stream >> statesPowerConsumption[state];
+            }
+
+            vector<vector<int>> transitionTimes(statesCount, vector<int>(statesCount, Instance::NO_VALUE));
+            vector<vector<int>> transitionPowerConsumptions(statesCount, vector<int>(statesCount, Instance::NO_VALUE));
+            for (auto *pTransitionValues : { &transitionTimes, &transitionPowerConsumptions }) {
+                for (int fromState = 0; fromState < statesCount; fromState++) {
+                    for (int toState = 0; toState < statesCount; toState++) {
+                        int value;
+                        stream >> value;
+                        if (value >= 0) {
+                            (*pTransitionValues)[fromState][toState] = value;
+                        }
+                    }
+                }
+            }
+
+            stateDiagram.emplace(
+                    onStateIdx,
+                    idleStateIdx,
+                    statesPowerConsumption,
+                    transitionTimes,
+                    transitionPowerConsumptions);
+        }
+
         return Instance(
                 machinesCount,
                 jobs,
@@ -113,6 +148,7 @@ namespace escs {
                 latestOnIntervalIdx,
                 optimalSwitchingCosts,
                 fullOptimalSwitchingCosts,
-                cumulativeEnergyCost);
+                cumulativeEnergyCost,
+                stateDiagram);
     }
 }
@@ -14,7 +14,12 @@
 #include <limits>
 #include <algorithm>
 #include <functional>
+#include <iterator>
 #include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
 #include <atomic>
 #include "../utils/Stopwatch.h"
 
@@ -264,7 +269,168 @@ public:
 
 };
 
-std::mutex mtx_rand;
+/****************************************************
+* Persistent pool of worker threads. The tasks of a run
+* are divided into contiguous chunks, one per worker; a
+* worker takes its tasks from the front of its queue and,
+* when the queue is empty, steals from the back of the
+* queues of the other workers. Each worker thread calls
+* init_worker(worker) once before its first task.
+****************************************************/
+class WorkStealingPool
+{
+protected:
+	struct WorkerQueue
+	{
+		std::mutex mtx;
+		std::deque<int> tasks;
+	};
+
+	vector<std::thread> workers;
+	vector<unique_ptr<WorkerQueue>> queues;
+	std::mutex mtx_run;
+	std::condition_variable cv_start;
+	std::condition_variable cv_done;
+	const function<void(int,int)> *p_task;
+	long run_id;
+	int remaining_tasks;
+	bool stop;
+	std::exception_ptr task_exception;
+
+	bool take_task(int worker,int &task_index)
+	{
+		int N_workers=int(queues.size());
+		for(int i=0;i<N_workers;i++)
+		{
+			WorkerQueue &queue=*queues[(worker+i)%N_workers];
+			std::lock_guard<std::mutex> lock(queue.mtx);
+			if(!queue.tasks.empty())
+			{
+				if(i==0)
+				{
+					task_index=queue.tasks.front();
+					queue.tasks.pop_front();
+				}
+				else
+				{
+					task_index=queue.tasks.back();
+					queue.tasks.pop_back();
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void work(int worker,function<void(int)> init_worker)
+	{
+		if(init_worker!=nullptr)
+			init_worker(worker);
+
+		long seen_run_id=0;
+		while(true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mtx_run);
+				cv_start.wait(lock,[&](){return stop || run_id!=seen_run_id;});
+				if(stop)
+					return ;
+				seen_run_id=run_id;
+			}
+
+			int task_index;
+			while(take_task(worker,task_index))
+			{
+				// the queues are filled only after the task of the run is set (a late worker may take the tasks of
+				// the next run)
+				const function<void(int,int)> *p_run_task;
+				{
+					std::lock_guard<std::mutex> lock(mtx_run);
+					p_run_task=p_task;
+				}
+
+				try
+				{
+					(*p_run_task)(task_index,worker);
+				}
+				catch(...)
+				{
+					std::lock_guard<std::mutex> lock(mtx_run);
+					if(!task_exception)
+						task_exception=std::current_exception();
+				}
+
+				std::lock_guard<std::mutex> lock(mtx_run);
+				remaining_tasks--;
+				if(remaining_tasks==0)
+					cv_done.notify_all();
+			}
+		}
+	}
+
+public:
+
+	explicit WorkStealingPool(int N_workers,const function<void(int)> &init_worker=nullptr) :
+		p_task(nullptr),
+		run_id(0),
+		remaining_tasks(0),
+		stop(false)
+	{
+		for(int i=0;i<N_workers;i++)
+			queues.push_back(unique_ptr<WorkerQueue>(new WorkerQueue()));
+		for(int i=0;i<N_workers;i++)
+			workers.push_back(std::thread(&WorkStealingPool::work,this,i,init_worker));
+	}
+
+	~WorkStealingPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mtx_run);
+			stop=true;
+		}
+		cv_start.notify_all();
+		for(std::thread& th : workers)
+			th.join();
+	}
+
+	int get_workers_count() const
+	{
+		return int(workers.size());
+	}
+
+	/****************************************************
+	* Run task(task_index,worker) for all the task indices
+	* in [0,N_tasks) and wait until all of them finish. The
+	* first exception thrown by a task is rethrown.
+	****************************************************/
+	void run(int N_tasks,const function<void(int,int)> &task)
+	{
+		if(N_tasks<=0)
+			return ;
+
+		std::unique_lock<std::mutex> lock(mtx_run);
+		p_task=&task;
+		remaining_tasks=N_tasks;
+		task_exception=nullptr;
+		int N_workers=int(queues.size());
+		for(int worker=0;worker<N_workers;worker++)
+		{
+			std::lock_guard<std::mutex> queue_lock(queues[worker]->mtx);
+			int index_from=int((long long)N_tasks*worker/N_workers);
+			int index_to=int((long long)N_tasks*(worker+1)/N_workers);
+			for(int task_index=index_from;task_index<index_to;task_index++)
+				queues[worker]->tasks.push_back(task_index);
+		}
+		run_id++;
+		cv_start.notify_all();
+		cv_done.wait(lock,[&](){return remaining_tasks==0;});
+		p_task=nullptr;
+		if(task_exception)
+			std::rethrow_exception(task_exception);
+	}
+};
+
+inline std::mutex mtx_rand; // inline, the header is included by several translation units
 
 template<typename GeneType,typename MiddleCostType>
 class Genetic
@@ -281,6 +447,9 @@ private:
 	unsigned int N_robj;
     escs::Stopwatch mStopwatch;
     optional<chrono::milliseconds> mTimeLimit;
+	unique_ptr<WorkStealingPool> worker_pool; // created per solve in the multi-threading mode
+	vector<std::mt19937_64> worker_rngs; // random generators of the workers, seeded per task
+	inline static thread_local std::mt19937_64 *p_task_rng=nullptr; // set while a worker runs a seeded task
 
 public:
 
@@ -311,6 +480,8 @@ public:
 	bool user_request_stop;
 	long idle_delay_us;
 	bool use_quick_sort = true;
+	int migration_interval; // generations between the calls of SO_migrate
+	int tournament_size; // the parent selection of the steady-state mode
 	vector<GeneType> user_initial_solutions;
 
 	function<void(thisGenerationType&)> calculate_IGA_total_fitness;
@@ -320,11 +491,24 @@ public:
 	function<void(GeneType&,const function<double(void)> &rnd01)> init_genes;
 	function<bool(const GeneType&,MiddleCostType&)> eval_solution;
 	function<bool(const GeneType&,MiddleCostType&,const thisGenerationType&)> eval_solution_IGA;
-	function<GeneType(const GeneType&,const function<double(void)> &rnd01,double shrink_scale)> mutate;
+	// optional, evaluates the generated solutions at once (sets the accepted ones) instead of one-by-one,
+	// must be thread-safe in the multi-threading mode (called on the slices of the batch concurrently)
+	function<void(const vector<GeneType>&,vector<MiddleCostType>&,vector<bool>&)> eval_solution_batch;
+	// takes the genes by value: the offspring is mutated right after the crossover, its storage is reused
+	function<GeneType(GeneType,const function<double(void)> &rnd01,double shrink_scale)> mutate;
 	function<GeneType(const GeneType&,const GeneType&,const function<double(void)> &rnd01)> crossover;
 	function<void(int,const thisGenerationType&,const GeneType&)> SO_report_generation;
 	function<void(int,const thisGenerationType&,const vector<unsigned int>&)> MO_report_generation;
+	// optional, single-objective only: exchanges the chromosomes of the last generation with the other
+	// populations (e.g., its best ones for the immigrants replacing its worst ones), then it is ranked again
+	function<void(int,thisGenerationType&)> SO_migrate;
 	function<void(void)> custom_refresh;
+	// optional, called once on each thread of the worker pool before its first task (concurrently), e.g., to set
+	// the per-thread state of the evaluations
+	function<void(int)> init_worker;
+	// optional, takes over the genes of the dropped chromosomes (the rejected offspring, the ones not selected, the
+	// replaced ones), e.g., to reuse their storage for the next offspring, must be thread-safe
+	function<void(GeneType&&)> recycle_genes;
 	function<double(int,const function<double(void)> &rnd01)> get_shrink_scale;
 	vector<thisGenSOAbs> generations_so_abs;
 	thisGenerationType last_generation;
@@ -353,6 +537,8 @@ public:
 		N_threads(std::thread::hardware_concurrency()),
 		user_request_stop(false),
 		idle_delay_us(1000),
+		migration_interval(0),
+		tournament_size(2),
 		calculate_IGA_total_fitness(nullptr),
 		calculate_SO_total_fitness(nullptr),
 		calculate_MO_objectives(nullptr),
@@ -360,11 +546,15 @@ public:
 		init_genes(nullptr),
 		eval_solution(nullptr),
 		eval_solution_IGA(nullptr),
+		eval_solution_batch(nullptr),
 		mutate(nullptr),
 		crossover(nullptr),
 		SO_report_generation(nullptr),
 		MO_report_generation(nullptr),
+		SO_migrate(nullptr),
 		custom_refresh(nullptr),
+		init_worker(nullptr),
+		recycle_genes(nullptr),
 		get_shrink_scale(default_shrink_scale)
 	{
 		// initialize the random number generator with time-dependent seed
@@ -458,7 +648,7 @@ public:
 			report_generation(generation0);
 		}
 
-		last_generation=generation0;
+		last_generation=std::move(generation0);
 	}
 
 	StopReason solve_next_generation()
@@ -467,14 +657,18 @@ public:
 		timer.tic();
 		generation_step++;
 		thisGenerationType new_generation;
-		transfer(new_generation);
+		if(is_interactive())
+			transfer(new_generation);
 		crossover_and_mutation(new_generation);
+		if(!is_interactive())
+			transfer(new_generation); // the parents of the offspring are read from last_generation until here
 
 		finalize_objectives(new_generation);
 		rank_population(new_generation);  // used for selection
 		thisGenerationType selected_generation;
 		select_population(new_generation,selected_generation);
-		new_generation=selected_generation;
+		recycle(new_generation);
+		new_generation=std::move(selected_generation);
 		rank_population(new_generation); // used for elite tranfre, crossover and mutation
 		finalize_generation(new_generation);
 		new_generation.exe_time=timer.toc();
@@ -484,7 +678,8 @@ public:
 			generations_so_abs.push_back(thisGenSOAbs(new_generation));
 			report_generation(new_generation);
 		}
-		last_generation=new_generation;
+		last_generation=std::move(new_generation);
+		migrate();
 
 		return stop_critera();
 	}
@@ -492,11 +687,80 @@ public:
 	StopReason solve()
 	{
 	    mStopwatch.start();
+		if(multi_threading && N_threads>1 && !is_interactive())
+		{
+			worker_pool.reset(new WorkStealingPool(N_threads,init_worker));
+			worker_rngs.assign(N_threads,std::mt19937_64());
+		}
 		StopReason stop=StopReason::Undefined;
 		solve_init();
 		while(stop==StopReason::Undefined)
 			stop=solve_next_generation();
 		show_stop_reason(stop);
+		worker_pool.reset();
+        mStopwatch.stop();
+		return stop;
+	}
+
+	/****************************************************
+	* Steady-state mode (single-objective only): after the
+	* initial generation, each worker repeatedly selects
+	* two parents by tournament, evaluates their offspring
+	* and replaces the worst chromosome if the offspring is
+	* better. There is no barrier between the generations,
+	* each slot of the population has its own lock. Every
+	* population evaluations (a generation equivalent), the
+	* population is reported (and migrated). The budget and
+	* the best stall are counted in the offspring of a
+	* generation of the generational mode; the average
+	* stall is not checked.
+	****************************************************/
+	StopReason solve_steady_state()
+	{
+		if(problem_mode!=GA_MODE::SOGA)
+			throw runtime_error("The steady-state mode supports only the single-objective mode.");
+
+		mStopwatch.start();
+		if(multi_threading && N_threads>1)
+		{
+			worker_pool.reset(new WorkStealingPool(N_threads,init_worker));
+			worker_rngs.assign(N_threads,std::mt19937_64());
+		}
+		solve_init();
+
+		SteadyState state;
+		int N=int(last_generation.chromosomes.size());
+		state.chromosomes=last_generation.chromosomes;
+		state.slot_mutexes.reset(new std::mutex[N]);
+		state.costs.reset(new std::atomic<double>[N]);
+		for(int i=0;i<N;i++)
+			state.costs[i].store(state.chromosomes[i].total_cost);
+		state.evaluations.store(0);
+		state.last_improvement.store(0);
+		state.best_cost.store(last_generation.best_total_cost);
+		state.stop.store(StopReason::Undefined);
+		state.report_timer.tic();
+
+		long long N_offspring=std::max(1LL,(long long)std::round(double(population)*crossover_fraction));
+		long long N_budget=(long long)generation_max*N_offspring;
+		long long N_stall=(long long)best_stall_max*N_offspring;
+		if(worker_pool==nullptr)
+			steady_state_work(state,N_budget,N_stall);
+		else
+		{
+			std::uint64_t action_seed=next_action_seed();
+			worker_pool->run(worker_pool->get_workers_count(),[&](int task_index,int worker)
+				{
+					run_seeded_task(worker,action_seed,task_index,[&]()
+						{
+							steady_state_work(state,N_budget,N_stall);
+						});
+				});
+		}
+
+		StopReason stop=state.stop.load();
+		show_stop_reason(stop);
+		worker_pool.reset();
         mStopwatch.stop();
 		return stop;
 	}
@@ -542,11 +806,29 @@ protected:
 
 	double random01()
 	{
+		if(p_task_rng!=nullptr)
+			return std::uniform_real_distribution<double>(0.0,1.0)(*p_task_rng);
 		std::lock_guard<std::mutex> lock(mtx_rand); // prevent data race between threads
 		return unif_dist(rng);
 	}
 
 
+	/****************************************************
+	* Exchange the chromosomes of the last generation by
+	* SO_migrate every migration_interval generations.
+	* The immigrants are evaluated already, only the
+	* generation is ranked again.
+	****************************************************/
+	void migrate()
+	{
+		if(SO_migrate==nullptr || user_request_stop || generation_step%migration_interval!=0)
+			return ;
+
+		SO_migrate(generation_step,last_generation);
+		rank_population(last_generation);
+		finalize_generation(last_generation);
+	}
+
 	void report_generation(const thisGenerationType &new_generation)
 	{
 		if(is_single_objective())
@@ -587,9 +869,11 @@ protected:
 			return ;
 
 		if(!is_interactive())
-		{ // add all members
-			for(thisChromosomeType c:last_generation.chromosomes)
-				new_generation.chromosomes.push_back(c);
+		{ // add all members, they are moved in front of the offspring (last_generation is replaced afterwards)
+			new_generation.chromosomes.insert(
+				new_generation.chromosomes.begin(),
+				std::make_move_iterator(last_generation.chromosomes.begin()),
+				std::make_move_iterator(last_generation.chromosomes.end()));
 		}
 		else
 		{
@@ -646,6 +930,8 @@ protected:
 				throw runtime_error("eval_solution_IGA is null in interactive mode!");
 			if(eval_solution!=nullptr)
 				throw runtime_error("eval_solution is not null in interactive mode (use eval_solution_IGA instead)!");
+			if(eval_solution_batch!=nullptr)
+				throw runtime_error("eval_solution_batch is not null in interactive mode!");
 		}
 		else
 		{
@@ -695,9 +981,13 @@ protected:
 				throw runtime_error("SO_report_generation is not adjusted while problem mode is single-objective");
 			if(MO_report_generation!=nullptr)
 				throw runtime_error("MO_report_generation is adjusted while problem mode is single-objective");
+			if(SO_migrate!=nullptr && migration_interval<1)
+				throw runtime_error("migration_interval is below 1 while SO_migrate is adjusted");
 		}
 		else
 		{
+			if(SO_migrate!=nullptr)
+				throw runtime_error("SO_migrate is adjusted while problem mode is multi-objective");
 			if(SO_report_generation!=nullptr)
 				throw runtime_error("SO_report_generation is adjusted while problem mode is multi-objective");
 			if(MO_report_generation==nullptr)
@@ -705,7 +995,8 @@ protected:
 		}
 	}
 
-	void select_population(const thisGenerationType &g,thisGenerationType &g2)
+	// in the single-objective mode, the selected chromosomes are moved out of g
+	void select_population(thisGenerationType &g,thisGenerationType &g2)
 	{
 		if(user_request_stop)
 			return ;
@@ -1020,20 +1311,24 @@ protected:
 
 	}
 
-	void select_population_SO(const thisGenerationType &g,thisGenerationType &g2)
+	void select_population_SO(thisGenerationType &g,thisGenerationType &g2)
 	{
 		if(generation_step<=0)
 		{
-			g2=g;
+			g2=std::move(g);
 			return ;
 		}
 
 		if(verbose)
 			cout<<"Transfered elites: ";
 		vector<int> blocked;
+		// a chromosome selected again is copied from its first selection
+		vector<int> selected_at(g.chromosomes.size(),-1);
+		g2.chromosomes.reserve(population);
 		for(int i=0;i<elite_count;i++)
 		{
-			g2.chromosomes.push_back(g.chromosomes[g.sorted_indices[i]]);
+			selected_at[g.sorted_indices[i]]=int(g2.chromosomes.size());
+			g2.chromosomes.push_back(std::move(g.chromosomes[g.sorted_indices[i]]));
 			blocked.push_back(g.sorted_indices[i]);
 			if(verbose)
 			{
@@ -1055,7 +1350,13 @@ protected:
 					if(blocked[k]==j)
 						allowed=false;
 			} while(!allowed);
-			g2.chromosomes.push_back(g.chromosomes[j]);
+			if(selected_at[j]>=0)
+				g2.chromosomes.push_back(g2.chromosomes[selected_at[j]]);
+			else
+			{
+				selected_at[j]=int(g2.chromosomes.size());
+				g2.chromosomes.push_back(std::move(g.chromosomes[j]));
+			}
 			blocked.push_back(g.sorted_indices[j]);
 		}
 		if(verbose)
@@ -1298,11 +1599,11 @@ protected:
 			{
 				if(index>=0)
 				{
-					generation0.chromosomes[index]=X;
+					generation0.chromosomes[index]=std::move(X);
 				}
 				else
 				{
-					generation0.chromosomes.push_back(X);
+					generation0.chromosomes.push_back(std::move(X));
 				}
 				return true;
 			}
@@ -1356,94 +1657,348 @@ protected:
 	}
 
 	/****************************************************
-	* Perform a given method action (population 
-	* initialization, or mutation/crossover) in a thread pool.
-	* The method is called by any available thread.
+	* Evaluate the batch by eval_solution_batch. In the
+	* multi-threading mode, the batch is divided into
+	* contiguous slices, one per worker of the pool.
 	****************************************************/
-	template <void (thisType::*action_function)(thisGenerationType *p_generation0,int index_from,int index_to,unsigned int *attemps,std::atomic<bool> &active_thread)>
-	void dynamic_thread_action(
+	void evaluate_batch(
+		vector<GeneType> &batch_genes,
+		vector<MiddleCostType> &batch_middle_costs,
+		vector<bool> &batch_accepted)
+	{
+		int N_slices=(worker_pool!=nullptr?std::min(worker_pool->get_workers_count(),int(batch_genes.size())):1);
+		if(N_slices<=1)
+		{
+			eval_solution_batch(batch_genes,batch_middle_costs,batch_accepted);
+			return ;
+		}
+
+		vector<vector<GeneType>> slice_genes(N_slices);
+		vector<vector<MiddleCostType>> slice_middle_costs(N_slices);
+		vector<vector<bool>> slice_accepted(N_slices);
+		for(int slice=0;slice<N_slices;slice++)
+		{
+			size_t index_from=batch_genes.size()*slice/N_slices;
+			size_t index_to=batch_genes.size()*(slice+1)/N_slices;
+			slice_genes[slice].assign(
+				std::make_move_iterator(batch_genes.begin()+index_from),
+				std::make_move_iterator(batch_genes.begin()+index_to));
+			slice_middle_costs[slice].assign(index_to-index_from,MiddleCostType());
+			slice_accepted[slice].assign(index_to-index_from,false);
+		}
+
+		worker_pool->run(N_slices,[&](int slice,int /*worker*/)
+			{
+				eval_solution_batch(slice_genes[slice],slice_middle_costs[slice],slice_accepted[slice]);
+			});
+
+		size_t index=0;
+		for(int slice=0;slice<N_slices;slice++)
+		{
+			for(size_t i=0;i<slice_genes[slice].size();i++,index++)
+			{
+				batch_genes[index]=std::move(slice_genes[slice][i]);
+				batch_middle_costs[index]=slice_middle_costs[slice][i];
+				batch_accepted[index]=slice_accepted[slice][i];
+			}
+		}
+	}
+
+	/****************************************************
+	* Generate the specified solutions and evaluate them
+	* by eval_solution_batch at once. The rejected ones
+	* are generated again (in the next batch).
+	****************************************************/
+	void batch_action(
 		thisGenerationType &generation,
-		unsigned int N_add, unsigned int &total_attempts)
+		unsigned int N_add, unsigned int &total_attempts,
+		const function<GeneType(void)> &generate_genes)
 	{
-		vector<atomic<bool>> active_threads(N_threads);
-		for (auto& at : active_threads)
-			std::atomic_init(&at, false);
+		vector<GeneType> batch_genes;
+		vector<MiddleCostType> batch_middle_costs;
+		vector<bool> batch_accepted;
+		unsigned int N_remaining=N_add;
+		while(N_remaining>0 && !user_request_stop)
+		{
+			batch_genes.clear();
+			for(unsigned int i=0;i<N_remaining;i++)
+				batch_genes.push_back(generate_genes());
+			batch_middle_costs.assign(batch_genes.size(),MiddleCostType());
+			batch_accepted.assign(batch_genes.size(),false);
+			evaluate_batch(batch_genes,batch_middle_costs,batch_accepted);
+			for(unsigned int i=0;i<batch_genes.size();i++)
+			{
+				if(batch_accepted[i])
+				{
+					thisChromosomeType X;
+					X.genes=std::move(batch_genes[i]);
+					X.middle_costs=batch_middle_costs[i];
+					generation.chromosomes.push_back(std::move(X));
+					N_remaining--;
+				}
+				else
+				{
+					recycle(std::move(batch_genes[i]));
+					total_attempts++;
+				}
+			}
+		}
+	}
 
-		vector<unsigned int> attempts;
-		attempts.assign(N_threads,0);
+	/****************************************************
+	* Draw the seed of the random streams of the tasks of
+	* a pool action from the main random generator.
+	****************************************************/
+	std::uint64_t next_action_seed()
+	{
+		std::lock_guard<std::mutex> lock(mtx_rand);
+		return rng();
+	}
 
-		// Initialize the thread pool
-		vector<std::thread> thread_pool;
-		thread_pool.reserve(N_threads);
-		for(int i=0;i<N_threads;i++)
+	/****************************************************
+	* State of the steady-state mode shared by the workers:
+	* the population whose chromosomes are replaced one at
+	* a time, and the counters of the stop criteria.
+	****************************************************/
+	struct SteadyState
+	{
+		vector<thisChromosomeType> chromosomes;
+		unique_ptr<std::mutex[]> slot_mutexes; // of the chromosomes
+		unique_ptr<std::atomic<double>[]> costs; // total costs of the chromosomes, read without the locks
+		std::atomic<long long> evaluations;
+		std::atomic<long long> last_improvement; // evaluations when the best cost improved last
+		std::atomic<double> best_cost;
+		std::atomic<StopReason> stop;
+		std::mutex mtx_report;
+		Chronometer report_timer;
+	};
+
+	int steady_state_tournament(const SteadyState &state)
+	{
+		int N=int(state.chromosomes.size());
+		int winner=-1;
+		for(int i=0;i<std::max(1,tournament_size);i++)
 		{
-			thread_pool.push_back(std::thread());
+			int candidate=std::min(N-1,int(random01()*N));
+			if(winner<0 || state.costs[candidate].load()<state.costs[winner].load())
+				winner=candidate;
 		}
-		for(std::thread& th : thread_pool)
+		return winner;
+	}
+
+	// copied into the given genes, reusing their storage
+	void steady_state_genes(SteadyState &state,int index,GeneType &genes)
+	{
+		std::lock_guard<std::mutex> lock(state.slot_mutexes[index]);
+		genes=state.chromosomes[index].genes;
+	}
+
+	// X is swapped with the replaced chromosome
+	bool steady_state_replace_worst(SteadyState &state,thisChromosomeType &X)
+	{
+		int N=int(state.chromosomes.size());
+		while(true)
 		{
-			if(th.joinable())
+			int worst=0;
+			double worst_cost=state.costs[0].load();
+			for(int i=1;i<N;i++)
 			{
-				th.join();
+				double cost=state.costs[i].load();
+				if(cost>worst_cost)
+				{
+					worst=i;
+					worst_cost=cost;
+				}
 			}
+			if(!(X.total_cost<worst_cost))
+				return false;
+
+			std::lock_guard<std::mutex> lock(state.slot_mutexes[worst]);
+			if(state.costs[worst].load()!=worst_cost)
+				continue; // replaced by another worker meanwhile
+			state.costs[worst].store(X.total_cost);
+			std::swap(state.chromosomes[worst],X);
+			return true;
 		}
+	}
 
-		unsigned int offset = (unsigned int)generation.chromosomes.size();
+	StopReason steady_state_stop_reason(const SteadyState &state,long long N_budget,long long N_stall)
+	{
+		long long evaluations=state.evaluations.load();
+		if(evaluations>=N_budget)
+			return StopReason::MaxGenerations;
+		if(evaluations-state.last_improvement.load()>=N_stall)
+			return StopReason::StallBest;
+		if(user_request_stop)
+			return StopReason::UserRequest;
+		if(mStopwatch.timeLimitReached(mTimeLimit))
+			return StopReason::TimeLimit;
+		return StopReason::Undefined;
+	}
 
-		// Pre-fill the new solutions
-		for(unsigned int i=0;i<N_add;i++)
+	void steady_state_report(SteadyState &state,int step)
+	{
+		std::lock_guard<std::mutex> lock(state.mtx_report);
+		int N=int(state.chromosomes.size());
+		thisGenerationType generation;
+		for(int i=0;i<N;i++)
 		{
-			generation.chromosomes.push_back(thisChromosomeType());
+			std::lock_guard<std::mutex> slot_lock(state.slot_mutexes[i]);
+			generation.chromosomes.push_back(state.chromosomes[i]);
+		}
+		rank_population(generation);
+		finalize_generation(generation);
+		generation.exe_time=state.report_timer.toc();
+		state.report_timer.tic();
+		generation_step=step;
+		if(!user_request_stop)
+		{
+			generations_so_abs.push_back(thisGenSOAbs(generation));
+			report_generation(generation);
 		}
 
-		unsigned int x_index=0;
-		while(x_index<N_add && !user_request_stop)
+		if(SO_migrate!=nullptr && !user_request_stop && step%migration_interval==0)
 		{
-			int free_thread=-1;
-			for(int i=0;i<N_threads && free_thread<0;i++)
-				if(!active_threads[i])
+			// the immigrants are the chromosomes changed by SO_migrate, they compete with the current population
+			vector<double> costs_before;
+			for(const thisChromosomeType &X:generation.chromosomes)
+				costs_before.push_back(X.total_cost);
+			SO_migrate(step,generation);
+			for(int i=0;i<N;i++)
+			{
+				if(generation.chromosomes[i].total_cost!=costs_before[i])
 				{
-					free_thread=i;
-					if(thread_pool[free_thread].joinable())
-					{
-						thread_pool[free_thread].join();
-					}
+					thisChromosomeType immigrant=generation.chromosomes[i];
+					steady_state_replace_worst(state,immigrant);
 				}
-			if(free_thread>-1)
+			}
+		}
+		last_generation=std::move(generation);
+	}
+
+	void steady_state_work(SteadyState &state,long long N_budget,long long N_stall)
+	{
+		int N=int(state.chromosomes.size());
+		GeneType parent1,parent2; // reused by the steps
+		vector<GeneType> batch_genes(1);
+		vector<MiddleCostType> batch_middle_costs(1);
+		vector<bool> batch_accepted(1);
+		while(state.stop.load()==StopReason::Undefined)
+		{
+			StopReason stop=steady_state_stop_reason(state,N_budget,N_stall);
+			if(stop!=StopReason::Undefined)
+			{
+				StopReason running=StopReason::Undefined;
+				state.stop.compare_exchange_strong(running,stop);
+				break;
+			}
+
+			int pidx_c1=steady_state_tournament(state);
+			int pidx_c2=steady_state_tournament(state);
+			while(N>1 && pidx_c1==pidx_c2)
+				pidx_c2=steady_state_tournament(state);
+			steady_state_genes(state,pidx_c1,parent1);
+			steady_state_genes(state,pidx_c2,parent2);
+			thisChromosomeType X;
+			X.genes=crossover(parent1,parent2,[this](){return random01();});
+			if(random01()<=mutation_rate)
 			{
-				active_threads[free_thread]=true;
-				thread_pool[free_thread]=
-					std::thread(
-						action_function,
-						this,
-						&generation,
-						offset + int(x_index), /* from */
-						offset + int(x_index), /* to */
-						&attempts[free_thread],
-						std::ref(active_threads[free_thread])
-							);
-				x_index++;
+				double shrink_scale=get_shrink_scale(int(state.evaluations.load()/N),[this](){return random01();});
+				X.genes=mutate(std::move(X.genes),[this](){return random01();},shrink_scale);
 			}
+
+			bool accepted;
+			if(eval_solution!=nullptr)
+				accepted=eval_solution(X.genes,X.middle_costs);
 			else
 			{
-				idle();
+				batch_genes[0]=std::move(X.genes);
+				batch_accepted[0]=false;
+				eval_solution_batch(batch_genes,batch_middle_costs,batch_accepted);
+				X.genes=std::move(batch_genes[0]);
+				X.middle_costs=batch_middle_costs[0];
+				accepted=batch_accepted[0];
+			}
+			if(!accepted)
+			{
+				recycle(std::move(X.genes));
+				continue;
+			}
+			double total_cost=calculate_SO_total_fitness(X);
+			X.total_cost=total_cost;
+
+			// X holds the replaced chromosome afterwards
+			bool replaced=steady_state_replace_worst(state,X);
+			recycle(std::move(X.genes));
+			long long evaluations=++state.evaluations;
+			if(replaced)
+			{
+				double best_cost=state.best_cost.load();
+				while(total_cost<best_cost && !state.best_cost.compare_exchange_weak(best_cost,total_cost))
+					;
+				if(total_cost<best_cost)
+					state.last_improvement.store(evaluations);
 			}
+			if(evaluations%N==0)
+				steady_state_report(state,int(evaluations/N));
 		}
+	}
 
-		bool all_tasks_finished;
-		do
+	/****************************************************
+	* Run the given task body on a worker of the pool with
+	* the random stream of the task: the stream depends
+	* only on the action seed and the task index (not on
+	* the worker that runs the task), hence the results are
+	* reproducible for a given seed.
+	****************************************************/
+	void run_seeded_task(
+		int worker,std::uint64_t action_seed,int task_index,
+		const function<void(void)> &task_body)
+	{
+		worker_rngs[worker].seed(action_seed+0x9E3779B97F4A7C15ULL*std::uint64_t(task_index+1));
+		p_task_rng=&worker_rngs[worker];
+		task_body();
+		p_task_rng=nullptr;
+	}
+
+	/****************************************************
+	* Perform a given method action (population 
+	* initialization, or mutation/crossover) in the worker
+	* pool. Each solution is a task taken by any available
+	* worker (or stolen from a busy one).
+	****************************************************/
+	template <void (thisType::*action_function)(thisGenerationType *p_generation0,int index_from,int index_to,unsigned int *attemps,std::atomic<bool> &active_thread)>
+	void dynamic_thread_action(
+		thisGenerationType &generation,
+		unsigned int N_add, unsigned int &total_attempts)
+	{
+		vector<unsigned int> attempts;
+		attempts.assign(worker_pool->get_workers_count(),0);
+
+		unsigned int offset = (unsigned int)generation.chromosomes.size();
+
+		// Pre-fill the new solutions
+		for(unsigned int i=0;i<N_add;i++)
 		{
-			all_tasks_finished=true;
-			for(int i=0;i<N_threads;i++)
-				if(active_threads[i])
-					all_tasks_finished=false;
-			if(!all_tasks_finished)
-				idle();
-		}while(!all_tasks_finished);
+			generation.chromosomes.push_back(thisChromosomeType());
+		}
 
-		// wait for tasks to finish
-		for(std::thread& th : thread_pool)
-			if(th.joinable())
-				th.join();
+		std::uint64_t action_seed=next_action_seed();
+		worker_pool->run(int(N_add),[&](int task_index,int worker)
+			{
+				if(user_request_stop)
+					return ;
+				run_seeded_task(worker,action_seed,task_index,[&]()
+					{
+						std::atomic<bool> active_thread(true);
+						(this->*action_function)(
+							&generation,
+							offset + task_index, /* from */
+							offset + task_index, /* to */
+							&attempts[worker],
+							active_thread);
+					});
+			});
 
 		for(unsigned int ac:attempts)
 			total_attempts+=ac;
@@ -1452,40 +2007,28 @@ protected:
 
 	/****************************************************
 	* Perform a given method action (population 
-	* initialization, or mutation/crossover) in a thread
+	* initialization, or mutation/crossover) in the worker
 	* pool. The task is equally divided between threads.
-	* This approach has far less thread numbers and hence
-	* less far thread overhhead. However, as the thread
-	* allocation is not dynamic, the whole process waits 
-	* for the worst-case-scenario thread. 
+	* This approach has far less tasks and hence less task
+	* overhead. However, as the chunks are not divided
+	* further, the whole process waits for the
+	* worst-case-scenario chunk.
 	****************************************************/
 	template <void (thisType::*action_function)(thisGenerationType *p_generation0,int index_from,int index_to,unsigned int *attemps,std::atomic<bool> &active_thread)>
 	void static_thread_action(
 		thisGenerationType &generation,
 		unsigned int N_add, unsigned int &total_attempts)
 	{
-		vector<atomic<bool>> active_threads(N_threads);
-		for (auto& at : active_threads)
-			std::atomic_init(&at, false);
-
 		vector<unsigned int> attempts;
-		attempts.assign(N_threads,0);
-
-		// Initialize the thread pool
-		vector<std::thread> thread_pool;
-		thread_pool.reserve(N_threads);
-		for(int i=0;i<N_threads;i++)
-			thread_pool.push_back(std::thread());
-		for(std::thread& th : thread_pool)
-			if(th.joinable())
-				th.join();
+		attempts.assign(worker_pool->get_workers_count(),0);
 
 		unsigned int offset = (unsigned int)generation.chromosomes.size();
 		// Pre-fill the new solutions
 		for(unsigned int i=0;i<N_add;i++)
 			generation.chromosomes.push_back(thisChromosomeType());
 
-		// Use determined thread pools
+		// Determine the chunks
+		vector<std::pair<int,int>> chunks;
 		int x_index_start=offset;
 		int x_index_end=0;
 		int pop_chunk=std::max(int(N_add/N_threads),1);
@@ -1497,37 +2040,24 @@ protected:
 				x_index_end=std::min(x_index_start+pop_chunk-1,int(generation.chromosomes.size())-1);
 
 			if(x_index_end>=x_index_start)
-			{
-				active_threads[i]=true;
-				thread_pool[i]=
-				std::thread(
-					action_function,
-					this,
-					&generation,
-					x_index_start,
-					x_index_end,
-					&attempts[i],
-					std::ref(active_threads[i])
-						);
-			}
+				chunks.push_back(std::make_pair(x_index_start,x_index_end));
 			x_index_start=x_index_end+1;
 		}
 
-		bool all_tasks_finished;
-		do
-		{
-			all_tasks_finished=true;
-			for(int i=0;i<N_threads;i++)
-				if(active_threads[i])
-					all_tasks_finished=false;
-			if(!all_tasks_finished)
-				idle();
-		}while(!all_tasks_finished);
-
-		// wait for tasks to finish
-		for(std::thread& th : thread_pool)
-			if(th.joinable())
-				th.join();
+		std::uint64_t action_seed=next_action_seed();
+		worker_pool->run(int(chunks.size()),[&](int task_index,int worker)
+			{
+				run_seeded_task(worker,action_seed,task_index,[&]()
+					{
+						std::atomic<bool> active_thread(true);
+						(this->*action_function)(
+							&generation,
+							chunks[task_index].first,
+							chunks[task_index].second,
+							&attempts[worker],
+							active_thread);
+					});
+			});
 
 		for(unsigned int ac:attempts)
 			total_attempts+=ac;
@@ -1541,22 +2071,32 @@ protected:
 		generation0.chromosomes.clear();
 		generation0.chromosomes.reserve(population); // push_back can invalidate the vector
 
-		unsigned int new_solutions_offset = (unsigned int) generation0.chromosomes.size();
-		unsigned int N_add=(unsigned int) std::max(0, int(population)-int(new_solutions_offset));
-
 		// Evaluate and add the user defined population
 		for(const GeneType &solution:user_initial_solutions)
 		{
+			if(generation0.chromosomes.size()>=population)
+				break;
 			thisChromosomeType X;
 			X.genes=solution;
 			bool accepted=init_population_try(generation0,X,-1);
 			(void) accepted; // unused parametre
-			if(generation0.chromosomes.size()>=population)
-				break;
 		}
 
+		// the rest is generated (the accepted user solutions count towards the population)
+		unsigned int new_solutions_offset = (unsigned int) generation0.chromosomes.size();
+		unsigned int N_add=(unsigned int) std::max(0, int(population)-int(new_solutions_offset));
+
 		unsigned int total_attempts=0;
-		if(!multi_threading || N_threads==1 || is_interactive())
+		if(eval_solution_batch!=nullptr)
+		{
+			batch_action(generation0,N_add,total_attempts,[this]()
+				{
+					GeneType genes;
+					init_genes(genes,[this](){return random01();});
+					return genes;
+				});
+		}
+		else if(worker_pool==nullptr)
 		{
 			sequential_action<&thisType::init_population_range>(
 				generation0,N_add,total_attempts);
@@ -1595,6 +2135,44 @@ protected:
 		return position;
 	}
 
+	void recycle(GeneType &&genes)
+	{
+		if(recycle_genes!=nullptr)
+			recycle_genes(std::move(genes));
+	}
+
+	// the genes of the chromosomes left in g (e.g., not moved out by the selection)
+	void recycle(thisGenerationType &g)
+	{
+		for(thisChromosomeType &X:g.chromosomes)
+			recycle(std::move(X.genes));
+	}
+
+	GeneType generate_offspring()
+	{
+		int pidx_c1=select_parent(last_generation);
+		int pidx_c2=select_parent(last_generation);
+		while(pidx_c1==pidx_c2)
+		{
+			pidx_c1=select_parent(last_generation);
+			pidx_c2=select_parent(last_generation);
+		}
+		if(verbose)
+			cout<<"Crossover of chromosomes "<<pidx_c1<<","<<pidx_c2<<endl;
+		GeneType genes=crossover(
+			last_generation.chromosomes[pidx_c1].genes,
+			last_generation.chromosomes[pidx_c2].genes,
+			[this](){return random01();});
+		if(random01()<=mutation_rate)
+		{
+			if(verbose)
+				cout<<"Mutation of chromosome "<<endl;
+			double shrink_scale=get_shrink_scale(generation_step,[this](){return random01();});
+			genes=mutate(std::move(genes),[this](){return random01();},shrink_scale);
+		}
+		return genes;
+	}
+
 	void crossover_and_mutation_range(
 		thisGenerationType *p_new_generation,
 		int x_index_begin,
@@ -1611,23 +2189,7 @@ protected:
 			while(!successful)
 			{
 				thisChromosomeType X;
-
-				int pidx_c1=select_parent(last_generation);
-				int pidx_c2=select_parent(last_generation);
-				if(pidx_c1==pidx_c2)
-					continue ;
-				if(verbose)
-					cout<<"Crossover of chromosomes "<<pidx_c1<<","<<pidx_c2<<endl;
-				GeneType Xp1=last_generation.chromosomes[pidx_c1].genes;
-				GeneType Xp2=last_generation.chromosomes[pidx_c2].genes;
-				X.genes=crossover(Xp1,Xp2,[this](){return random01();});
-				if(random01()<=mutation_rate)
-				{
-					if(verbose)
-						cout<<"Mutation of chromosome "<<endl;
-					double shrink_scale=get_shrink_scale(generation_step,[this](){return random01();});
-					X.genes=mutate(X.genes,[this](){return random01();},shrink_scale);
-				}
+				X.genes=generate_offspring();
 				if(is_interactive())
 				{
 					if(eval_solution_IGA(X.genes,X.middle_costs,*p_new_generation))
@@ -1643,13 +2205,16 @@ protected:
 					if(eval_solution(X.genes,X.middle_costs))
 					{
 						if(index>=0)
-							p_new_generation->chromosomes[index]=X;
+							p_new_generation->chromosomes[index]=std::move(X);
 						else
-							p_new_generation->chromosomes.push_back(X);
+							p_new_generation->chromosomes.push_back(std::move(X));
 						successful=true;
 					}
 					else
+					{
+						recycle(std::move(X.genes));
 						(*attemps)++;
+					}
 				}
 			}
 		}
@@ -1677,7 +2242,11 @@ protected:
 				throw runtime_error("In IGA mode, elite fraction + crossover fraction must be equal to 1.0 !");
 		}
 
-		if(!multi_threading || N_threads==1 || is_interactive())
+		if(eval_solution_batch!=nullptr)
+		{
+			batch_action(new_generation,N_add,total_attempts,[this](){return generate_offspring();});
+		}
+		else if(worker_pool==nullptr)
 		{
 			sequential_action<&thisType::crossover_and_mutation_range>(
 				new_generation,N_add,total_attempts);
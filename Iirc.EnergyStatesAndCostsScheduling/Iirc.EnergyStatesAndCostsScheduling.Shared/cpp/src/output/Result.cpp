@@ -31,11 +31,37 @@ namespace escs {
                   mLowerBoundTotalDuration(lowerBoundTotalDuration),
                   mPrimalHeuristicBlockDetectionTotalDuration(primalHeuristicBlockDetectionTotalDuration),
                   mPrimalHeuristicPackToBlockByCpTotalDuration(primalHeuristicPackToBlockByCpTotalDuration),
-                  mPrimalHeuristicBlockFindingTotalDuration(primalHeuristicBlockFindingTotalDuration)
+                  mPrimalHeuristicBlockFindingTotalDuration(primalHeuristicBlockFindingTotalDuration),
+                  mMongeTransitionKernelUsed(),
+                  mCostCacheHitsCount(),
+                  mCostCacheMissesCount(),
+                  mGlobalLowerBound(),
+                  mDominatedNodesCount()
             {
 
             }
 
+    Result &Result::setMongeTransitionKernelUsed(optional<bool> mongeTransitionKernelUsed) {
+        mMongeTransitionKernelUsed = mongeTransitionKernelUsed;
+        return *this;
+    }
+
+    Result &Result::setCostCacheCounts(optional<long long> hitsCount, optional<long long> missesCount) {
+        mCostCacheHitsCount = hitsCount;
+        mCostCacheMissesCount = missesCount;
+        return *this;
+    }
+
+    Result &Result::setGlobalLowerBound(optional<int> globalLowerBound) {
+        mGlobalLowerBound = globalLowerBound;
+        return *this;
+    }
+
+    Result &Result::setDominatedNodesCount(optional<long long> dominatedNodesCount) {
+        mDominatedNodesCount = dominatedNodesCount;
+        return *this;
+    }
+
     void Result::writeToPath(string resultPath) {
         ofstream stream;
         stream.open(resultPath,  ofstream::out);
@@ -143,6 +169,41 @@ namespace escs {
         else {
             stream << -1 << endl;
         }
+
+        if (mMongeTransitionKernelUsed.has_value()) {
+            stream << mMongeTransitionKernelUsed.value() << endl;
+        }
+        else {
+            stream << -1 << endl;
+        }
+
+        if (mCostCacheHitsCount.has_value()) {
+            stream << mCostCacheHitsCount.value() << endl;
+        }
+        else {
+            stream << -1 << endl;
+        }
+
+        if (mCostCacheMissesCount.has_value()) {
+            stream << mCostCacheMissesCount.value() << endl;
+        }
+        else {
+            stream << -1 << endl;
+        }
+
+        if (mGlobalLowerBound.has_value()) {
+            stream << mGlobalLowerBound.value() << endl;
+        }
+        else {
+            stream << -1 << endl;
+        }
+
+        if (mDominatedNodesCount.has_value()) {
+            stream << mDominatedNodesCount.value() << endl;
+        }
+        else {
+            stream << -1 << endl;
+        }
     }
 }
 
@@ -29,6 +29,13 @@ namespace escs {
         const optional<chrono::milliseconds> mPrimalHeuristicPackToBlockByCpTotalDuration;
         const optional<chrono::milliseconds> mPrimalHeuristicBlockFindingTotalDuration;
 
+        // Statistics of the individual solvers, set only by the solvers reporting them.
+        optional<bool> mMongeTransitionKernelUsed;
+        optional<long long> mCostCacheHitsCount;
+        optional<long long> mCostCacheMissesCount;
+        optional<int> mGlobalLowerBound;
+        optional<long long> mDominatedNodesCount;
+
         Result(
                 Status status,
                 bool timeLimitReached,
@@ -44,6 +51,11 @@ namespace escs {
                 optional<chrono::milliseconds> primalHeuristicPackToBlockByCpTotalDuration = optional<chrono::milliseconds>(),
                 optional<chrono::milliseconds> primalHeuristicBlockFindingTotalDuration = optional<chrono::milliseconds>());
 
+        Result &setMongeTransitionKernelUsed(optional<bool> mongeTransitionKernelUsed);
+        Result &setCostCacheCounts(optional<long long> hitsCount, optional<long long> missesCount);
+        Result &setGlobalLowerBound(optional<int> globalLowerBound);
+        Result &setDominatedNodesCount(optional<long long> dominatedNodesCount);
+
         void writeToPath(string resultPath);
     };
 }
@@ -7,6 +7,7 @@
 #include <map>
 #include <omp.h>
 #include <random>
+#include <thread>
 #include "../input/readers/CppInputReader.h"
 #include "SolverConfig.h"
 #include "BranchAndBoundJob.h"
@@ -19,6 +20,8 @@
 using namespace std;
 using namespace escs;
 
+// Left out when the solver is linked into the tests.
+#ifndef NO_SOLVER_MAIN
 int main(int /*argc*/, char **argv) {
     cout << "In cpp" << endl;
 
@@ -50,7 +53,11 @@ int main(int /*argc*/, char **argv) {
                 specializedSolverConfig.mJobsJoiningOnGcd,
                 specializedSolverConfig.mBranchPriority,
                 specializedSolverConfig.mIterativeDeepeningTimeLimit,
-                optional<long long>());
+                optional<long long>(),
+                specializedSolverConfig.mSearchThreadsCount,
+                specializedSolverConfig.mNodeSelection,
+                specializedSolverConfig.mOpenNodesMemoryLimitMb,
+                specializedSolverConfig.mDominanceMemoCapacity);
 
         if (iterativeDeepeningSpecializedSolverConfig.mIterativeDeepeningTimeLimit.has_value()) {
             auto timeLimit = solverConfig.mTimeLimit;
@@ -97,6 +104,7 @@ int main(int /*argc*/, char **argv) {
 
     return 0;
 }
+#endif
 
 namespace escs {
     Result iterativeDeeping(
@@ -110,10 +118,10 @@ namespace escs {
                 instance.mIntervals.size(),
                 instance.mEarliestOnIntervalIdx,
                 instance.mLatestOnIntervalIdx,
-                instance.mOnPowerConsumption,
-                instance.mOptimalSwitchingCosts,
-                instance.mCumulativeEnergyCost,
-                solverConfig.mProcessableIntervals);
+                instance.mOptimalSwitchingCostsTables,
+                solverConfig.mProcessableIntervals,
+                instance.mOptimalSwitchingCostsGraph.get(),
+                solverConfig.mUseMongeTransitions ? instance.mOptimalSwitchingCostsMonge.get() : nullptr);
         if (specializedSolverConfig.mJobsJoiningOnGcd == BranchAndBoundOnJob::JobsJoiningOnGcd::ROOT
             || specializedSolverConfig.mJobsJoiningOnGcd == BranchAndBoundOnJob::JobsJoiningOnGcd::WHOLE_TREE) {
             vector<int> allProcTimes;
@@ -148,6 +156,9 @@ namespace escs {
         chrono::milliseconds totalPrimalHeuristicBLockDetectionDuration = chrono::milliseconds::zero();
         chrono::milliseconds totalPrimalHeuristicPackToBlocksByCpDuration = chrono::milliseconds::zero();
         chrono::milliseconds totalPrimalHeuristicBLockFindingDuration = chrono::milliseconds::zero();
+        bool anyMongeTransitionKernelUsed = false;
+        optional<int> minGlobalLowerBound;
+        long long totalDominatedNodesCount = 0;
 
         int currPuffSize = 2;
         optional<int> currObj;
@@ -170,7 +181,8 @@ namespace escs {
                     uniform_int_distribution<>()(solverConfig.mRandom),
                     stopwatch.remainingTime(solverConfig.mTimeLimit),
                     solverConfig.mNumWorkers,
-                    currStartTimes);
+                    currStartTimes,
+                    solverConfig.mUseMongeTransitions);
             currSolverConfig.mProcessableIntervals = currProcessableIntervals;
 
             BranchAndBoundOnJob solver(instance, currSolverConfig, specializedSolverConfig);
@@ -203,6 +215,17 @@ namespace escs {
             if (currResult.mPrimalHeuristicBlockFindingTotalDuration.has_value()) {
                 totalPrimalHeuristicBLockFindingDuration += currResult.mPrimalHeuristicBlockFindingTotalDuration.value();
             }
+            if (currResult.mMongeTransitionKernelUsed.has_value()) {
+                anyMongeTransitionKernelUsed |= currResult.mMongeTransitionKernelUsed.value();
+            }
+            if (currResult.mGlobalLowerBound.has_value()) {
+                minGlobalLowerBound = minGlobalLowerBound.has_value()
+                        ? min(minGlobalLowerBound.value(), currResult.mGlobalLowerBound.value())
+                        : currResult.mGlobalLowerBound.value();
+            }
+            if (currResult.mDominatedNodesCount.has_value()) {
+                totalDominatedNodesCount += currResult.mDominatedNodesCount.value();
+            }
 
             switch (currResult.mStatus) {
                 case Status::Infeasible:
@@ -221,7 +244,10 @@ namespace escs {
                                 totalLowerBoundTotalDuration,
                                 totalPrimalHeuristicBLockDetectionDuration,
                                 totalPrimalHeuristicPackToBlocksByCpDuration,
-                                totalPrimalHeuristicBLockFindingDuration);
+                                totalPrimalHeuristicBLockFindingDuration)
+                                .setMongeTransitionKernelUsed(anyMongeTransitionKernelUsed)
+                                .setGlobalLowerBound(minGlobalLowerBound)
+                                .setDominatedNodesCount(totalDominatedNodesCount);
                     }
                     else {
                         // Cannot decide, needs another puffing.
@@ -243,7 +269,10 @@ namespace escs {
                             totalLowerBoundTotalDuration,
                             totalPrimalHeuristicBLockDetectionDuration,
                             totalPrimalHeuristicPackToBlocksByCpDuration,
-                            totalPrimalHeuristicBLockFindingDuration);
+                            totalPrimalHeuristicBLockFindingDuration)
+                            .setMongeTransitionKernelUsed(anyMongeTransitionKernelUsed)
+                            .setGlobalLowerBound(minGlobalLowerBound)
+                            .setDominatedNodesCount(totalDominatedNodesCount);
                     break;
 
                 case Status::Optimal:
@@ -262,7 +291,10 @@ namespace escs {
                                 totalLowerBoundTotalDuration,
                                 totalPrimalHeuristicBLockDetectionDuration,
                                 totalPrimalHeuristicPackToBlocksByCpDuration,
-                                totalPrimalHeuristicBLockFindingDuration);
+                                totalPrimalHeuristicBLockFindingDuration)
+                                .setMongeTransitionKernelUsed(anyMongeTransitionKernelUsed)
+                                .setGlobalLowerBound(minGlobalLowerBound)
+                                .setDominatedNodesCount(totalDominatedNodesCount);
                     }
                     else {
                         // Cannot decide, needs another puffing.
@@ -286,7 +318,10 @@ namespace escs {
                             totalLowerBoundTotalDuration,
                             totalPrimalHeuristicBLockDetectionDuration,
                             totalPrimalHeuristicPackToBlocksByCpDuration,
-                            totalPrimalHeuristicBLockFindingDuration);
+                            totalPrimalHeuristicBLockFindingDuration)
+                            .setMongeTransitionKernelUsed(anyMongeTransitionKernelUsed)
+                            .setGlobalLowerBound(minGlobalLowerBound)
+                            .setDominatedNodesCount(totalDominatedNodesCount);
             }
 
             // Need another iteration, puff intervals.
@@ -306,7 +341,10 @@ namespace escs {
                 totalLowerBoundTotalDuration,
                 totalPrimalHeuristicBLockDetectionDuration,
                 totalPrimalHeuristicPackToBlocksByCpDuration,
-                totalPrimalHeuristicBLockFindingDuration);
+                totalPrimalHeuristicBLockFindingDuration)
+                .setMongeTransitionKernelUsed(anyMongeTransitionKernelUsed)
+                .setGlobalLowerBound(minGlobalLowerBound)
+                .setDominatedNodesCount(totalDominatedNodesCount);
     }
 
     vector<bool> puffBlocksToProcessableIntervals(
@@ -339,7 +377,14 @@ namespace escs {
             const escs::Instance &instance,
             escs::SolverConfig &solverConfig,
             const BranchAndBoundOnJob::SpecializedSolverConfig &specializedSolverConfig)
-                : mInstance(instance), mSolverConfig(solverConfig), mSpecializedSolverConfig(specializedSolverConfig), mRandomBranchPriorityDist(0, 1) {
+                : mInstance(instance), mSolverConfig(solverConfig), mSpecializedSolverConfig(specializedSolverConfig) {
+        int workersCount = mSolverConfig.mNumWorkers >= 1
+                ? mSolverConfig.mNumWorkers
+                : max(1, (int)thread::hardware_concurrency());
+        mSearchThreadsCount = mSpecializedSolverConfig.mSearchThreadsCount >= 1
+                ? mSpecializedSolverConfig.mSearchThreadsCount
+                : workersCount;
+        mLevelThreadsCount = max(1, workersCount / mSearchThreadsCount);
     }
 
     Status BranchAndBoundOnJob::solve() {
@@ -348,7 +393,7 @@ namespace escs {
         mStopwatch.stop();
 
         if (mStopwatch.timeLimitReached(mSolverConfig.mTimeLimit) || mNodesCountLimitReached) {
-            if (mCurrBestObj.has_value()) {
+            if (getCurrBestObj().has_value()) {
                 mStatus = Status::Heuristic;
             }
             else {
@@ -356,7 +401,7 @@ namespace escs {
             }
         }
         else {
-            if (mCurrBestObj.has_value()) {
+            if (getCurrBestObj().has_value()) {
                 mStatus = Status::Optimal;
             }
             else {
@@ -373,36 +418,58 @@ namespace escs {
         mPrimalHeuristicBlockDetectionFoundSolution = 0;
         mUsePrimalHeuristicPackToBlocksByCpFoundSolution = 0;
         mJobsJoinedOnLargerGcd = 0;
-        mCurrBestObj.reset();
+        mRootLowerBound = Instance::NO_VALUE;
+        mGlobalLowerBound.reset();
+        mDominatedNodesCount.reset();
+        mCurrBestObj = Instance::NO_VALUE;
         mStatus = Status::NoSolution;
 
-        if (mSolverConfig.mNumWorkers >= 1) {
-            // Currently, only FixedPermCostComputation runs in parallel and uses OpenMP.
-            omp_set_num_threads(mSolverConfig.mNumWorkers);
-        }
+        // Currently, only FixedPermCostComputation runs in parallel (within a search thread) and uses OpenMP.
+        omp_set_num_threads(mLevelThreadsCount);
 
-        vector<vector<int>> fixedProcTimesBlocks;
         vector<int> allProcTimes;
-        map<int, int> remainingProcTimeCounts;
+        map<int, int> jobsCountsByProcTime;
         for (auto *pJob : mInstance.mJobs) {
             allProcTimes.push_back(pJob->mProcessingTime);
-            auto it = remainingProcTimeCounts.find(pJob->mProcessingTime);
-            if (it == remainingProcTimeCounts.end()) {
-                remainingProcTimeCounts[pJob->mProcessingTime] = 1;
-            }
-            else {
-                it->second++;
+            jobsCountsByProcTime[pJob->mProcessingTime]++;
+        }
+        mProcTimeClasses.clear();
+        mProcTimeCounts.clear();
+        mProcTimeClassIds = vector<int>(jobsCountsByProcTime.empty() ? 0 : jobsCountsByProcTime.rbegin()->first + 1, -1);
+        for (auto &procTimeJobsCount : jobsCountsByProcTime) {
+            mProcTimeClassIds[procTimeJobsCount.first] = mProcTimeClasses.size();
+            mProcTimeClasses.push_back(procTimeJobsCount.first);
+            mProcTimeCounts.push_back(procTimeJobsCount.second);
+        }
+
+        mSearchThreads.clear();
+        for (int threadIdx = 0; threadIdx < mSearchThreadsCount; threadIdx++) {
+            auto *pSearchThread = new SearchThread();
+            mSearchThreads.emplace_back(pSearchThread);
+            pSearchThread->mIdx = threadIdx;
+            for (auto *pComputation : { &pSearchThread->mFixedPermCostComputation, &pSearchThread->mFixedBlocksComputation }) {
+                pComputation->reset(new FixedPermCostComputation(
+                        mInstance.getTotalProcTime(),
+                        mInstance.mIntervals.size(),
+                        mInstance.mEarliestOnIntervalIdx,
+                        mInstance.mLatestOnIntervalIdx,
+                        mInstance.mOptimalSwitchingCostsTables,
+                        mSolverConfig.mProcessableIntervals,
+                        mInstance.mOptimalSwitchingCostsGraph.get(),
+                        mSolverConfig.mUseMongeTransitions ? mInstance.mOptimalSwitchingCostsMonge.get() : nullptr));
             }
+            pSearchThread->mGcdOfValues.reset(new GcdOfValues(allProcTimes));
+            pSearchThread->mRandom = threadIdx == 0 ? mSolverConfig.mRandom : mt19937_64(mSolverConfig.mRandom());
+            pSearchThread->mRandomBranchPriorityDist = uniform_int_distribution<>(0, 1);
+            pSearchThread->mPrimalHeuristicBlockDetectionFoundSolution = 0;
+            pSearchThread->mUsePrimalHeuristicPackToBlocksByCpFoundSolution = 0;
+            pSearchThread->mJobsJoinedOnLargerGcd = 0;
+            pSearchThread->mSubtreeLowerBound = Instance::NO_VALUE;
+            pSearchThread->mSearchingSubtree = false;
+            pSearchThread->mFixedProcTimes.reserve(mInstance.mJobs.size());
+            pSearchThread->mRemProcBlocksReversedByDepth.resize(mInstance.mJobs.size() + 1);
         }
-        FixedPermCostComputation fixedPermCostComputation(
-                mInstance.getTotalProcTime(),
-                mInstance.mIntervals.size(),
-                mInstance.mEarliestOnIntervalIdx,
-                mInstance.mLatestOnIntervalIdx,
-                mInstance.mOnPowerConsumption,
-                mInstance.mOptimalSwitchingCosts,
-                mInstance.mCumulativeEnergyCost,
-                mSolverConfig.mProcessableIntervals);
+        auto &fixedPermCostComputation = *mSearchThreads[0]->mFixedPermCostComputation;
 
         if (!mSolverConfig.mInitialStartTimes.empty()) {
             vector<pair<int, int>> procTimeWithStart; // (procTime, startTime)
@@ -430,62 +497,336 @@ namespace escs {
 
             fixedPermCostComputation.reset();
 
-            cout << "BAB initialized with objective " << mCurrBestObj.value() << endl;
+            cout << "BAB initialized with objective " << mCurrBestObj.load() << endl;
         }
 
-        mFixedBlocksComputation.reset(new FixedPermCostComputation(
-                mInstance.getTotalProcTime(),
-                mInstance.mIntervals.size(),
-                mInstance.mEarliestOnIntervalIdx,
-                mInstance.mLatestOnIntervalIdx,
-                mInstance.mOnPowerConsumption,
-                mInstance.mOptimalSwitchingCosts,
-                mInstance.mCumulativeEnergyCost,
-                mSolverConfig.mProcessableIntervals));
-
-        GcdOfValues gcdOfValues(allProcTimes);
-
         int currJoinedGcd = 1;
         if (mSpecializedSolverConfig.mJobsJoiningOnGcd == ROOT
             || mSpecializedSolverConfig.mJobsJoiningOnGcd == WHOLE_TREE)
         {
             if (mInstance.getTotalProcTime() > 0) {
-                currJoinedGcd = gcdOfValues.gcd(allProcTimes);
+                currJoinedGcd = mSearchThreads[0]->mGcdOfValues->gcd(allProcTimes);
                 if (currJoinedGcd != 1) {
                     mJobsJoinedOnLargerGcd++;
-                    fixedPermCostComputation.setProcTimes(0, currJoinedGcd);
                 }
             }
         }
 
+        if (mSpecializedSolverConfig.mNodeSelection != DepthFirst) {
+            auto memoryLimitMb = mSpecializedSolverConfig.mOpenNodesMemoryLimitMb;
+            mOpenNodes.reset(new OpenNodeQueue(
+                    memoryLimitMb.has_value() ? optional<long long>(memoryLimitMb.value() * 1024 * 1024) : optional<long long>()));
+        }
+        else {
+            mOpenNodes.reset();
+        }
+
+        if (mSpecializedSolverConfig.mDominanceMemoCapacity >= 1) {
+            // Several shards per search thread, so that the threads rarely wait for each other.
+            mDominanceMemo.reset(new DominanceMemo(mSpecializedSolverConfig.mDominanceMemoCapacity, 4 * mSearchThreadsCount));
+        }
+        else {
+            mDominanceMemo.reset();
+        }
+
+        // The root is searched by the first thread, the others steal its subtrees (or take the open nodes).
+        Subtree root;
+        root.mRemainingProcTimeCounts = mProcTimeCounts;
+        root.mRemainingProcTime = mInstance.getTotalProcTime();
+        root.mJoinedGcd = currJoinedGcd;
+        root.mJoinToPrevBlock = false;
+        root.mLowerBound = Instance::NO_VALUE;
+        mSearchThreads[0]->mSubtrees.push_back(root);
+
+        mIdleSearchThreadsCount = 0;
+        mSearchFinished = false;
+        vector<thread> threads;
+        for (int threadIdx = 1; threadIdx < mSearchThreadsCount; threadIdx++) {
+            threads.emplace_back([this, threadIdx]() {
+                omp_set_num_threads(mLevelThreadsCount);
+                this->searchSubtrees(*mSearchThreads[threadIdx]);
+            });
+        }
+        this->searchSubtrees(*mSearchThreads[0]);
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        mLowerBoundTotalDuration = chrono::milliseconds::zero();
+        mPrimalHeuristicBlockDetectionTotalDuration = chrono::milliseconds::zero();
+        mPrimalHeuristicPackToBlocksByCpTotalDuration = chrono::milliseconds::zero();
+        mPrimalHeuristicBlockFindingTotalDuration = chrono::milliseconds::zero();
+        mMongeTransitionKernelUsed = false;
+        for (auto &pSearchThread : mSearchThreads) {
+            mPrimalHeuristicBlockDetectionFoundSolution += pSearchThread->mPrimalHeuristicBlockDetectionFoundSolution;
+            mUsePrimalHeuristicPackToBlocksByCpFoundSolution += pSearchThread->mUsePrimalHeuristicPackToBlocksByCpFoundSolution;
+            mJobsJoinedOnLargerGcd += pSearchThread->mJobsJoinedOnLargerGcd;
+            mLowerBoundTotalDuration += pSearchThread->mFixedPermCostComputation->getCostComputationTotalDuration();
+            mPrimalHeuristicBlockDetectionTotalDuration += pSearchThread->mPrimalHeuristicBlockDetectionStopwatch.totalDuration();
+            mPrimalHeuristicPackToBlocksByCpTotalDuration += pSearchThread->mPrimalHeuristicPackToBlocksByCpStopwatch.totalDuration();
+            mPrimalHeuristicBlockFindingTotalDuration += pSearchThread->mPrimalHeuristicBlockFindingStopwatch.totalDuration();
+            mMongeTransitionKernelUsed |= pSearchThread->mFixedPermCostComputation->getMongeTransitionsCount() > 0;
+        }
+        mGlobalLowerBound = this->computeGlobalLowerBound();
+        if (mDominanceMemo) {
+            mDominatedNodesCount = mDominanceMemo->getDominatedCount();
+        }
+        mSearchThreads.clear();
+        mOpenNodes.reset();
+        mDominanceMemo.reset();
+    }
+
+    void BranchAndBoundOnJob::searchSubtrees(SearchThread &searchThread) {
+        Subtree subtree;
+        while (this->takeSubtree(searchThread, subtree)) {
+            searchThread.mSubtreeLowerBound = subtree.mLowerBound;
+            searchThread.mSearchingSubtree = true;
+            this->enterSubtree(searchThread, subtree);
+            if (!stopSearching()) {
+                // Otherwise the subtree may be searched only partially.
+                searchThread.mSearchingSubtree = false;
+            }
+        }
+    }
+
+    bool BranchAndBoundOnJob::takeSubtree(SearchThread &searchThread, Subtree &subtree) {
+        if (mSearchFinished || stopSearching()) {
+            return false;
+        }
+
+        {
+            lock_guard<mutex> lock(searchThread.mSubtreesMutex);
+            if (!searchThread.mSubtrees.empty()) {
+                subtree = move(searchThread.mSubtrees.back());
+                searchThread.mSubtrees.pop_back();
+                return true;
+            }
+        }
+
+        if (mOpenNodes && this->takeOpenNode(subtree, false)) {
+            return true;
+        }
+
+        // Idle: steal from the others (or take an open node). The search is finished once all the threads are idle, as
+        // only a busy thread adds the subtrees (to its own deque) and the open nodes, and a thief stops being idle
+        // before it takes a subtree.
+        mIdleSearchThreadsCount++;
+        while (!mSearchFinished && !stopSearching()) {
+            for (int offset = 1; offset < mSearchThreadsCount; offset++) {
+                auto &victim = *mSearchThreads[(searchThread.mIdx + offset) % mSearchThreadsCount];
+                lock_guard<mutex> lock(victim.mSubtreesMutex);
+                if (!victim.mSubtrees.empty()) {
+                    mIdleSearchThreadsCount--;
+                    subtree = move(victim.mSubtrees.front());
+                    victim.mSubtrees.pop_front();
+                    return true;
+                }
+            }
+
+            if (mOpenNodes && this->takeOpenNode(subtree, true)) {
+                return true;
+            }
+
+            if (mIdleSearchThreadsCount == mSearchThreadsCount) {
+                mSearchFinished = true;
+                break;
+            }
+
+            this_thread::sleep_for(chrono::microseconds(100));
+        }
+
+        return false;
+    }
+
+    bool BranchAndBoundOnJob::takeOpenNode(Subtree &subtree, bool idle) {
+        OpenNodeQueue::OpenNode openNode;
+        {
+            lock_guard<mutex> lock(mOpenNodesMutex);
+            if (mOpenNodes->empty()) {
+                return false;
+            }
+
+            if (idle) {
+                mIdleSearchThreadsCount--;
+            }
+            if (!mOpenNodes->pop(mCurrBestObj, openNode)) {
+                // All the open nodes are pruned by the incumbent.
+                if (idle) {
+                    mIdleSearchThreadsCount++;
+                }
+                return false;
+            }
+        }
+
+        subtree.mFixedProcTimes.clear();
+        subtree.mRemainingProcTimeCounts = mProcTimeCounts;
+        subtree.mRemainingProcTime = mInstance.getTotalProcTime();
+        for (auto *pStep : OpenNodeQueue::getSteps(openNode.mPath)) {
+            subtree.mFixedProcTimes.push(pStep->mProcTime, !pStep->mStartsBlock);
+            subtree.mRemainingProcTimeCounts[mProcTimeClassIds[pStep->mProcTime]]--;
+            subtree.mRemainingProcTime -= pStep->mProcTime;
+        }
+        subtree.mJoinedGcd = openNode.mJoinedGcd;
+        subtree.mInheritedLowerBound = openNode.mLowerBoundInherited ? optional<int>(openNode.mLowerBound) : optional<int>();
+        subtree.mRemProcBlocksReversed = move(openNode.mRemProcBlocksReversed);
+        subtree.mJoinToPrevBlock = openNode.mJoinToPrevBlock;
+        subtree.mLowerBound = openNode.mLowerBound;
+        subtree.mPath = move(openNode.mPath);
+        return true;
+    }
+
+    bool BranchAndBoundOnJob::storeOpenNode(
+            SearchThread &searchThread,
+            int parentLowerBound,
+            bool lowerBoundInherited,
+            const vector<Block> &remProcBlocksReversed,
+            bool joinToPrevBlock,
+            int joinedGcd) {
+        // Create the missing steps of the path, the last one is of the child.
+        auto &fixedProcTimes = searchThread.mFixedProcTimes;
+        auto &pathSteps = searchThread.mPathSteps;
+        for (int position = pathSteps.size(); position < fixedProcTimes.getCount(); position++) {
+            pathSteps.push_back(make_shared<const OpenNodeQueue::PathStep>(OpenNodeQueue::PathStep {
+                    position > 0 ? pathSteps.back() : nullptr,
+                    fixedProcTimes.mProcTimes[position],
+                    binary_search(fixedProcTimes.mBlockStarts.begin(), fixedProcTimes.mBlockStarts.end(), position) }));
+        }
+
+        OpenNodeQueue::OpenNode openNode {
+                pathSteps.back(),
+                fixedProcTimes.getCount(),
+                parentLowerBound,
+                lowerBoundInherited,
+                joinToPrevBlock,
+                joinedGcd,
+                lowerBoundInherited ? remProcBlocksReversed : vector<Block>() };
+        pathSteps.pop_back();
+
+        lock_guard<mutex> lock(mOpenNodesMutex);
+        return mOpenNodes->push(move(openNode));
+    }
+
+    bool BranchAndBoundOnJob::isDominated(SearchThread &searchThread, bool joinToPrevBlock) {
+        auto &fixedPermCostComputation = *searchThread.mFixedPermCostComputation;
+        auto &fixedProcTimes = searchThread.mFixedProcTimes;
+        int lastBlockPosition = fixedProcTimes.getBlocksCount() - 1;
+        auto &frontier = searchThread.mFrontier;
+        if (!fixedPermCostComputation.saveCheckpoint(lastBlockPosition, frontier)) {
+            return false;
+        }
+
+        // The children joined to the last block may not be shorter than its last proc time, hence the prefixes with a
+        // different one have different subtrees.
+        auto &key = searchThread.mDominanceKey;
+        key.assign(searchThread.mRemainingProcTimeCounts.begin(), searchThread.mRemainingProcTimeCounts.end());
+        key.push_back(joinToPrevBlock ? 1 : 0);
+        key.push_back(joinToPrevBlock ? fixedProcTimes.mProcTimes.back() : 0);
+
+        // The costs are by the completion of the last block, so that the prefixes with the same total proc time but a
+        // different last block are comparable.
+        int minCompletion = frontier.mMinStart + fixedPermCostComputation.getPermProcTimes()[lastBlockPosition];
+        return mDominanceMemo->checkAndInsert(key, minCompletion, frontier.mCosts);
+    }
+
+    optional<int> BranchAndBoundOnJob::computeGlobalLowerBound() const {
+        auto currBestObj = this->getCurrBestObj();
+        if (!stopSearching()) {
+            return currBestObj;
+        }
+
+        // The nodes not searched are in the open nodes, the deques and the subtrees the threads stopped in.
+        int globalLowerBound = currBestObj.value_or(Instance::NO_VALUE);
+        bool rootNotSearched = false;
+        auto addSubtreeLowerBound = [&](int lowerBound) {
+            if (lowerBound == Instance::NO_VALUE) {
+                rootNotSearched = true;
+            }
+            else {
+                globalLowerBound = min(globalLowerBound, lowerBound);
+            }
+        };
+        for (auto &pSearchThread : mSearchThreads) {
+            if (pSearchThread->mSearchingSubtree) {
+                addSubtreeLowerBound(pSearchThread->mSubtreeLowerBound);
+            }
+            for (auto &subtree : pSearchThread->mSubtrees) {
+                addSubtreeLowerBound(subtree.mLowerBound);
+            }
+        }
+        if (mOpenNodes) {
+            globalLowerBound = min(globalLowerBound, mOpenNodes->getMinLowerBound().value_or(Instance::NO_VALUE));
+        }
+        if (rootNotSearched) {
+            globalLowerBound = min(globalLowerBound, mRootLowerBound);
+        }
+
+        return globalLowerBound != Instance::NO_VALUE ? optional<int>(globalLowerBound) : optional<int>();
+    }
+
+    void BranchAndBoundOnJob::enterSubtree(SearchThread &searchThread, Subtree &subtree) {
+        // The permutation of the node: the fixed blocks followed by the remaining proc time in gcd-sized parts, all the
+        // fixed blocks but the last one are followed by a forced space.
+        auto &fixedPermCostComputation = *searchThread.mFixedPermCostComputation;
+        fixedPermCostComputation.reset();
+        vector<int> procTimes = subtree.mFixedProcTimes.mBlockProcTimes;
+        for (int i = 0; i < subtree.mRemainingProcTime / subtree.mJoinedGcd; i++) {
+            procTimes.push_back(subtree.mJoinedGcd);
+        }
+        if (!procTimes.empty()) {
+            fixedPermCostComputation.setPermutation(procTimes);
+        }
+        for (int position = 0; position < subtree.mFixedProcTimes.getBlocksCount(); position++) {
+            bool lastBlock = position == subtree.mFixedProcTimes.getBlocksCount() - 1;
+            fixedPermCostComputation.setForcedSpace(position, !lastBlock || !subtree.mJoinToPrevBlock ? 1 : 0);
+        }
+
+        searchThread.mPathSteps.clear();
+        for (auto pStep = subtree.mPath; pStep; pStep = pStep->mParent) {
+            searchThread.mPathSteps.push_back(pStep);
+        }
+        reverse(searchThread.mPathSteps.begin(), searchThread.mPathSteps.end());
+
+        searchThread.mFixedProcTimes = subtree.mFixedProcTimes;
+        searchThread.mRemainingProcTimeCounts = subtree.mRemainingProcTimeCounts;
+        searchThread.mGcdOfValues->setCounts(subtree.mRemainingProcTimeCounts);
         this->enterNode(
-                fixedProcTimesBlocks,
-                0,
-                remainingProcTimeCounts,
-                mInstance.getTotalProcTime(),
-                fixedPermCostComputation,
-                gcdOfValues,
-                currJoinedGcd,
-                optional<int>(),
-                vector<Block>(),
-                false);
-
-        mLowerBoundTotalDuration = fixedPermCostComputation.getCostComputationTotalDuration();
-        mPrimalHeuristicBlockDetectionTotalDuration = mPrimalHeuristicBlockDetectionStopwatch.totalDuration();
-        mPrimalHeuristicPackToBlocksByCpTotalDuration = mPrimalHeuristicPackToBlocksByCpStopwatch.totalDuration();
-        mPrimalHeuristicBlockFindingTotalDuration = mPrimalHeuristicBlockFindingStopwatch.totalDuration();
+                searchThread,
+                subtree.mRemainingProcTime,
+                subtree.mJoinedGcd,
+                subtree.mInheritedLowerBound,
+                subtree.mRemProcBlocksReversed,
+                subtree.mJoinToPrevBlock);
+    }
+
+    bool BranchAndBoundOnJob::updateCurrBest(
+            int obj,
+            vector<int> permProcTimes,
+            vector<int> permStartTimes,
+            const string &foundBy) {
+        int currBestObj = mCurrBestObj.load();
+        do {
+            if (currBestObj <= obj) {
+                return false;
+            }
+        } while (!mCurrBestObj.compare_exchange_weak(currBestObj, obj));
+
+        lock_guard<mutex> lock(mCurrBestMutex);
+        if (mCurrBestObj == obj) {
+            // Not improved by another thread meanwhile.
+            mCurrBestPermProcTimes = move(permProcTimes);
+            mCurrBestPermStartTimes = move(permStartTimes);
+            cout << "New ub (" << foundBy << "): " << obj << ", time " << mStopwatch.totalDuration().count() << " ms " << endl;
+        }
+
+        return true;
     }
 
     void BranchAndBoundOnJob::enterNode(
-            vector<vector<int>> &fixedProcTimesBlocks,
-            int fixedProcTimesCount,
-            map<int, int> &remainingProcTimeCounts,
+            SearchThread &searchThread,
             int remainingProcTime,
-            FixedPermCostComputation &fixedPermCostComputation,
-            GcdOfValues &gcdOfValues,
             int currJoinedGcd,
             optional<int> inheritedLowerBound,
-            vector<Block> remProcBlocksReversed,
+            vector<Block> &inheritedRemProcBlocksReversed,
             bool joinToPrevBlock) {
         if (mSpecializedSolverConfig.mFullHorizonBabNodesCountLimit.has_value()
             && mNodesCount >= mSpecializedSolverConfig.mFullHorizonBabNodesCountLimit.value()) {
@@ -493,33 +834,49 @@ namespace escs {
             return;
         }
 
-        mNodesCount++;
-        long long currNode = mNodesCount;
-        mCurrNode = currNode;
+        long long currNode = ++mNodesCount;
+        auto &fixedPermCostComputation = *searchThread.mFixedPermCostComputation;
+        auto &gcdOfValues = *searchThread.mGcdOfValues;
+        auto &fixedProcTimes = searchThread.mFixedProcTimes;
+        auto &remainingProcTimeCounts = searchThread.mRemainingProcTimeCounts;
+        int fixedProcTimesCount = fixedProcTimes.getCount();
+        auto *pRemProcBlocksReversed = &inheritedRemProcBlocksReversed;
 
 #ifdef DEBUG
-        printCurrNodeLogPrefix(fixedProcTimesBlocks); cout << "Node " << currNode << " entered." << endl;
-        printCurrNodeLogPrefix(fixedProcTimesBlocks); cout << "currJoinedGcd: " << currJoinedGcd << endl;
+        printCurrNodeLogPrefix(searchThread.mFixedProcTimes); cout << "Node " << currNode << " entered." << endl;
+        printCurrNodeLogPrefix(searchThread.mFixedProcTimes); cout << "currJoinedGcd: " << currJoinedGcd << endl;
 #endif
         int currNodeLowerBound;
         if (inheritedLowerBound.has_value()) {
             currNodeLowerBound = inheritedLowerBound.value();
         }
         else {
-            currNodeLowerBound = fixedPermCostComputation.recomputeCost();
+            // Only the levels of the fixed blocks are computed, the relaxed (gcd-sized) remainder is evaluated by the
+            // relaxed suffix table shared by all the nodes with the same currJoinedGcd. A node whose bound would not be
+            // less than the incumbent is pruned anyway, so its computation is stopped as soon as this is known (except
+            // for the root, whose bound is reported).
+            int upperBound = currNode == 1 ? Instance::NO_VALUE : mCurrBestObj.load();
+            currNodeLowerBound = fixedPermCostComputation.recomputeCost(upperBound);
             if (currNodeLowerBound == Instance::NO_VALUE) {
 #ifdef DEBUG
-                printCurrNodeLogPrefix(fixedProcTimesBlocks); cout << "Not feasible node based on LB" << endl;
+                printCurrNodeLogPrefix(searchThread.mFixedProcTimes); cout << "Not feasible or dominated node based on LB" << endl;
 #endif
                 return;
             }
-            remProcBlocksReversed = Block::getProcBlocks(fixedPermCostComputation, fixedProcTimesBlocks.size());
-            reverse(remProcBlocksReversed.begin(), remProcBlocksReversed.end());
+            // The nodes deeper than this one use the buffers of their depths.
+            pRemProcBlocksReversed = &searchThread.mRemProcBlocksReversedByDepth[fixedProcTimesCount];
+            Block::getProcBlocks(
+                    fixedPermCostComputation,
+                    fixedProcTimes.getBlocksCount(),
+                    searchThread.mStartTimes,
+                    *pRemProcBlocksReversed);
+            reverse(pRemProcBlocksReversed->begin(), pRemProcBlocksReversed->end());
         }
+        auto &remProcBlocksReversed = *pRemProcBlocksReversed;
 
 #ifdef DEBUG
-        printCurrNodeLogPrefix(fixedProcTimesBlocks); cout << "LB: " << currNodeLowerBound << endl;
-        printCurrNodeLogPrefix(fixedProcTimesBlocks); cout << "Inherited LB? " << inheritedLowerBound.has_value() << endl;
+        printCurrNodeLogPrefix(searchThread.mFixedProcTimes); cout << "LB: " << currNodeLowerBound << endl;
+        printCurrNodeLogPrefix(searchThread.mFixedProcTimes); cout << "Inherited LB? " << inheritedLowerBound.has_value() << endl;
 #endif
 
         if (currNode == 1) {
@@ -527,51 +884,53 @@ namespace escs {
         }
 
         // Check lower bound
-        if (mCurrBestObj.has_value()) {
-            if (mCurrBestObj.value() <= currNodeLowerBound) {
+        if (mCurrBestObj <= currNodeLowerBound) {
 #ifdef DEBUG
-                printCurrNodeLogPrefix(fixedProcTimesBlocks); cout << "Pruning node with lb=" << currNodeLowerBound << " by ub=" << mCurrBestObj.value() << endl;
+            printCurrNodeLogPrefix(searchThread.mFixedProcTimes); cout << "Pruning node with lb=" << currNodeLowerBound << " by ub=" << mCurrBestObj.load() << endl;
 #endif
-                return;
-            }
+            return;
         }
 
         // Everything scheduled?
         if (remainingProcTime == 0) {
             if (currNodeLowerBound != Instance::NO_VALUE) {
-                if (!mCurrBestObj.has_value() || currNodeLowerBound < mCurrBestObj.value()) {
-                    mCurrBestObj = currNodeLowerBound;
-                    mCurrBestPermProcTimes = this->flatten(fixedProcTimesBlocks);
-                    mCurrBestPermStartTimes = this->startTimesFromBlockProcTimes(
-                            fixedPermCostComputation.reconstructStartTimes(),
-                            fixedProcTimesBlocks);
 #ifdef DEBUG
-                    printCurrNodeLogPrefix(fixedProcTimesBlocks);
+                printCurrNodeLogPrefix(searchThread.mFixedProcTimes);
 #endif
-                    cout << "New ub (leaf): " << mCurrBestObj.value() << ", time " << mStopwatch.totalDuration().count() << " ms " << endl;
-                }
+                this->updateCurrBest(
+                        currNodeLowerBound,
+                        fixedProcTimes.mProcTimes,
+                        this->startTimesFromBlockProcTimes(
+                                fixedPermCostComputation.reconstructStartTimes(),
+                                fixedProcTimes),
+                        "leaf");
             }
 
             return;
         }
 
+        // Dominance of the prefix, whose costs are known only if computed at this node.
+        if (mDominanceMemo && !inheritedLowerBound.has_value() && fixedProcTimesCount > 0
+            && this->isDominated(searchThread, joinToPrevBlock)) {
+#ifdef DEBUG
+            printCurrNodeLogPrefix(searchThread.mFixedProcTimes); cout << "Pruning node dominated by a searched node" << endl;
+#endif
+            return;
+        }
+
         // Primal heuristics.
         // If we inherited lower bound from parent node, do not compute them (as they would not find any new solution).
         if (!inheritedLowerBound.has_value()) {
             // Primal heuristic: block detection.
             if (mSpecializedSolverConfig.mUsePrimalHeuristicBlockDetection) {
-                if (this->PerformPrimalHeuristicBlockDetection(fixedProcTimesBlocks, remainingProcTimeCounts,
-                                                               remainingProcTime,
-                                                               fixedPermCostComputation)) {
+                if (this->PerformPrimalHeuristicBlockDetection(searchThread, remainingProcTime)) {
                     return;
                 }
             }
 
             // Primal heuristic: packing of remaining proctimes into blocks (using CP).
             if (mSpecializedSolverConfig.mUsePrimalHeuristicPackToBlocksByCp) {
-                if (this->PerformPrimalHeuristicPackToBlocksByCp(fixedProcTimesBlocks, remainingProcTimeCounts,
-                                                                 remainingProcTime,
-                                                                 fixedPermCostComputation)) {
+                if (this->PerformPrimalHeuristicPackToBlocksByCp(searchThread, remainingProcTime)) {
                     return;
                 }
             }
@@ -579,12 +938,16 @@ namespace escs {
             // Primal heuristic: trying to reconstruct UB using block-finding model
             if (((mSpecializedSolverConfig.mBlockFinding == PrimalHeuristicBlockFinding::BF_ROOT) && (currNode == 1))
                 || (mSpecializedSolverConfig.mBlockFinding == PrimalHeuristicBlockFinding::BF_WHOLE_TREE)) {
-                mPrimalHeuristicBlockFindingStopwatch.start();
+                searchThread.mPrimalHeuristicBlockFindingStopwatch.start();
                 bool sameAsRelaxedBlocks = false;
-                auto assignments = PerformPrimalHeuristicBlockFinding(Block::getProcBlocks(fixedPermCostComputation, 0), sameAsRelaxedBlocks);
+                auto assignments = PerformPrimalHeuristicBlockFinding(
+                        searchThread,
+                        Block::getProcBlocks(fixedPermCostComputation, 0),
+                        sameAsRelaxedBlocks);
 
                 if (assignments.size() > 0) {
-                    mFixedBlocksComputation->reset();
+                    auto &fixedBlocksComputation = *searchThread.mFixedBlocksComputation;
+                    fixedBlocksComputation.reset();
 
                     vector<int> newBlockLengths;
                     for (int j = 0; j < (int)mInstance.mJobs.size(); j++) {
@@ -596,15 +959,12 @@ namespace escs {
                     }
 
                     for (int position = 0; position < (int)newBlockLengths.size(); position++) {
-                        mFixedBlocksComputation->join(position, newBlockLengths[position]);
+                        fixedBlocksComputation.join(position, newBlockLengths[position]);
                     }
-                    auto newUpperBound = mFixedBlocksComputation->recomputeCost();
-
-                    if (newUpperBound != Instance::NO_VALUE
-                        && (!mCurrBestObj.has_value() || mCurrBestObj.value() > newUpperBound)) {
-                        mCurrBestObj = newUpperBound;
+                    auto newUpperBound = fixedBlocksComputation.recomputeCost(mCurrBestObj.load());
 
-                        auto newBlockStartTimes = mFixedBlocksComputation->reconstructStartTimes();
+                    if (newUpperBound != Instance::NO_VALUE) {
+                        auto newBlockStartTimes = fixedBlocksComputation.reconstructStartTimes();
 
                         // TODO: merge this with the logic from CP?
                         vector<pair<int, int>> remainingProcTimeWithStart; // (procTime, startTime)
@@ -623,43 +983,47 @@ namespace escs {
                                     return lhs.second < rhs.second;
                                 });
 
-                        mCurrBestPermStartTimes = vector<int>();
-                        mCurrBestPermProcTimes = vector<int>();
+                        vector<int> newPermProcTimes;
+                        vector<int> newPermStartTimes;
                         for (auto &p : remainingProcTimeWithStart) {
-                            mCurrBestPermProcTimes.push_back(p.first);
-                            mCurrBestPermStartTimes.push_back(p.second);
+                            newPermProcTimes.push_back(p.first);
+                            newPermStartTimes.push_back(p.second);
                         }
 
 #ifdef DEBUG
-                        printCurrNodeLogPrefix(fixedProcTimesBlocks);
+                        printCurrNodeLogPrefix(searchThread.mFixedProcTimes);
 #endif
-                        cout << "New ub (PrimalHeuristicBlockFinding): " << mCurrBestObj.value() << ", time " << mStopwatch.totalDuration().count() << " ms " << endl;
-
-                        if (sameAsRelaxedBlocks) {
-                            mPrimalHeuristicBlockFindingStopwatch.stop();
+                        bool newUpperBoundSet = this->updateCurrBest(
+                                newUpperBound,
+                                move(newPermProcTimes),
+                                move(newPermStartTimes),
+                                "PrimalHeuristicBlockFinding");
+
+                        if (newUpperBoundSet && sameAsRelaxedBlocks) {
+                            searchThread.mPrimalHeuristicBlockFindingStopwatch.stop();
                             return;
                         }
                     }
                 }
 
-                mPrimalHeuristicBlockFindingStopwatch.stop();
+                searchThread.mPrimalHeuristicBlockFindingStopwatch.stop();
             }
         }
 
-        // Branching.
-        for (auto &procTimeAndCount : remainingProcTimeCounts) {
-            int procTime = procTimeAndCount.first;
-            int remainingProcTimeCount = procTimeAndCount.second;
-            if (remainingProcTimeCount == 0) {
+        // Branching. The state of the node is changed for the child and restored after it in the reverse order.
+        bool diveChildEntered = false;
+        for (int procTimeClass = 0; procTimeClass < (int)mProcTimeClasses.size(); procTimeClass++) {
+            int procTime = mProcTimeClasses[procTimeClass];
+            if (remainingProcTimeCounts[procTimeClass] == 0) {
                 continue;
             }
 
-            if (joinToPrevBlock && fixedProcTimesBlocks.back().back() > procTime) {
+            if (joinToPrevBlock && fixedProcTimes.mProcTimes.back() > procTime) {
                 // Only non-decreasing jobs joining.
                 continue;
             }
 
-            auto randomBranchType = mRandomBranchPriorityDist(mSolverConfig.mRandom);
+            auto randomBranchType = searchThread.mRandomBranchPriorityDist(searchThread.mRandom);
             for (int branchType = 0; branchType <= 1; branchType++) {   // The actual type is determined by forcedSpace.
                 bool forcedSpace = false;
                 switch (mSpecializedSolverConfig.mBranchPriority) {
@@ -686,135 +1050,153 @@ namespace escs {
                 }
 
 #ifdef DEBUG
-                printCurrNodeLogPrefix(fixedProcTimesBlocks); cout << "Fixing proctime " << procTime << ", forcing next space " << forcedSpace << endl;
+                printCurrNodeLogPrefix(searchThread.mFixedProcTimes); cout << "Fixing proctime " << procTime << ", forcing next space " << forcedSpace << endl;
 #endif
 
-                if (joinToPrevBlock) {
-                    fixedProcTimesBlocks.back().push_back(procTime);
-                }
-                else {
-                    fixedProcTimesBlocks.push_back({ procTime });
-                }
-                fixedProcTimesCount++;
+                fixedProcTimes.push(procTime, joinToPrevBlock);
+                int lastBlockPosition = fixedProcTimes.getBlocksCount() - 1;
 
-                remainingProcTimeCount--;
-                procTimeAndCount.second = remainingProcTimeCount;
+                remainingProcTimeCounts[procTimeClass]--;
+                gcdOfValues.addCount(procTimeClass, -1);
                 int newRemainingProcTime = remainingProcTime - procTime;
 
                 if (joinToPrevBlock) {
-                    fixedPermCostComputation.join(fixedProcTimesBlocks.size() - 1, 1 + procTime / currJoinedGcd);
+                    fixedPermCostComputation.join(lastBlockPosition, 1 + procTime / currJoinedGcd);
                 }
                 else {
-                    fixedPermCostComputation.join(fixedProcTimesBlocks.size() - 1, procTime / currJoinedGcd);
+                    fixedPermCostComputation.join(lastBlockPosition, procTime / currJoinedGcd);
                 }
 
                 // Set forced space.
-                fixedPermCostComputation.setForcedSpace(fixedProcTimesBlocks.size() - 1, forcedSpace ? 1 : 0);
+                fixedPermCostComputation.setForcedSpace(lastBlockPosition, forcedSpace ? 1 : 0);
 
                 int newJoinedGcd = currJoinedGcd;
                 if (mSpecializedSolverConfig.mJobsJoiningOnGcd == WHOLE_TREE) {
                     if (newRemainingProcTime > 0) {
-                        // TODO (perf):
-                        vector<int> remainingProcTimes;
-                        for (auto it : remainingProcTimeCounts) {
-                            for (int i = 0; i < it.second; i++) {
-                                remainingProcTimes.push_back(it.first);
-                            }
-                        }
-
-                        newJoinedGcd = gcdOfValues.gcd(remainingProcTimes);
+                        newJoinedGcd = gcdOfValues.getGcd();
                         if (newJoinedGcd != currJoinedGcd) {
                             if (newJoinedGcd > currJoinedGcd) {
-                                mJobsJoinedOnLargerGcd++;
+                                searchThread.mJobsJoinedOnLargerGcd++;
                             }
-                            fixedPermCostComputation.setProcTimes(fixedProcTimesBlocks.size(), newJoinedGcd);
+                            fixedPermCostComputation.setProcTimes(lastBlockPosition + 1, newJoinedGcd);
                         }
                     }
                 }
 
-                // Lower bound inheritance.
+                // Lower bound inheritance, the child fills the start of the last remaining proc block. The leaves do not
+                // inherit: the start times reported by a leaf are reconstructed from its own costs, which the inherited
+                // bound of the relaxed blocks of the parent does not need to agree with.
                 optional<int> childInheritedLowerBound;
-                vector<Block> childRemProcBlocksReversed;
-                if (!forcedSpace) { // No inheritance when forcing space.
+                optional<Block> filledRemProcBlock;
+                if (!forcedSpace && newRemainingProcTime > 0) { // No inheritance when forcing space.
                     if (remProcBlocksReversed.back().getLength() >= procTime) {
                         childInheritedLowerBound = currNodeLowerBound;
-                        childRemProcBlocksReversed = remProcBlocksReversed;
-                        childRemProcBlocksReversed.back().mStart += procTime;
-                        if (childRemProcBlocksReversed.back().getLength() == 0) {
-                            childRemProcBlocksReversed.pop_back();
+                        filledRemProcBlock = remProcBlocksReversed.back();
+                        remProcBlocksReversed.back().mStart += procTime;
+                        if (remProcBlocksReversed.back().getLength() == 0) {
+                            remProcBlocksReversed.pop_back();
                         }
                     }
                 }
 
-                // Go deeper.
-                this->enterNode(
-                        fixedProcTimesBlocks,
-                        fixedProcTimesCount,
-                        remainingProcTimeCounts,
-                        newRemainingProcTime,
-                        fixedPermCostComputation,
-                        gcdOfValues,
-                        newJoinedGcd,
-                        childInheritedLowerBound,
-                        childRemProcBlocksReversed,
-                        !forcedSpace);
-
-                mCurrNode = currNode;
+                // Keep the child open for the best-first search (unless diving into it) if there is memory for it.
+                bool childKept = false;
+                if (mOpenNodes) {
+                    // The steps from the previous child are not on the path.
+                    if ((int)searchThread.mPathSteps.size() >= fixedProcTimes.getCount()) {
+                        searchThread.mPathSteps.resize(fixedProcTimes.getCount() - 1);
+                    }
+
+                    if (mSpecializedSolverConfig.mNodeSelection == BestFirst || diveChildEntered) {
+                        childKept = this->storeOpenNode(
+                                searchThread,
+                                currNodeLowerBound,
+                                childInheritedLowerBound.has_value(),
+                                remProcBlocksReversed,
+                                !forcedSpace,
+                                newJoinedGcd);
+                    }
+                }
+
+                // Go deeper, or leave the child to an idle thread if there is nothing else to steal from this one.
+                bool childDonated = false;
+                if (!childKept && mSearchThreadsCount > 1 && mIdleSearchThreadsCount > 0) {
+                    lock_guard<mutex> lock(searchThread.mSubtreesMutex);
+                    if (searchThread.mSubtrees.empty()) {
+                        searchThread.mSubtrees.push_back(Subtree {
+                                fixedProcTimes,
+                                remainingProcTimeCounts,
+                                newRemainingProcTime,
+                                newJoinedGcd,
+                                childInheritedLowerBound,
+                                childInheritedLowerBound.has_value() ? remProcBlocksReversed : vector<Block>(),
+                                !forcedSpace,
+                                currNodeLowerBound,
+                                nullptr });
+                        childDonated = true;
+                    }
+                }
+
+                if (!childKept && !childDonated) {
+                    diveChildEntered = true;
+                    this->enterNode(
+                            searchThread,
+                            newRemainingProcTime,
+                            newJoinedGcd,
+                            childInheritedLowerBound,
+                            remProcBlocksReversed,
+                            !forcedSpace);
+                }
+
+                // Undo the filling of the remaining proc block.
+                if (filledRemProcBlock.has_value()) {
+                    if (filledRemProcBlock.value().getLength() == procTime) {
+                        remProcBlocksReversed.push_back(filledRemProcBlock.value());
+                    }
+                    else {
+                        remProcBlocksReversed.back() = filledRemProcBlock.value();
+                    }
+                }
 
                 // Undo new gcd splits into the old one.
                 if (mSpecializedSolverConfig.mJobsJoiningOnGcd == WHOLE_TREE) {
                     if (newRemainingProcTime > 0 && newJoinedGcd != currJoinedGcd) {
-                        fixedPermCostComputation.setProcTimes(fixedProcTimesBlocks.size(), currJoinedGcd);
+                        fixedPermCostComputation.setProcTimes(lastBlockPosition + 1, currJoinedGcd);
                     }
                 }
 
                 // Undo forced space.
-                fixedPermCostComputation.setForcedSpace(fixedProcTimesBlocks.size() - 1, 0);
-                if (fixedProcTimesBlocks.size() >= 2) {
-                    fixedPermCostComputation.setForcedSpace(fixedProcTimesBlocks.size() - 2, joinToPrevBlock ? 0 : 1);
+                fixedPermCostComputation.setForcedSpace(lastBlockPosition, 0);
+                if (lastBlockPosition >= 1) {
+                    fixedPermCostComputation.setForcedSpace(lastBlockPosition - 1, joinToPrevBlock ? 0 : 1);
                 }
 
                 // Undo join.
                 if (joinToPrevBlock) {
-                    // TODO (perf):
-                    int lastBlockTotalProcTime = 0;
-                    for (auto p : fixedProcTimesBlocks.back()) {
-                        lastBlockTotalProcTime += p;
-                    }
-
-                    vector<int> newSplits;
-                    newSplits.push_back(lastBlockTotalProcTime - procTime);
+                    auto &splits = searchThread.mSplits;
+                    splits.clear();
+                    splits.push_back(fixedProcTimes.mBlockProcTimes.back() - procTime);
                     int procTimeSplitsCount = procTime / currJoinedGcd;
                     for (int i = 0; i < procTimeSplitsCount; i++) {
-                        newSplits.push_back(currJoinedGcd);
+                        splits.push_back(currJoinedGcd);
                     }
 
-                    fixedPermCostComputation.split(fixedProcTimesBlocks.size() - 1, newSplits);
-                }
-                else {
-                    fixedPermCostComputation.split(fixedProcTimesBlocks.size() - 1, procTime / currJoinedGcd);
-                }
-
-                remainingProcTimeCount++;
-                procTimeAndCount.second = remainingProcTimeCount;
-
-                if (joinToPrevBlock) {
-                    fixedProcTimesBlocks.back().pop_back();
+                    fixedPermCostComputation.split(lastBlockPosition, splits);
                 }
                 else {
-                    fixedProcTimesBlocks.pop_back();
+                    fixedPermCostComputation.split(lastBlockPosition, procTime / currJoinedGcd);
                 }
 
-                fixedProcTimesCount--;
+                remainingProcTimeCounts[procTimeClass]++;
+                gcdOfValues.addCount(procTimeClass, 1);
+                fixedProcTimes.pop();
 
                 // Check lb again.
-                if (mCurrBestObj.has_value()) {
-                    if (mCurrBestObj.value() <= currNodeLowerBound) {
+                if (mCurrBestObj <= currNodeLowerBound) {
 #ifdef DEBUG
-                        printCurrNodeLogPrefix(fixedProcTimesBlocks); cout << "Pruning node (by backtrack) with lb=" << currNodeLowerBound << " by ub=" << mCurrBestObj.value() << endl;
+                    printCurrNodeLogPrefix(searchThread.mFixedProcTimes); cout << "Pruning node (by backtrack) with lb=" << currNodeLowerBound << " by ub=" << mCurrBestObj.load() << endl;
 #endif
-                        return;
-                    }
+                    return;
                 }
 
                 if (stopSearching()) {
@@ -852,7 +1234,7 @@ namespace escs {
         return Result(
                 mStatus,
                 mStopwatch.timeLimitReached(mSolverConfig.mTimeLimit),
-                mCurrBestObj,
+                getCurrBestObj(),
                 getStartTimes(),
                 mNodesCount,
                 mPrimalHeuristicBlockDetectionFoundSolution,
@@ -862,14 +1244,23 @@ namespace escs {
                 mLowerBoundTotalDuration,
                 mPrimalHeuristicBlockDetectionTotalDuration,
                 mPrimalHeuristicPackToBlocksByCpTotalDuration,
-                mPrimalHeuristicBlockFindingTotalDuration);
+                mPrimalHeuristicBlockFindingTotalDuration)
+                .setMongeTransitionKernelUsed(mMongeTransitionKernelUsed)
+                .setGlobalLowerBound(mGlobalLowerBound)
+                .setDominatedNodesCount(mDominatedNodesCount);
     }
 
 
     vector<int> BranchAndBoundOnJob::PerformPrimalHeuristicBlockFinding(
+            SearchThread &searchThread,
             const vector<Block> &relaxedBlocks,
             bool &sameAsRelaxedBlocks) {
-        BlockFinding blockFinding(mEnv);
+        if (searchThread.mIdx != 0 && !searchThread.mEnv) {
+            // A Gurobi environment must not be shared by the threads.
+            searchThread.mEnv.reset(new GRBEnv());
+        }
+
+        BlockFinding blockFinding(searchThread.mIdx == 0 ? mEnv : *searchThread.mEnv);
         blockFinding.solve(
                 (BlockFinding::BlockFindingStrategy)mSpecializedSolverConfig.mBlockFindingStrategy,
                 mInstance,
@@ -879,81 +1270,75 @@ namespace escs {
         return blockFinding.mAssignments;
     }
 
-    bool BranchAndBoundOnJob::PerformPrimalHeuristicBlockDetection(
-            vector<vector<int>> &fixedProcTimesBlocks,
-            map<int, int> &remainingProcTimeCounts,
-            int remainingProcTime,
-            FixedPermCostComputation &fixedPermCostComputation)
+    bool BranchAndBoundOnJob::PerformPrimalHeuristicBlockDetection(SearchThread &searchThread, int remainingProcTime)
     {
-        mPrimalHeuristicBlockDetectionStopwatch.start();
+        auto &fixedPermCostComputation = *searchThread.mFixedPermCostComputation;
+        auto &fixedProcTimes = searchThread.mFixedProcTimes;
+        searchThread.mPrimalHeuristicBlockDetectionStopwatch.start();
 
         fixedPermCostComputation.recomputeCost();
 
-        if (mCurrBestObj.has_value()) {
-            if (mCurrBestObj.value() <= fixedPermCostComputation.getOptCost()) {
-                mPrimalHeuristicBlockDetectionStopwatch.stop();
-                return false;
-            }
+        if (mCurrBestObj <= fixedPermCostComputation.getOptCost()) {
+            searchThread.mPrimalHeuristicBlockDetectionStopwatch.stop();
+            return false;
         }
 
-        auto startTimes = fixedPermCostComputation.reconstructStartTimes();
-        int blockStart = startTimes[fixedProcTimesBlocks.size()];
+        auto &startTimes = searchThread.mStartTimes;
+        fixedPermCostComputation.reconstructStartTimes(startTimes);
+        int blockStart = startTimes[fixedProcTimes.getBlocksCount()];
         int blockCompletion = startTimes.back() + fixedPermCostComputation.getPermProcTimes().back();
 
         bool blockDetected = false;
         if ((blockCompletion - blockStart) == remainingProcTime) {
             blockDetected = true;
 
-            if (!mCurrBestObj.has_value() || fixedPermCostComputation.getOptCost() < mCurrBestObj.value()) {
-                mCurrBestObj = fixedPermCostComputation.getOptCost();
-
-                mCurrBestPermProcTimes = this->flatten(fixedProcTimesBlocks);
-                mCurrBestPermStartTimes = this->startTimesFromBlockProcTimes(startTimes, fixedProcTimesBlocks);
+            auto newPermProcTimes = fixedProcTimes.mProcTimes;
+            auto newPermStartTimes = this->startTimesFromBlockProcTimes(startTimes, fixedProcTimes);
 
-                int nextStartTime = blockStart;
-                for (auto it : remainingProcTimeCounts) {
-                    int procTime = it.first;
-                    for (int i = 0; i < it.second; i++) {
-                        mCurrBestPermStartTimes.push_back(nextStartTime);
-                        mCurrBestPermProcTimes.push_back(procTime);
-                        nextStartTime += procTime;
-                    }
+            int nextStartTime = blockStart;
+            for (int procTimeClass = 0; procTimeClass < (int)mProcTimeClasses.size(); procTimeClass++) {
+                int procTime = mProcTimeClasses[procTimeClass];
+                for (int i = 0; i < searchThread.mRemainingProcTimeCounts[procTimeClass]; i++) {
+                    newPermStartTimes.push_back(nextStartTime);
+                    newPermProcTimes.push_back(procTime);
+                    nextStartTime += procTime;
                 }
+            }
 
 #ifdef DEBUG
-                printCurrNodeLogPrefix(fixedProcTimesBlocks);
+            printCurrNodeLogPrefix(searchThread.mFixedProcTimes);
 #endif
-                cout << "New ub (PerformPrimalHeuristicBlockDetection): " << mCurrBestObj.value() << ", time " << mStopwatch.totalDuration().count() << " ms " << endl;
-                mPrimalHeuristicBlockDetectionFoundSolution++;
+            if (this->updateCurrBest(
+                    fixedPermCostComputation.getOptCost(),
+                    move(newPermProcTimes),
+                    move(newPermStartTimes),
+                    "PerformPrimalHeuristicBlockDetection")) {
+                searchThread.mPrimalHeuristicBlockDetectionFoundSolution++;
             }
         }
 
-        mPrimalHeuristicBlockDetectionStopwatch.stop();
+        searchThread.mPrimalHeuristicBlockDetectionStopwatch.stop();
         return blockDetected;
     }
 
-    bool BranchAndBoundOnJob::PerformPrimalHeuristicPackToBlocksByCp(
-            vector<vector<int>> &fixedProcTimesBlocks,
-            map<int, int> &remainingProcTimeCounts,
-            int /*remainingProcTime*/,
-            FixedPermCostComputation &fixedPermCostComputation)
+    bool BranchAndBoundOnJob::PerformPrimalHeuristicPackToBlocksByCp(SearchThread &searchThread, int /*remainingProcTime*/)
     {
-        mPrimalHeuristicPackToBlocksByCpStopwatch.start();
+        auto &fixedPermCostComputation = *searchThread.mFixedPermCostComputation;
+        auto &fixedProcTimes = searchThread.mFixedProcTimes;
+        searchThread.mPrimalHeuristicPackToBlocksByCpStopwatch.start();
 
         fixedPermCostComputation.recomputeCost();
-        if (mCurrBestObj.has_value()) {
-            if (mCurrBestObj.value() <= fixedPermCostComputation.getOptCost()) {
-                mPrimalHeuristicPackToBlocksByCpStopwatch.stop();
-                return false;
-            }
+        if (mCurrBestObj <= fixedPermCostComputation.getOptCost()) {
+            searchThread.mPrimalHeuristicPackToBlocksByCpStopwatch.stop();
+            return false;
         }
 
         auto blocks = Block::getProcBlocks(
             fixedPermCostComputation,
-            mSpecializedSolverConfig.mPrimalHeuristicPackToBlocksByCpAllJobs ? 0 : fixedProcTimesBlocks.size());
+            mSpecializedSolverConfig.mPrimalHeuristicPackToBlocksByCpAllJobs ? 0 : fixedProcTimes.getBlocksCount());
 
 #ifdef DEBUG
-        printCurrNodeLogPrefix(fixedProcTimesBlocks);
+        printCurrNodeLogPrefix(searchThread.mFixedProcTimes);
         cout << "Block sizes for cp: ";
         for (auto &block : blocks) {
             cout << block.mStart << "=|" << block.getLength() << "|, ";
@@ -977,9 +1362,9 @@ namespace escs {
             }
         }
         else {
-            for (auto it : remainingProcTimeCounts) {
-                int procTime = it.first;
-                for (int i = 0; i < it.second; i++) {
+            for (int procTimeClass = 0; procTimeClass < (int)mProcTimeClasses.size(); procTimeClass++) {
+                int procTime = mProcTimeClasses[procTimeClass];
+                for (int i = 0; i < searchThread.mRemainingProcTimeCounts[procTimeClass]; i++) {
                     size.add(procTime);
                 }
             }
@@ -1013,19 +1398,11 @@ namespace escs {
             cp.setParameter(IloCP::TimeLimit, timeLimitInSeconds);
         }
         if (mSolverConfig.mNumWorkers > 0) {
-            cp.setParameter(IloCP::Workers, mSolverConfig.mNumWorkers);
+            cp.setParameter(IloCP::Workers, mLevelThreadsCount);
         }
         cp.setParameter(IloCP::LogVerbosity, IloCP::Quiet);
         if (cp.solve()) {
             // Solution found, reconstruct start times.
-#ifdef DEBUG
-            printCurrNodeLogPrefix(fixedProcTimesBlocks);
-#endif
-            cout << "New ub (PerformPrimalHeuristicPackToBlocksByCp): " << fixedPermCostComputation.getOptCost() << ", time " << mStopwatch.totalDuration().count() << " ms " << endl;
-            mUsePrimalHeuristicPackToBlocksByCpFoundSolution++;
-
-            mCurrBestObj = fixedPermCostComputation.getOptCost();
-
             vector<int> blockNextStarts;
             for (auto &block : blocks) {
                 blockNextStarts.push_back(block.mStart);
@@ -1053,26 +1430,38 @@ namespace escs {
                         return lhs.second < rhs.second;
                     });
 
-            mCurrBestPermStartTimes = vector<int>();
-            mCurrBestPermProcTimes = vector<int>();
+            vector<int> newPermProcTimes;
+            vector<int> newPermStartTimes;
             if (!mSpecializedSolverConfig.mPrimalHeuristicPackToBlocksByCpAllJobs) {
-                mCurrBestPermProcTimes = this->flatten(fixedProcTimesBlocks);
-                mCurrBestPermStartTimes = this->startTimesFromBlockProcTimes(
+                newPermProcTimes = fixedProcTimes.mProcTimes;
+                newPermStartTimes = this->startTimesFromBlockProcTimes(
                     fixedPermCostComputation.reconstructStartTimes(),
-                     fixedProcTimesBlocks);
+                     fixedProcTimes);
             }
             for (auto &p : remainingProcTimeWithStart) {
-                mCurrBestPermProcTimes.push_back(p.first);
-                mCurrBestPermStartTimes.push_back(p.second);
+                newPermProcTimes.push_back(p.first);
+                newPermStartTimes.push_back(p.second);
+            }
+
+#ifdef DEBUG
+            printCurrNodeLogPrefix(searchThread.mFixedProcTimes);
+#endif
+            // The subtree is solved even if another thread found a better solution meanwhile.
+            if (this->updateCurrBest(
+                    fixedPermCostComputation.getOptCost(),
+                    move(newPermProcTimes),
+                    move(newPermStartTimes),
+                    "PerformPrimalHeuristicPackToBlocksByCp")) {
+                searchThread.mUsePrimalHeuristicPackToBlocksByCpFoundSolution++;
             }
 
             env.end();
-            mPrimalHeuristicPackToBlocksByCpStopwatch.stop();
+            searchThread.mPrimalHeuristicPackToBlocksByCpStopwatch.stop();
             return true;
         }
 
         env.end();
-        mPrimalHeuristicPackToBlocksByCpStopwatch.stop();
+        searchThread.mPrimalHeuristicPackToBlocksByCpStopwatch.stop();
         return false;
     }
 
@@ -1086,7 +1475,11 @@ namespace escs {
             JobsJoiningOnGcd jobsJoiningOnGcd,
             BranchPriority branchPriority,
             optional<chrono::milliseconds> iterativeDeepeningTimeLimit,
-            optional<long long> fullHorizonBabNodesCountLimit)
+            optional<long long> fullHorizonBabNodesCountLimit,
+            int searchThreadsCount,
+            NodeSelection nodeSelection,
+            optional<long long> openNodesMemoryLimitMb,
+            int dominanceMemoCapacity)
             : mUsePrimalHeuristicBlockDetection(usePrimalHeuristicBlockDetection),
                   mUsePrimalHeuristicPackToBlocksByCp(usePrimalHeuristicPackToBlocksByCp),
                   mPrimalHeuristicPackToBlocksByCpAllJobs(primalHeuristicPackToBlocksByCpAllJobs),
@@ -1096,7 +1489,11 @@ namespace escs {
                   mJobsJoiningOnGcd(jobsJoiningOnGcd),
                   mBranchPriority(branchPriority),
                   mIterativeDeepeningTimeLimit(iterativeDeepeningTimeLimit),
-                  mFullHorizonBabNodesCountLimit(fullHorizonBabNodesCountLimit) {
+                  mFullHorizonBabNodesCountLimit(fullHorizonBabNodesCountLimit),
+                  mSearchThreadsCount(searchThreadsCount),
+                  mNodeSelection(nodeSelection),
+                  mOpenNodesMemoryLimitMb(openNodesMemoryLimitMb),
+                  mDominanceMemoCapacity(dominanceMemoCapacity) {
     }
 
     BranchAndBoundOnJob::SpecializedSolverConfig BranchAndBoundOnJob::SpecializedSolverConfig::ReadFromPath(string specializedSolverConfigPath) {
@@ -1138,6 +1535,18 @@ namespace escs {
         long long fullHorizonBabNodesCountLimit;
         stream >> fullHorizonBabNodesCountLimit;
 
+        int searchThreadsCount;
+        stream >> searchThreadsCount;
+
+        int nodeSelection;
+        stream >> nodeSelection;
+
+        long long openNodesMemoryLimitMb;
+        stream >> openNodesMemoryLimitMb;
+
+        int dominanceMemoCapacity;
+        stream >> dominanceMemoCapacity;
+
         return SpecializedSolverConfig(
                 usePrimalHeuristicBlockDetection != 0,
                 usePrimalHeuristicPackToBlocksByCp != 0,
@@ -1148,7 +1557,11 @@ namespace escs {
                 (JobsJoiningOnGcd)jobsJoiningOnGcd,
                 (BranchPriority)branchPriority,
                 iterativeDeepeningTimeLimit,
-                fullHorizonBabNodesCountLimit < 0 ? optional<long long>() : optional<long long>(fullHorizonBabNodesCountLimit));
+                fullHorizonBabNodesCountLimit < 0 ? optional<long long>() : optional<long long>(fullHorizonBabNodesCountLimit),
+                searchThreadsCount,
+                (NodeSelection)nodeSelection,
+                openNodesMemoryLimitMb < 0 ? optional<long long>() : optional<long long>(openNodesMemoryLimitMb),
+                dominanceMemoCapacity);
     }
 
 }
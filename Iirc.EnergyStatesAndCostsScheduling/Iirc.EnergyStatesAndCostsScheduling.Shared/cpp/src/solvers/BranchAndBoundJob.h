@@ -5,12 +5,18 @@
 #ifndef ENERGYSTATESANDCOSTSSCHEDULING_BRANCHANDBOUNDONJOB_H
 #define ENERGYSTATESANDCOSTSSCHEDULING_BRANCHANDBOUNDONJOB_H
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <functional>
+#include <mutex>
 #include "../input/Instance.h"
 #include "SolverConfig.h"
 #include "../utils/Stopwatch.h"
 #include "../datastructs/FixedPermCostComputation.h"
 #include "../datastructs/GcdOfValues.h"
+#include "../datastructs/OpenNodeQueue.h"
+#include "../datastructs/DominanceMemo.h"
 #include "../output/Status.h"
 #include "../output/Result.h"
 #include "../datastructs/Block.h"
@@ -51,6 +57,15 @@ namespace escs {
             DynamicByBlockFitting = 3
         };
 
+        enum NodeSelection
+        {
+            DepthFirst = 0,
+            BestFirst = 1,
+            // Best-first, but the first child of the taken node is searched right away (recursively, i.e., until a
+            // leaf or a pruned node), the other children are kept.
+            BestFirstWithDives = 2
+        };
+
         class SpecializedSolverConfig {
         public:
             const bool mUsePrimalHeuristicBlockDetection;
@@ -63,6 +78,14 @@ namespace escs {
             const BranchPriority mBranchPriority;
             const optional<chrono::milliseconds> mIterativeDeepeningTimeLimit;
             const optional<long long> mFullHorizonBabNodesCountLimit;
+            // Threads searching the tree in parallel (each on its own subtrees), if < 1 then the number of workers.
+            const int mSearchThreadsCount;
+            const NodeSelection mNodeSelection;
+            // The memory of the open nodes of the best-first search, if reached then the children are searched
+            // depth-first until the memory is freed. None if unlimited.
+            const optional<long long> mOpenNodesMemoryLimitMb;
+            // Maximum number of the frontiers of the searched nodes kept for the dominance pruning, 0 disables it.
+            const int mDominanceMemoCapacity;
 
 
             SpecializedSolverConfig(
@@ -75,81 +98,203 @@ namespace escs {
                     JobsJoiningOnGcd jobsJoiningOnGcd,
                     BranchPriority branchPriority,
                     optional<chrono::milliseconds> iterativeDeepeningTimeLimit,
-                    optional<long long> fullHorizonBabNodesCountLimit);
+                    optional<long long> fullHorizonBabNodesCountLimit,
+                    int searchThreadsCount,
+                    NodeSelection nodeSelection,
+                    optional<long long> openNodesMemoryLimitMb,
+                    int dominanceMemoCapacity);
 
             static SpecializedSolverConfig ReadFromPath(string specializedSolverConfigPath);
         };
 
     private:
+        // The fixed proc times of a node grouped into the blocks. Kept as flat stacks (with the total proc time of each
+        // block), so that fixing and unfixing a proc time does not allocate once reserved.
+        struct FixedProcTimes {
+            vector<int> mProcTimes;
+            vector<int> mBlockStarts; // The index of the first proc time of each block.
+            vector<int> mBlockProcTimes; // The total proc time of each block.
+
+            int getCount() const {
+                return mProcTimes.size();
+            }
+
+            int getBlocksCount() const {
+                return mBlockStarts.size();
+            }
+
+            void reserve(int count) {
+                mProcTimes.reserve(count);
+                mBlockStarts.reserve(count);
+                mBlockProcTimes.reserve(count);
+            }
+
+            void clear() {
+                mProcTimes.clear();
+                mBlockStarts.clear();
+                mBlockProcTimes.clear();
+            }
+
+            void push(int procTime, bool joinToLastBlock) {
+                if (!joinToLastBlock || mBlockStarts.empty()) {
+                    mBlockStarts.push_back(mProcTimes.size());
+                    mBlockProcTimes.push_back(0);
+                }
+                mProcTimes.push_back(procTime);
+                mBlockProcTimes.back() += procTime;
+            }
+
+            // Undoes the last push.
+            void pop() {
+                mBlockProcTimes.back() -= mProcTimes.back();
+                mProcTimes.pop_back();
+                if (mBlockStarts.back() == (int)mProcTimes.size()) {
+                    mBlockStarts.pop_back();
+                    mBlockProcTimes.pop_back();
+                }
+            }
+        };
+
+        // An open node of the tree whose subtree is searched by the thread taking it. The cost computation of the
+        // node is reconstructed from its blocks and the gcd of its remaining proc times.
+        struct Subtree {
+            FixedProcTimes mFixedProcTimes;
+            vector<int> mRemainingProcTimeCounts; // By the proc time class.
+            int mRemainingProcTime;
+            int mJoinedGcd;
+            optional<int> mInheritedLowerBound;
+            vector<Block> mRemProcBlocksReversed;
+            bool mJoinToPrevBlock;
+            int mLowerBound; // Of the parent, Instance::NO_VALUE for the root.
+            shared_ptr<const OpenNodeQueue::PathStep> mPath; // Set only if taken from the open nodes.
+        };
+
+        // A thread of the search with its own node state (modified along the search and restored on backtrack). It
+        // searches the subtrees of its deque depth-first and steals the subtrees of the other threads when idle. Its
+        // statistics are summed after the search.
+        struct SearchThread {
+            int mIdx;
+            unique_ptr<FixedPermCostComputation> mFixedPermCostComputation;
+            unique_ptr<FixedPermCostComputation> mFixedBlocksComputation;
+            unique_ptr<GcdOfValues> mGcdOfValues; // The remaining proc times of the current node.
+            unique_ptr<GRBEnv> mEnv; // Created when first needed (nullptr for the first thread, which uses mEnv).
+            mt19937_64 mRandom;
+            uniform_int_distribution<> mRandomBranchPriorityDist;
+
+            // The current node (the remaining proc time counts by the proc time class), modified along the search and
+            // restored on backtrack.
+            FixedProcTimes mFixedProcTimes;
+            vector<int> mRemainingProcTimeCounts;
+
+            // Buffers reused by the nodes: the splits of an unjoined block, the start times of the permutation and the
+            // remaining proc blocks of the nodes computing them (by the depth).
+            vector<int> mSplits;
+            vector<int> mStartTimes;
+            vector<vector<Block>> mRemProcBlocksReversedByDepth;
+
+            // The path steps of the fixed proc times of the current node, created when its child is kept open (only
+            // the prefix up to the first missing step is valid).
+            vector<shared_ptr<const OpenNodeQueue::PathStep>> mPathSteps;
+            // The lower bound of the subtree being searched, Instance::NO_VALUE if none (or unknown for the root).
+            int mSubtreeLowerBound;
+            bool mSearchingSubtree;
+
+            // Buffers of the dominance check of the current node.
+            FixedPermCostComputation::PrefixCheckpoint mFrontier;
+            vector<int> mDominanceKey;
+
+            // The owner takes the subtrees from the back (the deepest), the thieves from the front (the largest).
+            deque<Subtree> mSubtrees;
+            mutex mSubtreesMutex;
+
+            Stopwatch mPrimalHeuristicBlockFindingStopwatch;
+            Stopwatch mPrimalHeuristicBlockDetectionStopwatch;
+            Stopwatch mPrimalHeuristicPackToBlocksByCpStopwatch;
+            long long mPrimalHeuristicBlockDetectionFoundSolution;
+            long long mUsePrimalHeuristicPackToBlocksByCpFoundSolution;
+            long long mJobsJoinedOnLargerGcd;
+        };
+
         void solveInternal();
+        void searchSubtrees(SearchThread &searchThread);
+        bool takeSubtree(SearchThread &searchThread, Subtree &subtree);
+        // If idle, the thread stops being idle before it takes the node (see takeSubtree).
+        bool takeOpenNode(Subtree &subtree, bool idle);
+        // Keeps the child (the current node of the thread) open, returns false if the memory limit is reached.
+        bool storeOpenNode(
+                SearchThread &searchThread,
+                int parentLowerBound,
+                bool lowerBoundInherited,
+                const vector<Block> &remProcBlocksReversed,
+                bool joinToPrevBlock,
+                int joinedGcd);
+        // Whether the node (with computed costs of its fixed blocks) is dominated by a searched node with the same
+        // remaining proc times, otherwise it is recorded.
+        bool isDominated(SearchThread &searchThread, bool joinToPrevBlock);
+        // The least lower bound of the nodes not searched (the incumbent if the search is finished).
+        optional<int> computeGlobalLowerBound() const;
+        void enterSubtree(SearchThread &searchThread, Subtree &subtree);
+        // Searches the current node of the thread. The remaining proc blocks are used (and restored) by the children
+        // inheriting the lower bound.
         void enterNode(
-                vector<vector<int>> &fixedProcTimesBlocks,
-                int fixedProcTimesCount,
-                map<int, int> &remainingProcTimeCounts,
+                SearchThread &searchThread,
                 int remainingProcTime,
-                FixedPermCostComputation &fixedPermCostComputation,
-                GcdOfValues &gcdOfValues,
                 int currJoinedGcd,
                 optional<int> inheritedLowerBound,
-                vector<Block> remProcBlocksReversed,
+                vector<Block> &remProcBlocksReversed,
                 bool joinToPrevBlock);
 
-        vector<int> PerformPrimalHeuristicBlockFinding(const vector<Block> &relaxedBlocks, bool &sameAsRelaxedBlocks);
+        vector<int> PerformPrimalHeuristicBlockFinding(
+                SearchThread &searchThread,
+                const vector<Block> &relaxedBlocks,
+                bool &sameAsRelaxedBlocks);
 
-        bool PerformPrimalHeuristicBlockDetection(
-                vector<vector<int>> &fixedProcTimesBlocks,
-                map<int, int> &remainingProcTimeCounts,
-                int remainingProcTime,
-                FixedPermCostComputation &fixedPermCostComputation);
+        bool PerformPrimalHeuristicBlockDetection(SearchThread &searchThread, int remainingProcTime);
 
-        bool PerformPrimalHeuristicPackToBlocksByCp(
-                vector<vector<int>> &fixedProcTimesBlocks,
-                map<int, int> &remainingProcTimeCounts,
-                int remainingProcTime,
-                FixedPermCostComputation &fixedPermCostComputation);
+        bool PerformPrimalHeuristicPackToBlocksByCp(SearchThread &searchThread, int remainingProcTime);
+
+        // Sets the incumbent if obj is better than the current one (which may be improved by another thread
+        // meanwhile), returns true if set.
+        bool updateCurrBest(
+                int obj,
+                vector<int> permProcTimes,
+                vector<int> permStartTimes,
+                const string &foundBy);
 
-        void printCurrNodeLogPrefix(const vector<vector<int>> &fixedProcTimesBlocks) const {
+        optional<int> getCurrBestObj() const {
+            int currBestObj = mCurrBestObj.load();
+            return currBestObj != Instance::NO_VALUE ? optional<int>(currBestObj) : optional<int>();
+        }
+
+        void printCurrNodeLogPrefix(const FixedProcTimes &fixedProcTimes) const {
             string nodeId;
-            int fixedProcTimesCount = 0;
-            for (int i = 0; i < (int)fixedProcTimesBlocks.size(); i++) {
-                if (i > 0) {
+            for (int i = 0; i < fixedProcTimes.getCount(); i++) {
+                if (i > 0 && binary_search(fixedProcTimes.mBlockStarts.begin(), fixedProcTimes.mBlockStarts.end(), i)) {
                     nodeId += "_ ";
                 }
-                auto &procTimesBlock = fixedProcTimesBlocks[i];
-                for (int p : procTimesBlock) {
-                    nodeId += to_string(p);
-                    nodeId += " ";
-                    fixedProcTimesCount++;
-                }
+                nodeId += to_string(fixedProcTimes.mProcTimes[i]);
+                nodeId += " ";
             }
             cout << left << setw(15) << nodeId << " | ";
-            for (int i = 0; i < fixedProcTimesCount; i++) {
+            for (int i = 0; i < fixedProcTimes.getCount(); i++) {
                 (void)i;
                 cout << "-- ";
             }
         }
 
-        vector<int> flatten(const vector<vector<int>> &xss) const {
-            vector<int> result;
-            for (auto &xs : xss) {
-                for (auto x : xs) {
-                    result.push_back(x);
-                }
-            }
-
-            return result;
-        }
-
         vector<int> startTimesFromBlockProcTimes(
                 const vector<int> &blockStartTimes,
-                const vector<vector<int>> &procTimeBlocks) const {
+                const FixedProcTimes &fixedProcTimes) const {
             vector<int> startTimes;
             int nextStartTime = 0;
-            for (int i = 0; i < (int)procTimeBlocks.size(); i++) {
-                nextStartTime = blockStartTimes[i];
-                for (int procTime : procTimeBlocks[i]) {
+            for (int blockIdx = 0; blockIdx < fixedProcTimes.getBlocksCount(); blockIdx++) {
+                nextStartTime = blockStartTimes[blockIdx];
+                int blockEnd = blockIdx + 1 < fixedProcTimes.getBlocksCount()
+                        ? fixedProcTimes.mBlockStarts[blockIdx + 1]
+                        : fixedProcTimes.getCount();
+                for (int i = fixedProcTimes.mBlockStarts[blockIdx]; i < blockEnd; i++) {
                     startTimes.push_back(nextStartTime);
-                    nextStartTime += procTime;
+                    nextStartTime += fixedProcTimes.mProcTimes[i];
                 }
             }
 
@@ -161,34 +306,50 @@ namespace escs {
         SolverConfig &mSolverConfig;
         const SpecializedSolverConfig &mSpecializedSolverConfig;
         Stopwatch mStopwatch;
-        Stopwatch mPrimalHeuristicBlockFindingStopwatch;
-        Stopwatch mPrimalHeuristicBlockDetectionStopwatch;
-        Stopwatch mPrimalHeuristicPackToBlocksByCpStopwatch;
         const GRBEnv mEnv;
 
         Status mStatus;
-        optional<int> mCurrBestObj;
+        // The objective of the incumbent (Instance::NO_VALUE if none), read at every node without a lock. A thread
+        // improving it swaps the objective atomically, then sets the permutation under mCurrBestMutex.
+        atomic<int> mCurrBestObj;
         vector<int> mCurrBestPermProcTimes;
         vector<int> mCurrBestPermStartTimes;
+        mutex mCurrBestMutex;
+
+        int mSearchThreadsCount;
+        int mLevelThreadsCount;
+        vector<unique_ptr<SearchThread>> mSearchThreads;
+        atomic<int> mIdleSearchThreadsCount;
+        atomic<bool> mSearchFinished;
+
+        // The distinct proc times of the jobs (the proc time classes, ascending), the classes by the proc time and the
+        // counts of the jobs by the class.
+        vector<int> mProcTimeClasses;
+        vector<int> mProcTimeClassIds;
+        vector<int> mProcTimeCounts;
+
+        // The open nodes of the best-first search (shared by the search threads).
+        unique_ptr<OpenNodeQueue> mOpenNodes;
+        mutex mOpenNodesMutex;
+
+        unique_ptr<DominanceMemo> mDominanceMemo;
 
         chrono::milliseconds mLowerBoundTotalDuration;
         chrono::milliseconds mPrimalHeuristicBlockFindingTotalDuration;
         chrono::milliseconds mPrimalHeuristicBlockDetectionTotalDuration;
         chrono::milliseconds mPrimalHeuristicPackToBlocksByCpTotalDuration;
+        bool mMongeTransitionKernelUsed;
 
-        uniform_int_distribution<> mRandomBranchPriorityDist;
-
-        std::unique_ptr<FixedPermCostComputation> mFixedBlocksComputation;
-
-        // Statistics.
-        long long mNodesCount;
-        long long mCurrNode;
+        // Statistics (summed over the search threads after the search, except for the nodes count, which is limited).
+        atomic<long long> mNodesCount;
         long long mPrimalHeuristicBlockDetectionFoundSolution;
         long long mUsePrimalHeuristicPackToBlocksByCpFoundSolution;
         long long mJobsJoinedOnLargerGcd;
         int mRootLowerBound;
+        optional<int> mGlobalLowerBound;
+        optional<long long> mDominatedNodesCount;
 
-        bool mNodesCountLimitReached;
+        atomic<bool> mNodesCountLimitReached;
 
         bool stopSearching() const {
             return mNodesCountLimitReached || mStopwatch.timeLimitReached(mSolverConfig.mTimeLimit);
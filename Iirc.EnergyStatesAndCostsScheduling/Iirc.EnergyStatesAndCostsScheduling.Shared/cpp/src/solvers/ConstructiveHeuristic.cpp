@@ -10,6 +10,7 @@
 #include "SolverConfig.h"
 #include "ConstructiveHeuristic.h"
 #include "../datastructs/FixedPermCostComputation.h"
+#include "../datastructs/BidirectionalPermCostComputation.h"
 #include "../datastructs/GcdOfValues.h"
 #include "../datastructs/Block.h"
 #include "../algorithms/PackToBlocksByCp.h"
@@ -17,6 +18,8 @@
 using namespace std;
 using namespace escs;
 
+// Left out when the solver is linked into the tests.
+#ifndef NO_SOLVER_MAIN
 int main(int /*argc*/, char **argv) {
     cout << "In cpp" << endl;
 
@@ -39,6 +42,7 @@ int main(int /*argc*/, char **argv) {
 
     return 0;
 }
+#endif
 
 namespace escs {
     ConstructiveHeuristic::ConstructiveHeuristic(
@@ -68,12 +72,23 @@ namespace escs {
         mProcTimesPerm = vector<int>();
         mStartTimesPerm = vector<int>();
         mObj = optional<int>();
+        mMongeTransitionKernelUsed = false;
 
         if (mSolverConfig.mNumWorkers >= 1) {
             // Currently, only FixedPermCostComputation runs in parallel and uses OpenMP.
             omp_set_num_threads(mSolverConfig.mNumWorkers);
         }
 
+        mInsertionCostComputation.reset(new BidirectionalPermCostComputation(
+                mInstance.getTotalProcTime(),
+                mInstance.mIntervals.size(),
+                mInstance.mEarliestOnIntervalIdx,
+                mInstance.mLatestOnIntervalIdx,
+                mInstance.mFullOptimalSwitchingCostsTables,
+                vector<bool>(mInstance.mIntervals.size(), true),
+                mInstance.mFullOptimalSwitchingCostsGraph.get(),
+                mSolverConfig.mUseMongeTransitions ? mInstance.mFullOptimalSwitchingCostsMonge.get() : nullptr));
+
         switch (mSpecializedSolverConfig.mAlgorithm) {
             case AllPositions:
                 algorithmAllPositions();
@@ -87,71 +102,7 @@ namespace escs {
     }
 
     vector<int> ConstructiveHeuristic::getProcessingTimesOrdering() {
-        vector<int> processingTimes;
-        for (auto &pJob : mInstance.mJobs) {
-            processingTimes.push_back(pJob->mProcessingTime);
-        }
-
-        switch (mSpecializedSolverConfig.mJobsOrdering) {
-            case Random:
-                shuffle(processingTimes.begin(), processingTimes.end(), mSolverConfig.mRandom);
-                break;
-
-            case LongestProcessingTimeFirst:
-                sort(processingTimes.begin(), processingTimes.end());
-                reverse(processingTimes.begin(), processingTimes.end());
-                break;
-
-            case ShortestProcessingTimeFirst:
-                sort(processingTimes.begin(), processingTimes.end());
-                break;
-
-            case AlternateShortestLongestProcessingTime:
-                {
-                    sort(processingTimes.begin(), processingTimes.end());
-                    vector<int> newProcessingTimes;
-                    int left = 0;
-                    int right = (int)processingTimes.size() - 1;
-                    while (left <= right) {
-                        newProcessingTimes.push_back(processingTimes[left]);
-                        if (left < right) {
-                            newProcessingTimes.push_back(processingTimes[right]);
-                        }
-
-                        left++;
-                        right--;
-                    }
-
-                    processingTimes = newProcessingTimes;
-                }
-                break;
-
-            case AlternateHalvesShortLongProcessingTime:
-                {
-                    sort(processingTimes.begin(), processingTimes.end());
-                    vector<int> newProcessingTimes;
-                    int half = processingTimes.size() / 2;
-                    int left = 0;
-                    int right = half;
-                    while (left < half || right < (int)processingTimes.size()) {
-                        if (left < half) {
-                            newProcessingTimes.push_back(processingTimes[left]);
-                        }
-
-                        if (right < (int)processingTimes.size()) {
-                            newProcessingTimes.push_back(processingTimes[right]);
-                        }
-
-                        left++;
-                        right++;
-                    }
-
-                    processingTimes = newProcessingTimes;
-                }
-                break;
-        }
-
-        return processingTimes;
+        return ProcessingTimesOrdering::create(mInstance, mSpecializedSolverConfig.mJobsOrdering, mSolverConfig.mRandom);
     }
 
     void ConstructiveHeuristic::algorithmAllPositions() {
@@ -166,30 +117,8 @@ namespace escs {
                 continue;
             }
 
-            optional<int> bestPosition;
-            optional<int> bestCost;
-            for (int insertPosition = 0; insertPosition <= (int)currProcTimesPerm.size(); insertPosition++) {
-                // Symmetry breaking on equal processing times.
-                if (insertPosition > 0 && currProcTimesPerm[insertPosition - 1] == procTimeToInsert) {
-                    continue;
-                }
-
-                auto procTimesWithInsertion = currProcTimesPerm;
-                procTimesWithInsertion.insert(procTimesWithInsertion.begin() + insertPosition, procTimeToInsert);
-
-                auto [cost, _] = computeObjective(
-                        mInstance,
-                        procTimesWithInsertion);
-
-                if (cost.has_value()) {
-                    if (!bestCost.has_value() || (cost.value() < bestCost.value())) {
-                        bestPosition = insertPosition;
-                        bestCost = cost;
-                    }
-                }
-            }
-
-            if (!bestCost.has_value()) {
+            auto bestPosition = findBestInsertionPosition(currProcTimesPerm, procTimeToInsert, true);
+            if (!bestPosition.has_value()) {
                 // Cannot find solution with the current partial permutation.
                 cout << "Cannot find solution" << endl;
                 return;
@@ -219,25 +148,8 @@ namespace escs {
                 continue;
             }
 
-            optional<int> bestPosition;
-            optional<int> bestCost;
-            for (int insertPosition = 0; insertPosition <= (int)currBlocksPerm.size(); insertPosition++) {
-                auto procTimesWithInsertion = currBlocksPerm;
-                procTimesWithInsertion.insert(procTimesWithInsertion.begin() + insertPosition, procTimeToInsert);
-
-                auto [cost, _] = computeObjective(
-                        mInstance,
-                        procTimesWithInsertion);
-
-                if (cost.has_value()) {
-                    if (!bestCost.has_value() || (cost.value() < bestCost.value())) {
-                        bestPosition = insertPosition;
-                        bestCost = cost;
-                    }
-                }
-            }
-
-            if (!bestCost.has_value()) {
+            auto bestPosition = findBestInsertionPosition(currBlocksPerm, procTimeToInsert, false);
+            if (!bestPosition.has_value()) {
                 // Cannot find solution with the current partial permutation.
                 cout << "Cannot find solution" << endl;
                 return;
@@ -270,6 +182,35 @@ namespace escs {
         mObj = cost;
     }
 
+    optional<int> ConstructiveHeuristic::findBestInsertionPosition(
+            const vector<int> &procTimesPerm,
+            int procTimeToInsert,
+            bool skipEqualProcTimes) {
+        // Only the prefix and suffix costs changed by the previous insertion are recomputed, then each insertion
+        // position costs a single transition and a join.
+        mInsertionCostComputation->setPermutation(procTimesPerm);
+
+        optional<int> bestPosition;
+        optional<int> bestCost;
+        for (int insertPosition = 0; insertPosition <= (int)procTimesPerm.size(); insertPosition++) {
+            // Symmetry breaking on equal processing times.
+            if (skipEqualProcTimes && insertPosition > 0 && procTimesPerm[insertPosition - 1] == procTimeToInsert) {
+                continue;
+            }
+
+            int cost = mInsertionCostComputation->computeInsertionCost(insertPosition, procTimeToInsert);
+            if (cost != Instance::NO_VALUE) {
+                if (!bestCost.has_value() || (cost < bestCost.value())) {
+                    bestPosition = insertPosition;
+                    bestCost = cost;
+                }
+            }
+        }
+
+        mMongeTransitionKernelUsed |= mInsertionCostComputation->getMongeTransitionsCount() > 0;
+        return bestPosition;
+    }
+
     pair<optional<int>, vector<int>> ConstructiveHeuristic::computeObjective(
             const Instance &instance,
             vector<int> procTimes) {
@@ -283,16 +224,17 @@ namespace escs {
                 instance.mIntervals.size(),
                 instance.mEarliestOnIntervalIdx,
                 instance.mLatestOnIntervalIdx,
-                instance.mOnPowerConsumption,
-                instance.mFullOptimalSwitchingCosts,
-                instance.mCumulativeEnergyCost,
-                vector<bool>(instance.mIntervals.size(), true));
+                instance.mFullOptimalSwitchingCostsTables,
+                vector<bool>(instance.mIntervals.size(), true),
+                instance.mFullOptimalSwitchingCostsGraph.get(),
+                mSolverConfig.mUseMongeTransitions ? instance.mFullOptimalSwitchingCostsMonge.get() : nullptr);
 
         for (int position = 0; position < (int)procTimes.size(); position++) {
             costComputation.join(position, procTimes[position]);
         }
 
         int cost = costComputation.recomputeCost();
+        mMongeTransitionKernelUsed |= costComputation.getMongeTransitionsCount() > 0;
         if (cost == Instance::NO_VALUE) {
             return make_pair(optional<int>(), vector<int>());
         }
@@ -330,7 +272,8 @@ namespace escs {
                 mStatus,
                 mStopwatch.timeLimitReached(mSolverConfig.mTimeLimit),
                 mObj,
-                getStartTimes());
+                getStartTimes())
+                .setMongeTransitionKernelUsed(mMongeTransitionKernelUsed);
     }
 
     ConstructiveHeuristic::SpecializedSolverConfig::SpecializedSolverConfig(
@@ -9,9 +9,11 @@
 #include "SolverConfig.h"
 #include "../utils/Stopwatch.h"
 #include "../datastructs/FixedPermCostComputation.h"
+#include "../datastructs/BidirectionalPermCostComputation.h"
 #include "../datastructs/GcdOfValues.h"
 #include "../output/Status.h"
 #include "../output/Result.h"
+#include "../algorithms/ProcessingTimesOrdering.h"
 
 using namespace std;
 
@@ -27,14 +29,7 @@ namespace escs {
             AllPositionsWithBlockKeeping = 2
         };
 
-        enum JobsOrdering
-        {
-            Random = 0,
-            ShortestProcessingTimeFirst = 1,
-            LongestProcessingTimeFirst = 2,
-            AlternateShortestLongestProcessingTime = 3,
-            AlternateHalvesShortLongProcessingTime = 4
-        };
+        typedef ProcessingTimesOrdering::OrderingStrategy JobsOrdering;
 
         class SpecializedSolverConfig {
         public:
@@ -56,6 +51,13 @@ namespace escs {
         void algorithmAllPositionsWithBlockKeeping();
         vector<int> getProcessingTimesOrdering();
 
+        // The position minimizing the cost of the permutation with the proc time inserted, none if no insertion is
+        // feasible. If skipEqualProcTimes, the positions right after an equal proc time are skipped (symmetric).
+        optional<int> findBestInsertionPosition(
+                const vector<int> &procTimesPerm,
+                int procTimeToInsert,
+                bool skipEqualProcTimes);
+
         pair<optional<int>, vector<int>> computeObjective(
                 const Instance &instance,
                 vector<int> procTimes);
@@ -70,6 +72,10 @@ namespace escs {
         vector<int> mProcTimesPerm;
         vector<int> mStartTimesPerm;
         optional<int> mObj;
+        bool mMongeTransitionKernelUsed;
+
+        // Scores all the insertion positions of an iteration from the prefix and suffix costs of the permutation.
+        unique_ptr<BidirectionalPermCostComputation> mInsertionCostComputation;
 
     public:
         ConstructiveHeuristic(
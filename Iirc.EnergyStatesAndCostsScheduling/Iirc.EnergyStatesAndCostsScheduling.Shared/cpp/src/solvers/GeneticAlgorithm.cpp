@@ -11,6 +11,8 @@
 using namespace std;
 using namespace escs;
 
+// Left out when the solver is linked into the tests.
+#ifndef NO_SOLVER_MAIN
 int main(int /*argc*/, char **argv) {
     cout << "In cpp" << endl;
 
@@ -36,25 +38,145 @@ int main(int /*argc*/, char **argv) {
     return 0;
 
 }
+#endif
 
 namespace escs {
+    namespace {
+        // The regular grid of the checkpoints of an evaluated solution, see mCheckpointPositions.
+        const int CHECKPOINTS_GRID_COUNT = 8;
+
+        // Scratch of the crossovers, the remaining jobs per class (see mProcTimeClassIds). Per thread, since the
+        // operators run on the threads of the population concurrently.
+        thread_local vector<int> remainingClassJobsCountsTmp;
+        // Scratch of the block insertion, the changed positions of a candidate move.
+        thread_local vector<int> movedProcTimesTmp;
+    }
+
     GeneticAlgorithm::GeneticAlgorithm(
             const Instance &instance,
             SolverConfig &solverConfig,
             const SpecializedSolverConfig &specializedSolverConfig) :
                 mInstance(instance),
                 mSolverConfig(solverConfig),
-                mSpecializedSolverConfig(specializedSolverConfig) {
+                mSpecializedSolverConfig(specializedSolverConfig),
+                mWorstKeptCosts() {
+
+        int workersCount = mSolverConfig.mNumWorkers >= 1
+                ? mSolverConfig.mNumWorkers
+                : max(1, (int)thread::hardware_concurrency());
+        mIslandsCount = max(1, mSpecializedSolverConfig.mIslandsCount);
+        mPopulationThreadsCount = mSpecializedSolverConfig.mPopulationThreadsCount >= 1
+                ? mSpecializedSolverConfig.mPopulationThreadsCount
+                : max(1, workersCount / mIslandsCount);
+        mLevelThreadsCount = mSpecializedSolverConfig.mLevelThreadsCount >= 1
+                ? mSpecializedSolverConfig.mLevelThreadsCount
+                : max(1, workersCount / (mIslandsCount * mPopulationThreadsCount));
+
+        // The last position is always in the relaxed suffix, its costs are not computed.
+        int positionsCount = mInstance.mJobs.size();
+        set<int> checkpointPositions;
+        for (int gridIdx = 1; gridIdx < CHECKPOINTS_GRID_COUNT; gridIdx++) {
+            checkpointPositions.insert(gridIdx * positionsCount / CHECKPOINTS_GRID_COUNT - 1);
+        }
+        for (int tailPositionsCount = positionsCount / 2; tailPositionsCount >= 1; tailPositionsCount /= 2) {
+            checkpointPositions.insert(positionsCount - tailPositionsCount - 1);
+        }
+        for (int position : checkpointPositions) {
+            if (position >= 0 && position <= positionsCount - 2) {
+                mCheckpointPositions.push_back(position);
+            }
+        }
+
+        for (int threadIdx = 0; threadIdx < mIslandsCount * mPopulationThreadsCount; threadIdx++) {
+            mFixedPermCostComputations.emplace_back(new FixedPermCostComputation(
+                    mInstance.getTotalProcTime(),
+                    mInstance.mIntervals.size(),
+                    mInstance.mEarliestOnIntervalIdx,
+                    mInstance.mLatestOnIntervalIdx,
+                    mInstance.mFullOptimalSwitchingCostsTables,
+                    vector<bool>(mInstance.mIntervals.size(), true),
+                    mInstance.mFullOptimalSwitchingCostsGraph.get(),
+                    mSolverConfig.mUseMongeTransitions ? mInstance.mFullOptimalSwitchingCostsMonge.get() : nullptr));
+
+            // The start times are needed only for the best solution at the end, the costs of the checkpoint positions
+            // are kept for the prefix trie.
+            mFixedPermCostComputations.back()->setCostOnly(true, mCheckpointPositions);
+            mIdleFixedPermCostComputations.push_back(mFixedPermCostComputations.back().get());
+
+            if (mSpecializedSolverConfig.mMutationCandidatesCount >= 2) {
+                mMoveCostComputations.emplace_back(new BidirectionalPermCostComputation(
+                        mInstance.getTotalProcTime(),
+                        mInstance.mIntervals.size(),
+                        mInstance.mEarliestOnIntervalIdx,
+                        mInstance.mLatestOnIntervalIdx,
+                        mInstance.mFullOptimalSwitchingCostsTables,
+                        vector<bool>(mInstance.mIntervals.size(), true),
+                        mInstance.mFullOptimalSwitchingCostsGraph.get(),
+                        mSolverConfig.mUseMongeTransitions
+                                ? mInstance.mFullOptimalSwitchingCostsMonge.get()
+                                : nullptr));
+                mIdleMoveCostComputations.push_back(mMoveCostComputations.back().get());
+            }
+        }
+
+        int maxProcTime = 0;
+        map<int, int> jobsCountsByProcTime;
+        for (auto *pJob : mInstance.mJobs) {
+            maxProcTime = max(maxProcTime, pJob->mProcessingTime);
+            jobsCountsByProcTime[pJob->mProcessingTime]++;
+        }
+        mProcTimeClassIds = vector<int>(maxProcTime + 1, -1);
+        for (auto &procTimeJobsCount : jobsCountsByProcTime) {
+            mProcTimeClassIds[procTimeJobsCount.first] = mClassJobsCounts.size();
+            mClassJobsCounts.push_back(procTimeJobsCount.second);
+        }
+
+        if (mSpecializedSolverConfig.mCostCacheCapacity >= 1) {
+            // Several shards per population thread, so that the threads rarely wait for each other.
+            mCostCache.reset(new PermutationCostCache(
+                    mSpecializedSolverConfig.mCostCacheCapacity,
+                    4 * mIslandsCount * mPopulationThreadsCount));
+        }
+    }
+
+    FixedPermCostComputation *GeneticAlgorithm::AcquireCostComputation() {
+        lock_guard<mutex> lock(mIdleFixedPermCostComputationsMutex);
+        if (mIdleFixedPermCostComputations.empty()) {
+            throw logic_error("More concurrent evaluations than population threads.");
+        }
+
+        auto *pCostComputation = mIdleFixedPermCostComputations.back();
+        mIdleFixedPermCostComputations.pop_back();
+        return pCostComputation;
+    }
+
+    void GeneticAlgorithm::ReleaseCostComputation(FixedPermCostComputation *pCostComputation) {
+        lock_guard<mutex> lock(mIdleFixedPermCostComputationsMutex);
+        mIdleFixedPermCostComputations.push_back(pCostComputation);
+    }
+
+    BidirectionalPermCostComputation *GeneticAlgorithm::AcquireMoveCostComputation() {
+        if (mMoveCostComputations.empty()) {
+            return nullptr;
+        }
+
+        lock_guard<mutex> lock(mIdleMoveCostComputationsMutex);
+        if (mIdleMoveCostComputations.empty()) {
+            throw logic_error("More concurrent mutations than population threads.");
+        }
+
+        auto *pMoveCostComputation = mIdleMoveCostComputations.back();
+        mIdleMoveCostComputations.pop_back();
+        return pMoveCostComputation;
+    }
+
+    void GeneticAlgorithm::ReleaseMoveCostComputation(BidirectionalPermCostComputation *pMoveCostComputation) {
+        if (pMoveCostComputation == nullptr) {
+            return;
+        }
 
-        mFixedPermCostComputation.reset(new FixedPermCostComputation(
-                mInstance.getTotalProcTime(),
-                mInstance.mIntervals.size(),
-                mInstance.mEarliestOnIntervalIdx,
-                mInstance.mLatestOnIntervalIdx,
-                mInstance.mOnPowerConsumption,
-                mInstance.mFullOptimalSwitchingCosts,
-                mInstance.mCumulativeEnergyCost,
-                vector<bool>(mInstance.mIntervals.size(), true)));
+        lock_guard<mutex> lock(mIdleMoveCostComputationsMutex);
+        mIdleMoveCostComputations.push_back(pMoveCostComputation);
     }
 
     Status GeneticAlgorithm::solve() {
@@ -77,17 +199,55 @@ namespace escs {
         mProcTimesPerm = vector<int>();
         mStartTimesPerm = vector<int>();
         mObj = optional<int>();
+        mWorstKeptCosts = vector<atomic<int>>(mIslandsCount);
+        for (auto &worstKeptCost : mWorstKeptCosts) {
+            worstKeptCost.store(Instance::NO_VALUE);
+        }
+        mMigrants = vector<vector<GA_Type::thisChromosomeType>>(mIslandsCount);
+
+        // Each island has its own random generator, drawn in the order of the islands.
+        vector<mt19937_64> islandRandoms;
+        for (int islandIdx = 0; islandIdx < mIslandsCount; islandIdx++) {
+            islandRandoms.emplace_back(islandIdx == 0 ? mSolverConfig.mRandom : mt19937_64(mSolverConfig.mRandom()));
+        }
 
-        if (mSolverConfig.mNumWorkers >= 1) {
-            // Currently, only FixedPermCostComputation runs in parallel and uses OpenMP.
-            omp_set_num_threads(mSolverConfig.mNumWorkers);
+        // The final objective is computed on this thread.
+        omp_set_num_threads(mLevelThreadsCount);
+        if (mIslandsCount == 1) {
+            SolveIsland(0, islandRandoms[0]);
         }
+        else {
+            vector<thread> islandThreads;
+            for (int islandIdx = 0; islandIdx < mIslandsCount; islandIdx++) {
+                islandThreads.emplace_back([this, islandIdx, &islandRandoms]() {
+                    SolveIsland(islandIdx, islandRandoms[islandIdx]);
+                });
+            }
 
-        GA_Type ga_obj(mSolverConfig.mRandom, mSolverConfig.mTimeLimit);
+            for (auto &islandThread : islandThreads) {
+                islandThread.join();
+            }
+        }
+
+        if (mObj.has_value()) {
+            mStartTimesPerm = ComputeObjective(mProcTimesPerm).second;
+        }
+    }
+
+    void GeneticAlgorithm::SolveIsland(int islandIdx, mt19937_64 random) {
+        // The workers are split between the islands, the evaluations of the chromosomes of an island and the levels of
+        // FixedPermCostComputation (OpenMP).
+        omp_set_num_threads(mLevelThreadsCount);
+
+        auto seeds = CreateSeeds(islandIdx, random);
+
+        GA_Type ga_obj(random, mSolverConfig.mTimeLimit);
         ga_obj.problem_mode= EA::GA_MODE::SOGA;
-        ga_obj.multi_threading = false;
+        ga_obj.multi_threading = mPopulationThreadsCount > 1;
+        ga_obj.N_threads = mPopulationThreadsCount;
         ga_obj.verbose = false;
         ga_obj.population = mSpecializedSolverConfig.mPopulationSize;
+        ga_obj.user_initial_solutions = move(seeds);
         ga_obj.generation_max = mSpecializedSolverConfig.mGenerationsCount;
         ga_obj.calculate_SO_total_fitness = [&](auto &X) {
             return CalculateFitness(X);
@@ -95,10 +255,17 @@ namespace escs {
         ga_obj.init_genes = [&](auto &solution, auto &rnd01) {
             InitGenes(solution, rnd01);
         };
+        ga_obj.init_worker = [&](int /*worker*/) {
+            // The threads of the population do not inherit the number of OpenMP threads of the island thread.
+            omp_set_num_threads(mLevelThreadsCount);
+        };
         ga_obj.eval_solution = [&](auto &solution, auto &cost) {
-            return EvalSolution(solution, cost);
+            return EvalSolution(islandIdx, solution, cost);
         };
-        ga_obj.mutate = [&](auto &baseSolution, auto &rnd01, auto shrinkScale) {
+        ga_obj.eval_solution_batch = [&](auto &solutions, auto &costs, auto &accepted) {
+            EvalSolutions(islandIdx, solutions, costs, accepted);
+        };
+        ga_obj.mutate = [&](auto baseSolution, auto &rnd01, auto shrinkScale) {
             auto mutationStrategy = this->mSpecializedSolverConfig.mMutationStrategy;
 
             if (mutationStrategy == SelectStrategyRandomly) {
@@ -112,15 +279,18 @@ namespace escs {
 
             switch (mutationStrategy) {
                 case Swap:
-                    return MutateSwap(baseSolution, rnd01, shrinkScale);
+                    return MutateSwap(move(baseSolution), rnd01, shrinkScale);
                 case BlockInsertion:
-                    return MutateBlockInsertion(baseSolution, rnd01, shrinkScale);
+                    return MutateBlockInsertion(move(baseSolution), rnd01, shrinkScale);
                 case SwapDiffProcTimes:
-                    return MutateSwapDiffProcTimes(baseSolution, rnd01, shrinkScale);
+                    return MutateSwapDiffProcTimes(move(baseSolution), rnd01, shrinkScale);
                 default:
                     throw logic_error("No mutation strategy specified.");
             }
         };
+        ga_obj.recycle_genes = [&](auto &&solution) {
+            RecycleSolution(move(solution));
+        };
         ga_obj.crossover = [&](auto &parent1, auto &parent2, auto &rnd01) {
             switch (this->mSpecializedSolverConfig.mCrossoverStrategy) {
                 case Sequential:
@@ -132,17 +302,57 @@ namespace escs {
             }
         };
         ga_obj.SO_report_generation= [&](auto generationNumber, auto &lastGeneration, auto &bestSolution) {
-            ReportGeneration(generationNumber, lastGeneration, bestSolution);
+            ReportGeneration(islandIdx, generationNumber, lastGeneration, bestSolution);
         };
+        if (mIslandsCount > 1 && mSpecializedSolverConfig.mMigrationInterval >= 1
+            && mSpecializedSolverConfig.mMigrantsCount >= 1) {
+            ga_obj.migration_interval = mSpecializedSolverConfig.mMigrationInterval;
+            ga_obj.SO_migrate = [&](auto /*generationNumber*/, auto &lastGeneration) {
+                Migrate(islandIdx, lastGeneration);
+            };
+        }
         ga_obj.best_stall_max = mSpecializedSolverConfig.mBestStallMax;
         ga_obj.average_stall_max = mSpecializedSolverConfig.mAverageStallMax;
         ga_obj.elite_count = mSpecializedSolverConfig.mEliteCount;
         ga_obj.crossover_fraction = mSpecializedSolverConfig.mCrossoverFraction;
         ga_obj.mutation_rate = mSpecializedSolverConfig.mMutationRate;
-        ga_obj.solve();
+        if (mSpecializedSolverConfig.mSteadyState) {
+            ga_obj.solve_steady_state();
+        }
+        else {
+            ga_obj.solve();
+        }
+    }
 
-        if (mObj.has_value()) {
-            mStartTimesPerm = ComputeObjective(mProcTimesPerm).second;
+    void GeneticAlgorithm::Migrate(int islandIdx, Generation_Type &generation) {
+        // The best chromosomes emigrate to the next island of the ring, the immigrants from the previous island replace
+        // the worst ones if better. The islands do not wait for each other: an island takes the last emigrants of its
+        // predecessor (if any since its last migration).
+        vector<GA_Type::thisChromosomeType> immigrants;
+        {
+            lock_guard<mutex> lock(mMigrantsMutex);
+            immigrants = move(mMigrants[islandIdx]);
+            mMigrants[islandIdx].clear();
+
+            auto &emigrants = mMigrants[(islandIdx + 1) % mIslandsCount];
+            emigrants.clear();
+            int emigrantsCount = min(mSpecializedSolverConfig.mMigrantsCount, (int)generation.sorted_indices.size());
+            for (int rank = 0; rank < emigrantsCount; rank++) {
+                emigrants.push_back(generation.chromosomes[generation.sorted_indices[rank]]);
+            }
+        }
+
+        int worstRank = (int)generation.sorted_indices.size() - 1;
+        for (auto &immigrant : immigrants) {
+            if (worstRank < 0) {
+                break;
+            }
+
+            auto &worstChromosome = generation.chromosomes[generation.sorted_indices[worstRank]];
+            if (immigrant.total_cost < worstChromosome.total_cost) {
+                worstChromosome = immigrant;
+                worstRank--;
+            }
         }
     }
 
@@ -171,53 +381,315 @@ namespace escs {
     }
 
     Result GeneticAlgorithm::GetResult() const {
-        return Result(
+        bool mongeTransitionKernelUsed = false;
+        for (auto &pCostComputation : mFixedPermCostComputations) {
+            mongeTransitionKernelUsed |= pCostComputation->getMongeTransitionsCount() > 0;
+        }
+
+        auto result = Result(
                 mStatus,
                 mStopwatch.timeLimitReached(mSolverConfig.mTimeLimit),
                 mObj,
                 GetStartTimes());
+        result.setMongeTransitionKernelUsed(mongeTransitionKernelUsed);
+        if (mCostCache) {
+            result.setCostCacheCounts(mCostCache->getHitsCount(), mCostCache->getMissesCount());
+        }
+
+        return result;
     }
 
     pair<optional<int>, vector<int>> GeneticAlgorithm::ComputeObjective(const vector<int> &procTimes) {
         // TODO: gcd? probably at the beginning?
 
-        for (int position = 0; position < (int)procTimes.size(); position++) {
-            mFixedPermCostComputation->join(position, procTimes[position]);
-        }
-
-        int cost = mFixedPermCostComputation->recomputeCost();
+        auto *pCostComputation = AcquireCostComputation();
+        auto costWithStartTimes = move(pCostComputation->computeCostsWithStartTimes({procTimes}).front());
         auto result = make_pair(optional<int>(), vector<int>());
-        if (cost != Instance::NO_VALUE) {
-            result = make_pair(optional<int>(cost), mFixedPermCostComputation->reconstructStartTimes());
+        if (costWithStartTimes.first != Instance::NO_VALUE) {
+            result = make_pair(optional<int>(costWithStartTimes.first), move(costWithStartTimes.second));
         }
 
-        mFixedPermCostComputation->setProcTimes(0, 1);
+        ReleaseCostComputation(pCostComputation);
 
         return result;
     }
 
+    const FixedPermCostComputation::PrefixCheckpoint *GeneticAlgorithm::FindParentCheckpoint(
+            const GeneticAlgorithmSolution &solution,
+            int upperBound,
+            const GeneticAlgorithmPrefixCosts *&pCheckpointPrefixCosts) const {
+        auto &procTimes = solution.mProcessingTimes;
+
+        // The last checkpoint of a parent before the first position changed by the solution. The checkpoints pruned
+        // under a lower bound may miss the states that are needed now.
+        const FixedPermCostComputation::PrefixCheckpoint *pCheckpoint = nullptr;
+        pCheckpointPrefixCosts = nullptr;
+        for (auto &pParentPrefixCosts : solution.mParentsPrefixCosts) {
+            if (pParentPrefixCosts == nullptr) {
+                continue;
+            }
+
+            auto &parentProcTimes = pParentPrefixCosts->mProcessingTimes;
+            int commonPrefixCount = mismatch(
+                    procTimes.begin(), procTimes.end(), parentProcTimes.begin(), parentProcTimes.end()).first
+                    - procTimes.begin();
+            for (auto &checkpoint : pParentPrefixCosts->mCheckpoints) {
+                if (checkpoint.mPosition < commonPrefixCount
+                    && checkpoint.mUpperBound >= upperBound
+                    && (pCheckpoint == nullptr || pCheckpoint->mPosition < checkpoint.mPosition)) {
+                    pCheckpoint = &checkpoint;
+                    pCheckpointPrefixCosts = pParentPrefixCosts.get();
+                }
+            }
+        }
+
+        return pCheckpoint;
+    }
+
+    void GeneticAlgorithm::SavePrefixCosts(
+            const FixedPermCostComputation *pCostComputation,
+            const GeneticAlgorithmSolution &solution,
+            const FixedPermCostComputation::PrefixCheckpoint *pCheckpoint,
+            const GeneticAlgorithmPrefixCosts *pCheckpointPrefixCosts) const {
+        if (solution.mPrefixCosts == nullptr) {
+            return;
+        }
+
+        // The solution is evaluated once, its children read the checkpoints in the next generations.
+        auto &prefixCosts = *solution.mPrefixCosts;
+        prefixCosts.mProcessingTimes = solution.mProcessingTimes;
+        prefixCosts.mCheckpoints.clear();
+        for (int position : mCheckpointPositions) {
+            FixedPermCostComputation::PrefixCheckpoint checkpoint;
+            if (pCostComputation->saveCheckpoint(position, checkpoint)) {
+                prefixCosts.mCheckpoints.push_back(move(checkpoint));
+            }
+            else if (pCheckpoint != nullptr && position <= pCheckpoint->mPosition) {
+                // Not computed since restored, the same as the ones of the parent.
+                for (auto &parentCheckpoint : pCheckpointPrefixCosts->mCheckpoints) {
+                    if (parentCheckpoint.mPosition == position) {
+                        prefixCosts.mCheckpoints.push_back(parentCheckpoint);
+                    }
+                }
+            }
+        }
+    }
+
+    int GeneticAlgorithm::ComputeCost(
+            FixedPermCostComputation *pCostComputation,
+            const GeneticAlgorithmSolution &solution,
+            int upperBound,
+            bool &prunedByBound) {
+        const GeneticAlgorithmPrefixCosts *pCheckpointPrefixCosts;
+        auto *pCheckpoint = FindParentCheckpoint(solution, upperBound, pCheckpointPrefixCosts);
+        if (pCheckpoint != nullptr) {
+            pCostComputation->restoreCheckpoint(solution.mProcessingTimes, *pCheckpoint);
+        }
+        else {
+            pCostComputation->setPermutation(solution.mProcessingTimes);
+        }
+
+        int cost = pCostComputation->recomputeCost(upperBound);
+        prunedByBound = pCostComputation->isPrunedByBound();
+        SavePrefixCosts(pCostComputation, solution, pCheckpoint, pCheckpointPrefixCosts);
+
+        return cost;
+    }
+
     void GeneticAlgorithm::InitGenes(GeneticAlgorithmSolution& solution,const std::function<double(void)> &rnd01) {
         mt19937 random((unsigned long)(rnd01() * 10000000));
         for (auto &pJob : mInstance.mJobs) {
             solution.mProcessingTimes.push_back(pJob->mProcessingTime);
         }
+        solution.mPrefixCosts = make_shared<GeneticAlgorithmPrefixCosts>();
 
         shuffle(solution.mProcessingTimes.begin(), solution.mProcessingTimes.end(), random);
     }
 
     bool GeneticAlgorithm::EvalSolution(
+            int islandIdx,
             const GeneticAlgorithmSolution& solution,
             GeneticAlgorithmCost &cost) {
-        auto fixedPermCost = ComputeObjective(solution.mProcessingTimes).first;
-        if (fixedPermCost.has_value()) {
-            cost.mCost = fixedPermCost.value();
+        int upperBound = mWorstKeptCosts[islandIdx].load();
+        int fixedPermCost;
+        bool prunedByBound;
+        if (!mCostCache || !mCostCache->find(solution.mProcessingTimes, upperBound, fixedPermCost, prunedByBound)) {
+            auto *pCostComputation = AcquireCostComputation();
+            fixedPermCost = ComputeCost(pCostComputation, solution, upperBound, prunedByBound);
+            ReleaseCostComputation(pCostComputation);
+
+            InsertCachedCost(solution.mProcessingTimes, upperBound, fixedPermCost, prunedByBound);
+        }
+
+        return SetCost(upperBound, fixedPermCost, prunedByBound, cost);
+    }
+
+    void GeneticAlgorithm::EvalSolutions(
+            int islandIdx,
+            const vector<GeneticAlgorithmSolution> &solutions,
+            vector<GeneticAlgorithmCost> &costs,
+            vector<bool> &accepted) {
+        int upperBound = mWorstKeptCosts[islandIdx].load();
+
+        // Only the solutions not found in the cache are computed. The children share long prefixes (e.g., the ones of
+        // the same parent), their common prefixes are computed once, and each continues from the checkpoint of its
+        // parents if it saves more.
+        vector<int> fixedPermCosts(solutions.size(), Instance::NO_VALUE);
+        vector<bool> prunedByBound(solutions.size(), false);
+        vector<int> computedIdxs;
+        vector<vector<int>> permutations;
+        vector<const FixedPermCostComputation::PrefixCheckpoint*> checkpoints;
+        vector<const GeneticAlgorithmPrefixCosts*> checkpointsPrefixCosts;
+        for (int idx = 0; idx < (int)solutions.size(); idx++) {
+            auto &procTimes = solutions[idx].mProcessingTimes;
+            bool solutionPrunedByBound = false;
+            bool found = mCostCache && mCostCache->find(
+                    procTimes, upperBound, fixedPermCosts[idx], solutionPrunedByBound);
+            prunedByBound[idx] = solutionPrunedByBound;
+            if (!found) {
+                computedIdxs.push_back(idx);
+                permutations.push_back(procTimes);
+                const GeneticAlgorithmPrefixCosts *pCheckpointPrefixCosts;
+                checkpoints.push_back(FindParentCheckpoint(solutions[idx], upperBound, pCheckpointPrefixCosts));
+                checkpointsPrefixCosts.push_back(pCheckpointPrefixCosts);
+            }
+        }
+
+        if (!permutations.empty()) {
+            auto *pCostComputation = AcquireCostComputation();
+            pCostComputation->computeCosts(permutations, upperBound, checkpoints, [&](int computedIdx, int cost) {
+                int idx = computedIdxs[computedIdx];
+                fixedPermCosts[idx] = cost;
+                prunedByBound[idx] = pCostComputation->isPrunedByBound();
+                SavePrefixCosts(
+                        pCostComputation, solutions[idx], checkpoints[computedIdx], checkpointsPrefixCosts[computedIdx]);
+                InsertCachedCost(permutations[computedIdx], upperBound, cost, prunedByBound[idx]);
+            });
+            ReleaseCostComputation(pCostComputation);
+        }
+
+        for (int idx = 0; idx < (int)solutions.size(); idx++) {
+            accepted[idx] = SetCost(upperBound, fixedPermCosts[idx], prunedByBound[idx], costs[idx]);
+        }
+    }
+
+    bool GeneticAlgorithm::SetCost(
+            int worstKeptCost,
+            int fixedPermCost,
+            bool prunedByBound,
+            GeneticAlgorithmCost &cost) {
+        if (fixedPermCost != Instance::NO_VALUE) {
+            cost.mCost = fixedPermCost;
+            cost.mIsBound = false;
+            return true;
+        }
+        else if (prunedByBound) {
+            // Not better than any chromosome of the last generation, its exact cost is not needed: it is ranked after
+            // all of them, hence it never becomes the best nor an elite.
+            cost.mCost = worstKeptCost + 1;
+            cost.mIsBound = true;
             return true;
         }
         else {
+            // Infeasible, it is generated again.
             return false;
         }
     }
 
+    void GeneticAlgorithm::InsertCachedCost(
+            const vector<int> &procTimes,
+            int upperBound,
+            int fixedPermCost,
+            bool prunedByBound) {
+        if (!mCostCache) {
+            return;
+        }
+
+        // The infeasible permutations are recorded under no bound, so that they are told from the pruned ones.
+        bool infeasible = fixedPermCost == Instance::NO_VALUE && !prunedByBound;
+        mCostCache->insert(procTimes, infeasible ? Instance::NO_VALUE : upperBound, fixedPermCost);
+    }
+
+    vector<GeneticAlgorithmSolution> GeneticAlgorithm::CreateSeeds(int islandIdx, mt19937_64 &random) {
+        vector<vector<int>> seedsProcTimes;
+        if (!mSolverConfig.mInitialStartTimes.empty()) {
+            seedsProcTimes.push_back(
+                    ProcessingTimesOrdering::fromStartTimes(mInstance, mSolverConfig.mInitialStartTimes));
+        }
+
+        // The islands take different orderings (if there are more orderings than seeds), so that they start diverse.
+        vector<ProcessingTimesOrdering::OrderingStrategy> orderingStrategies = {
+                ProcessingTimesOrdering::ShortestProcessingTimeFirst,
+                ProcessingTimesOrdering::LongestProcessingTimeFirst,
+                ProcessingTimesOrdering::AlternateShortestLongestProcessingTime,
+                ProcessingTimesOrdering::AlternateHalvesShortLongProcessingTime
+        };
+        int orderingsCount = min(
+                (int)round(mSpecializedSolverConfig.mSeedsFraction * mSpecializedSolverConfig.mPopulationSize),
+                (int)orderingStrategies.size());
+        for (int orderingIdx = 0; orderingIdx < orderingsCount; orderingIdx++) {
+            auto strategy = orderingStrategies[(islandIdx * orderingsCount + orderingIdx) % orderingStrategies.size()];
+            seedsProcTimes.push_back(ProcessingTimesOrdering::create(mInstance, strategy, random));
+        }
+
+        vector<GeneticAlgorithmSolution> seeds;
+        for (auto &seedProcTimes : seedsProcTimes) {
+            GeneticAlgorithmSolution seed;
+            seed.mProcessingTimes = move(seedProcTimes);
+            seed.mPrefixCosts = make_shared<GeneticAlgorithmPrefixCosts>();
+            seeds.push_back(move(seed));
+        }
+
+        return seeds;
+    }
+
+    GeneticAlgorithmSolution GeneticAlgorithm::CreateMutant(GeneticAlgorithmSolution &&baseSolution) {
+        // The mutant takes over the genes of the base, which is discarded.
+        GeneticAlgorithmSolution mutant;
+        mutant.mProcessingTimes = move(baseSolution.mProcessingTimes);
+        mutant.mPrefixCosts = make_shared<GeneticAlgorithmPrefixCosts>();
+        // The base is usually a child of a crossover that is not evaluated, the mutant inherits its parents.
+        mutant.mParentsPrefixCosts = move(baseSolution.mParentsPrefixCosts);
+        mutant.mParentsPrefixCosts.push_back(move(baseSolution.mPrefixCosts));
+        return mutant;
+    }
+
+    GeneticAlgorithmSolution GeneticAlgorithm::CreateChild(
+            const GeneticAlgorithmSolution &parent1,
+            const GeneticAlgorithmSolution &parent2) {
+        GeneticAlgorithmSolution child;
+        {
+            lock_guard<mutex> lock(mRecycledSolutionsMutex);
+            if (!mRecycledSolutions.empty()) {
+                child = move(mRecycledSolutions.back());
+                mRecycledSolutions.pop_back();
+            }
+        }
+
+        // The recycled storage is cleared by RecycleSolution, the proc times are filled by the crossover.
+        child.mProcessingTimes.reserve(parent1.mProcessingTimes.size());
+        child.mPrefixCosts = make_shared<GeneticAlgorithmPrefixCosts>();
+        child.mParentsPrefixCosts.push_back(parent1.mPrefixCosts);
+        child.mParentsPrefixCosts.push_back(parent2.mPrefixCosts);
+        return child;
+    }
+
+    void GeneticAlgorithm::RecycleSolution(GeneticAlgorithmSolution &&solution) {
+        if (solution.mProcessingTimes.capacity() == 0) {
+            // Moved out, nothing to reuse.
+            return;
+        }
+
+        // The prefix costs may be shared with the copies of the solution, they are not reused.
+        solution.mProcessingTimes.clear();
+        solution.mPrefixCosts.reset();
+        solution.mParentsPrefixCosts.clear();
+        lock_guard<mutex> lock(mRecycledSolutionsMutex);
+        if ((int)mRecycledSolutions.size() < mIslandsCount * mSpecializedSolverConfig.mPopulationSize) {
+            mRecycledSolutions.push_back(move(solution));
+        }
+    }
+
     int GeneticAlgorithm::NextRandomInt(int minValue, int maxValue, double randValue)
     {
         int diff = (maxValue - minValue) + 1;
@@ -225,70 +697,148 @@ namespace escs {
         return min(maxValue, step + minValue);
     }
 
+    int GeneticAlgorithm::NextMoveCandidate(
+            int minValue,
+            int maxValue,
+            const std::function<double(void)> &rnd01,
+            BidirectionalPermCostComputation *pMoveCostComputation,
+            const std::function<int(int)> &computeMoveCost) {
+        int bestCandidate = NextRandomInt(minValue, maxValue, rnd01());
+        if (pMoveCostComputation == nullptr) {
+            return bestCandidate;
+        }
+
+        int bestMoveCost = computeMoveCost(bestCandidate);
+        for (int candidateIdx = 1; candidateIdx < mSpecializedSolverConfig.mMutationCandidatesCount; candidateIdx++) {
+            int candidate = NextRandomInt(minValue, maxValue, rnd01());
+            int moveCost = computeMoveCost(candidate);
+            if (moveCost < bestMoveCost) {
+                bestCandidate = candidate;
+                bestMoveCost = moveCost;
+            }
+        }
+
+        return bestCandidate;
+    }
+
     GeneticAlgorithmSolution GeneticAlgorithm::MutateSwap(
-            const GeneticAlgorithmSolution& baseSolution,
+            GeneticAlgorithmSolution &&baseSolution,
             const std::function<double(void)> &rnd01,
             double shrinkScale)
     {
-        GeneticAlgorithmSolution newSolution;
-        newSolution.mProcessingTimes = baseSolution.mProcessingTimes;
+        GeneticAlgorithmSolution newSolution = CreateMutant(move(baseSolution));
         int changesCount = (int)floor(shrinkScale * newSolution.mProcessingTimes.size());
 
+        auto *pMoveCostComputation = changesCount > 0 ? AcquireMoveCostComputation() : nullptr;
         for (int i = 0; i < changesCount; i++) {
             int srcPos = min((int)(rnd01() * newSolution.mProcessingTimes.size()), (int)newSolution.mProcessingTimes.size() - 1);
-            int destPos = min((int)(rnd01() * newSolution.mProcessingTimes.size()), (int)newSolution.mProcessingTimes.size() - 1);
+            if (pMoveCostComputation != nullptr) {
+                pMoveCostComputation->setPermutation(newSolution.mProcessingTimes);
+            }
+            int destPos = NextMoveCandidate(
+                    0,
+                    newSolution.mProcessingTimes.size() - 1,
+                    rnd01,
+                    pMoveCostComputation,
+                    [&](int candidatePos) {
+                        return pMoveCostComputation->computeSwapCost(srcPos, candidatePos);
+                    });
             swap(newSolution.mProcessingTimes[srcPos], newSolution.mProcessingTimes[destPos]);
         }
+        ReleaseMoveCostComputation(pMoveCostComputation);
 
         return newSolution;
     }
 
     GeneticAlgorithmSolution GeneticAlgorithm::MutateSwapDiffProcTimes(
-            const GeneticAlgorithmSolution& baseSolution,
+            GeneticAlgorithmSolution &&baseSolution,
             const std::function<double(void)> &rnd01,
             double shrinkScale)
     {
-        GeneticAlgorithmSolution newSolution;
-        newSolution.mProcessingTimes = baseSolution.mProcessingTimes;
-        int changesCount = (int)floor(shrinkScale * newSolution.mProcessingTimes.size());
-
+        GeneticAlgorithmSolution newSolution = CreateMutant(move(baseSolution));
+        // With a single proc time, there are no positions to swap.
+        int changesCount = mClassJobsCounts.size() >= 2
+                ? (int)floor(shrinkScale * newSolution.mProcessingTimes.size())
+                : 0;
+
+        auto *pMoveCostComputation = changesCount > 0 ? AcquireMoveCostComputation() : nullptr;
+        if (pMoveCostComputation != nullptr) {
+            pMoveCostComputation->setPermutation(newSolution.mProcessingTimes);
+        }
         for (int i = 0; i < changesCount; i++) {
             int srcPos = min((int)(rnd01() * newSolution.mProcessingTimes.size()), (int)newSolution.mProcessingTimes.size() - 1);
-            int destPos = min((int)(rnd01() * newSolution.mProcessingTimes.size()), (int)newSolution.mProcessingTimes.size() - 1);
+            int destPos = NextMoveCandidate(
+                    0,
+                    newSolution.mProcessingTimes.size() - 1,
+                    rnd01,
+                    pMoveCostComputation,
+                    [&](int candidatePos) {
+                        // The swaps of equal proc times do not change the permutation.
+                        return newSolution.mProcessingTimes[srcPos] == newSolution.mProcessingTimes[candidatePos]
+                                ? Instance::NO_VALUE
+                                : pMoveCostComputation->computeSwapCost(srcPos, candidatePos);
+                    });
             if (newSolution.mProcessingTimes[srcPos] == newSolution.mProcessingTimes[destPos]) {
                 // TODO: slow!!!
                 i--;
                 continue;
             }
             swap(newSolution.mProcessingTimes[srcPos], newSolution.mProcessingTimes[destPos]);
+            if (pMoveCostComputation != nullptr) {
+                pMoveCostComputation->setPermutation(newSolution.mProcessingTimes);
+            }
         }
+        ReleaseMoveCostComputation(pMoveCostComputation);
 
         return newSolution;
     }
 
     GeneticAlgorithmSolution GeneticAlgorithm::MutateBlockInsertion(
-            const GeneticAlgorithmSolution& baseSolution,
+            GeneticAlgorithmSolution &&baseSolution,
             const std::function<double(void)> &rnd01,
             double shrinkScale) {
-        GeneticAlgorithmSolution newSolution;
-        newSolution.mProcessingTimes = baseSolution.mProcessingTimes;
+        GeneticAlgorithmSolution newSolution = CreateMutant(move(baseSolution));
 
         int insertionBlockSize = min(
                 max(1, (int)floor(shrinkScale * newSolution.mProcessingTimes.size())),
                 (int)newSolution.mProcessingTimes.size());
 
-        int fromPos = NextRandomInt(0, newSolution.mProcessingTimes.size() - insertionBlockSize, rnd01());
-        vector<int> block = vector<int>(
-                newSolution.mProcessingTimes.begin() + fromPos,
-                newSolution.mProcessingTimes.begin() + fromPos + insertionBlockSize);
-        newSolution.mProcessingTimes.erase(
-                newSolution.mProcessingTimes.begin() + fromPos,
-                newSolution.mProcessingTimes.begin() + fromPos + insertionBlockSize);
-        int toPos = NextRandomInt(0, newSolution.mProcessingTimes.size(), rnd01());
-        newSolution.mProcessingTimes.insert(
-                newSolution.mProcessingTimes.begin() + toPos,
-                block.begin(),
-                block.end());
+        // The block is moved in place: toPos is its position after it is removed, the positions between it and the
+        // block shift by the block size.
+        auto &procTimes = newSolution.mProcessingTimes;
+        int fromPos = NextRandomInt(0, procTimes.size() - insertionBlockSize, rnd01());
+        auto *pMoveCostComputation = AcquireMoveCostComputation();
+        auto &movedProcTimes = movedProcTimesTmp;
+        if (pMoveCostComputation != nullptr) {
+            pMoveCostComputation->setPermutation(procTimes);
+        }
+        int toPos = NextMoveCandidate(
+                0,
+                procTimes.size() - insertionBlockSize,
+                rnd01,
+                pMoveCostComputation,
+                [&](int candidatePos) {
+                    // Only the positions between the block and its destination change.
+                    int changedFromPos = min(fromPos, candidatePos);
+                    int changedToPos = max(fromPos, candidatePos) + insertionBlockSize;
+                    movedProcTimes.assign(procTimes.begin() + changedFromPos, procTimes.begin() + changedToPos);
+                    int blockOffset = candidatePos < fromPos ? fromPos - candidatePos : insertionBlockSize;
+                    rotate(movedProcTimes.begin(), movedProcTimes.begin() + blockOffset, movedProcTimes.end());
+                    return pMoveCostComputation->computeReplacementCost(changedFromPos, changedToPos, movedProcTimes);
+                });
+        ReleaseMoveCostComputation(pMoveCostComputation);
+        if (toPos < fromPos) {
+            rotate(
+                    procTimes.begin() + toPos,
+                    procTimes.begin() + fromPos,
+                    procTimes.begin() + fromPos + insertionBlockSize);
+        }
+        else {
+            rotate(
+                    procTimes.begin() + fromPos,
+                    procTimes.begin() + fromPos + insertionBlockSize,
+                    procTimes.begin() + toPos + insertionBlockSize);
+        }
 
         return newSolution;
     }
@@ -297,18 +847,10 @@ namespace escs {
             const GeneticAlgorithmSolution& parent1,
             const GeneticAlgorithmSolution& parent2,
             const std::function<double(void)> &rnd01) {
-        GeneticAlgorithmSolution child;
+        GeneticAlgorithmSolution child = CreateChild(parent1, parent2);
 
-        map<int, int> remainingProcTimeCounts;
-        for (auto *pJob : mInstance.mJobs) {
-            auto it = remainingProcTimeCounts.find(pJob->mProcessingTime);
-            if (it == remainingProcTimeCounts.end()) {
-                remainingProcTimeCounts[pJob->mProcessingTime] = 1;
-            }
-            else {
-                it->second++;
-            }
-        }
+        auto &remainingClassJobsCounts = remainingClassJobsCountsTmp;
+        remainingClassJobsCounts.assign(mClassJobsCounts.begin(), mClassJobsCounts.end());
 
         int parent1Pointer = 0;
         int parent2Pointer = 0;
@@ -320,14 +862,13 @@ namespace escs {
 
             // Find the next unused processing time from inherited parent (will be pointed by pointer).
             while (inheritPointer < (int)inheritParent.mProcessingTimes.size() &&
-                   remainingProcTimeCounts[inheritParent.mProcessingTimes[inheritPointer]] == 0) {
+                   remainingClassJobsCounts[mProcTimeClassIds[inheritParent.mProcessingTimes[inheritPointer]]] == 0) {
                 inheritPointer++;
             }
 
             if (inheritPointer < (int)inheritParent.mProcessingTimes.size()) {
                 int procTime = inheritParent.mProcessingTimes[inheritPointer];
-                int procTimeCount = remainingProcTimeCounts[procTime];
-                remainingProcTimeCounts[procTime] = procTimeCount - 1;
+                remainingClassJobsCounts[mProcTimeClassIds[procTime]]--;
                 child.mProcessingTimes.push_back(procTime);
             }
             else {
@@ -335,10 +876,9 @@ namespace escs {
                 int &otherInheritPointer = fromParent1 ? parent2Pointer : parent1Pointer;
                 const GeneticAlgorithmSolution &otherInheritParent = fromParent1 ? parent2 : parent1;
                 while (otherInheritPointer < (int)otherInheritParent.mProcessingTimes.size()) {
-                    if (remainingProcTimeCounts[otherInheritParent.mProcessingTimes[otherInheritPointer]] > 0) {
-                        int procTime = otherInheritParent.mProcessingTimes[otherInheritPointer];
-                        int procTimeCount = remainingProcTimeCounts[procTime];
-                        remainingProcTimeCounts[procTime] = procTimeCount - 1;
+                    int procTime = otherInheritParent.mProcessingTimes[otherInheritPointer];
+                    if (remainingClassJobsCounts[mProcTimeClassIds[procTime]] > 0) {
+                        remainingClassJobsCounts[mProcTimeClassIds[procTime]]--;
                         child.mProcessingTimes.push_back(procTime);
                     }
                     otherInheritPointer++;
@@ -353,19 +893,10 @@ namespace escs {
             const GeneticAlgorithmSolution& parent1,
             const GeneticAlgorithmSolution& parent2,
             const std::function<double(void)> &rnd01) {
-        GeneticAlgorithmSolution child;
-        child.mProcessingTimes = vector<int>(parent1.mProcessingTimes.size(), -1);
+        GeneticAlgorithmSolution child = CreateChild(parent1, parent2);
 
-        map<int, int> remainingProcTimeCounts;
-        for (auto *pJob : mInstance.mJobs) {
-            auto it = remainingProcTimeCounts.find(pJob->mProcessingTime);
-            if (it == remainingProcTimeCounts.end()) {
-                remainingProcTimeCounts[pJob->mProcessingTime] = 1;
-            }
-            else {
-                it->second++;
-            }
-        }
+        auto &remainingClassJobsCounts = remainingClassJobsCountsTmp;
+        remainingClassJobsCounts.assign(mClassJobsCounts.begin(), mClassJobsCounts.end());
 
         int swathStartIndex = min((int)(rnd01() * parent1.mProcessingTimes.size()), (int)parent1.mProcessingTimes.size() - 1);
         int swathEndIndex = min((int)(rnd01() * parent1.mProcessingTimes.size()), (int)parent1.mProcessingTimes.size() - 1);
@@ -380,26 +911,29 @@ namespace escs {
 
         for (int swathIndex = swathStartIndex; swathIndex <= swathEndIndex; swathIndex++)
         {
-            auto procTime = swathParent.mProcessingTimes[swathIndex];
-            child.mProcessingTimes[swathIndex] = procTime;
-            int procTimeCount = remainingProcTimeCounts[procTime];
-            remainingProcTimeCounts[procTime] = procTimeCount - 1;
+            remainingClassJobsCounts[mProcTimeClassIds[swathParent.mProcessingTimes[swathIndex]]]--;
         }
 
-        auto nextChildIndex = 0;
+        // The child is appended in order: the remaining proc times of the other parent fill the positions before the
+        // swath, then the swath, then the positions after it.
         if (swathStartIndex == 0) {
-            nextChildIndex = swathEndIndex + 1;
+            child.mProcessingTimes.insert(
+                    child.mProcessingTimes.end(),
+                    swathParent.mProcessingTimes.begin(),
+                    swathParent.mProcessingTimes.begin() + swathEndIndex + 1);
         }
         for (int index = 0; index < (int)otherParent.mProcessingTimes.size(); index++) {
             auto procTime = otherParent.mProcessingTimes[index];
-            int procTimeCount = remainingProcTimeCounts[procTime];
-            if (procTimeCount > 0) {
-                child.mProcessingTimes[nextChildIndex] = procTime;
-                remainingProcTimeCounts[procTime] = procTimeCount - 1;
-
-                nextChildIndex++;
-                if (nextChildIndex == swathStartIndex) {
-                    nextChildIndex = swathEndIndex + 1;
+            int &classJobsCount = remainingClassJobsCounts[mProcTimeClassIds[procTime]];
+            if (classJobsCount > 0) {
+                child.mProcessingTimes.push_back(procTime);
+                classJobsCount--;
+
+                if ((int)child.mProcessingTimes.size() == swathStartIndex) {
+                    child.mProcessingTimes.insert(
+                            child.mProcessingTimes.end(),
+                            swathParent.mProcessingTimes.begin() + swathStartIndex,
+                            swathParent.mProcessingTimes.begin() + swathEndIndex + 1);
                 }
             }
         }
@@ -412,14 +946,34 @@ namespace escs {
     }
 
     void GeneticAlgorithm::ReportGeneration(
+            int islandIdx,
             int generationNumber,
             const EA::GenerationType<GeneticAlgorithmSolution,GeneticAlgorithmCost> &lastGeneration,
             const GeneticAlgorithmSolution& bestSolution) {
-        if (bestSolution.mProcessingTimes.size() > 0) {
+        // Only the exact costs, so that the bound does not grow with the bounded chromosomes kept, and the checkpoints
+        // of the last generation (pruned under its bound) stay usable.
+        int worstKeptCost = Instance::NO_VALUE;
+        for (auto &chromosome : lastGeneration.chromosomes) {
+            if (chromosome.middle_costs.mIsBound) {
+                continue;
+            }
+
+            if (worstKeptCost == Instance::NO_VALUE || worstKeptCost < chromosome.middle_costs.mCost) {
+                worstKeptCost = chromosome.middle_costs.mCost;
+            }
+        }
+        mWorstKeptCosts[islandIdx].store(worstKeptCost);
+
+        lock_guard<mutex> lock(mBestSolutionMutex);
+        int bestCost = (int)round(lastGeneration.best_total_cost);
+        if (bestSolution.mProcessingTimes.size() > 0 && (!mObj.has_value() || bestCost <= mObj.value())) {
             mProcTimesPerm = bestSolution.mProcessingTimes;
-            mObj = (unsigned long)round(lastGeneration.best_total_cost);
+            mObj = bestCost;
         }
 
+        if (mIslandsCount > 1) {
+            std::cout<<"Island ["<<islandIdx<<"], ";
+        }
         std::cout
                 <<"Generation ["<<generationNumber<<"], "
                 <<"Best="<<(unsigned long)round(lastGeneration.best_total_cost)<<", "
@@ -438,7 +992,16 @@ namespace escs {
             MutationStrategy mutationStrategy,
             double mutationRate,
             int bestStallMax,
-            int averageStallMax) :
+            int averageStallMax,
+            int populationThreadsCount,
+            int levelThreadsCount,
+            int costCacheCapacity,
+            int islandsCount,
+            int migrationInterval,
+            int migrantsCount,
+            bool steadyState,
+            double seedsFraction,
+            int mutationCandidatesCount) :
             mGenerationsCount(generationsCount),
             mPopulationSize(populationSize),
             mEliteCount(eliteCount),
@@ -447,7 +1010,16 @@ namespace escs {
                 mMutationStrategy(mutationStrategy),
                 mMutationRate(mutationRate),
                 mBestStallMax(bestStallMax),
-                mAverageStallMax(averageStallMax) {
+                mAverageStallMax(averageStallMax),
+                mPopulationThreadsCount(populationThreadsCount),
+                mLevelThreadsCount(levelThreadsCount),
+                mCostCacheCapacity(costCacheCapacity),
+                mIslandsCount(islandsCount),
+                mMigrationInterval(migrationInterval),
+                mMigrantsCount(migrantsCount),
+                mSteadyState(steadyState),
+                mSeedsFraction(seedsFraction),
+                mMutationCandidatesCount(mutationCandidatesCount) {
 
     }
 
@@ -482,6 +1054,33 @@ namespace escs {
         int averageStallMax;
         stream >> averageStallMax;
 
+        int populationThreadsCount;
+        stream >> populationThreadsCount;
+
+        int levelThreadsCount;
+        stream >> levelThreadsCount;
+
+        int costCacheCapacity;
+        stream >> costCacheCapacity;
+
+        int islandsCount;
+        stream >> islandsCount;
+
+        int migrationInterval;
+        stream >> migrationInterval;
+
+        int migrantsCount;
+        stream >> migrantsCount;
+
+        int steadyState;
+        stream >> steadyState;
+
+        double seedsFraction;
+        stream >> seedsFraction;
+
+        int mutationCandidatesCount;
+        stream >> mutationCandidatesCount;
+
         return SpecializedSolverConfig(
                 generationsCount,
                 populationSize,
@@ -491,6 +1090,15 @@ namespace escs {
                 (MutationStrategy)mutationStrategy,
                 mutationRate,
                 bestStallMax,
-                averageStallMax);
+                averageStallMax,
+                populationThreadsCount,
+                levelThreadsCount,
+                costCacheCapacity,
+                islandsCount,
+                migrationInterval,
+                migrantsCount,
+                steadyState != 0,
+                seedsFraction,
+                mutationCandidatesCount);
     }
 }
\ No newline at end of file
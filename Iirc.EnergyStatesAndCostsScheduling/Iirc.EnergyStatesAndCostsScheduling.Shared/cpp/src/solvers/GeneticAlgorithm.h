@@ -5,11 +5,16 @@
 #define ENERGYSTATESANDCOSTSSCHEDULING_GENETICALGORITHM_H
 
 #include <algorithm>
+#include <atomic>
 #include <map>
+#include <mutex>
 
 #include "../openga/openGA.hpp"
 #include "../input/Instance.h"
 #include "../datastructs/FixedPermCostComputation.h"
+#include "../datastructs/BidirectionalPermCostComputation.h"
+#include "../datastructs/PermutationCostCache.h"
+#include "../algorithms/ProcessingTimesOrdering.h"
 #include "SolverConfig.h"
 #include "../output/Result.h"
 
@@ -17,9 +22,21 @@ using namespace std;
 
 namespace escs {
 
+    // Checkpoints of the cost computation of an evaluated solution, its children continue from the last one before the
+    // first position they change.
+    struct GeneticAlgorithmPrefixCosts
+    {
+        vector<int> mProcessingTimes;
+        vector<FixedPermCostComputation::PrefixCheckpoint> mCheckpoints;
+    };
+
     struct GeneticAlgorithmSolution
     {
         vector<int> mProcessingTimes;
+        // Filled by the evaluation of the solution (shared by its copies, e.g., when it is selected as a parent).
+        shared_ptr<GeneticAlgorithmPrefixCosts> mPrefixCosts;
+        // Of the parents of the solution.
+        vector<shared_ptr<const GeneticAlgorithmPrefixCosts>> mParentsPrefixCosts;
 
         std::string to_string() const
         {
@@ -40,6 +57,7 @@ namespace escs {
     struct GeneticAlgorithmCost
     {
         int mCost;
+        bool mIsBound; // If true, the cost is not less than mCost, which is only the bound of the last generation.
     };
 
     typedef EA::Genetic<GeneticAlgorithmSolution, GeneticAlgorithmCost> GA_Type;
@@ -72,6 +90,29 @@ namespace escs {
             const double mMutationRate;
             const int mBestStallMax;
             const int mAverageStallMax;
+            // Threads evaluating the chromosomes concurrently, if < 1 then the number of workers.
+            const int mPopulationThreadsCount;
+            // OpenMP threads of a DP level within one evaluation, if < 1 then the workers left per population thread.
+            const int mLevelThreadsCount;
+            // Maximum number of the cached costs of the evaluated permutations, if < 1 then no cache.
+            const int mCostCacheCapacity;
+            // Independent populations (on separate threads) exchanging their best chromosomes over a ring, if < 2 then
+            // a single population.
+            const int mIslandsCount;
+            // Generations between the migrations, if < 1 then no migration.
+            const int mMigrationInterval;
+            // The best chromosomes of an island migrating to the next one.
+            const int mMigrantsCount;
+            // If true, the offspring replace the worst chromosomes one by one, without the generations (see
+            // EA::Genetic::solve_steady_state).
+            const bool mSteadyState;
+            // The share of the initial population seeded by the constructive orderings of the proc times (see
+            // ProcessingTimesOrdering), at most one chromosome per ordering. The initial start times (if any) are
+            // always seeded.
+            const double mSeedsFraction;
+            // The candidate moves of a mutation step (e.g., the destinations of a swap) scored by
+            // BidirectionalPermCostComputation, the one of the least cost is applied. If < 2, a single random move.
+            const int mMutationCandidatesCount;
 
             SpecializedSolverConfig(
                     int generationsCount,
@@ -82,7 +123,16 @@ namespace escs {
                     MutationStrategy mutationStrategy,
                     double mutationRate,
                     int bestStallMax,
-                    int averageStallMax);
+                    int averageStallMax,
+                    int populationThreadsCount,
+                    int levelThreadsCount,
+                    int costCacheCapacity,
+                    int islandsCount,
+                    int migrationInterval,
+                    int migrantsCount,
+                    bool steadyState,
+                    double seedsFraction,
+                    int mutationCandidatesCount);
 
             static SpecializedSolverConfig ReadFromPath(string specializedSolverConfigPath);
         };
@@ -98,8 +148,55 @@ namespace escs {
         vector<int> mProcTimesPerm;
         vector<int> mStartTimesPerm;
         optional<int> mObj;
-
-        unique_ptr<FixedPermCostComputation> mFixedPermCostComputation;
+        mutex mBestSolutionMutex; // Of mProcTimesPerm and mObj, reported by all the islands.
+
+        int mIslandsCount;
+        int mPopulationThreadsCount;
+        int mLevelThreadsCount;
+
+        // One cost computation per population thread of each island (all sharing the cost tables of the instance), each evaluation
+        // takes an idle one.
+        vector<unique_ptr<FixedPermCostComputation>> mFixedPermCostComputations;
+        vector<FixedPermCostComputation*> mIdleFixedPermCostComputations;
+        mutex mIdleFixedPermCostComputationsMutex;
+        // As mFixedPermCostComputations, scoring the candidate moves of the mutations (none if a single candidate).
+        vector<unique_ptr<BidirectionalPermCostComputation>> mMoveCostComputations;
+        vector<BidirectionalPermCostComputation*> mIdleMoveCostComputations;
+        mutex mIdleMoveCostComputationsMutex;
+        // Per island, the cost of the worst chromosome of the last generation (Instance::NO_VALUE before the first one).
+        // The children that are not better are evaluated only up to this bound. In the steady-state mode, it is updated
+        // while the island evaluates, each evaluation reads it once.
+        vector<atomic<int>> mWorstKeptCosts;
+        // Per island, the last emigrants of the previous island of the ring.
+        vector<vector<GA_Type::thisChromosomeType>> mMigrants;
+        mutex mMigrantsMutex;
+        // Positions of the checkpoints of the evaluated solutions: a regular grid, denser towards the end, so that the
+        // children changing only the end of the parent are nearly free.
+        vector<int> mCheckpointPositions;
+        // The operators count the proc times by their classes: the dense ids of the distinct proc times (in their
+        // increasing order), indexed by the proc time (-1 if no job has it).
+        vector<int> mProcTimeClassIds;
+        // Per class, the number of the jobs having its proc time.
+        vector<int> mClassJobsCounts;
+        // The dropped chromosomes of all the islands (at most mPopulationSize per island), the children take over their
+        // storage. Shared by the threads of the islands and of their populations.
+        vector<GeneticAlgorithmSolution> mRecycledSolutions;
+        mutex mRecycledSolutionsMutex;
+
+        // Elites and the duplicate children (likely when the population converges) are not evaluated again. Nullptr if
+        // disabled.
+        unique_ptr<PermutationCostCache> mCostCache;
+
+        vector<GeneticAlgorithmSolution> CreateSeeds(int islandIdx, mt19937_64 &random);
+        GeneticAlgorithmSolution CreateMutant(GeneticAlgorithmSolution &&baseSolution);
+        GeneticAlgorithmSolution CreateChild(
+                const GeneticAlgorithmSolution &parent1,
+                const GeneticAlgorithmSolution &parent2);
+
+        FixedPermCostComputation *AcquireCostComputation();
+        void ReleaseCostComputation(FixedPermCostComputation *pCostComputation);
+        BidirectionalPermCostComputation *AcquireMoveCostComputation();
+        void ReleaseMoveCostComputation(BidirectionalPermCostComputation *pMoveCostComputation);
 
     public:
         GeneticAlgorithm(
@@ -109,30 +206,63 @@ namespace escs {
 
         Status solve();
         void solveInternal();
+        void SolveIsland(int islandIdx, mt19937_64 random);
+        void Migrate(int islandIdx, Generation_Type &generation);
 
         vector<int> GetStartTimes() const;
         Result GetResult() const;
 
         int NextRandomInt(int minValue, int maxValue, double randValue);
+        // A random value from [minValue, maxValue], or the one of the least move cost (the first one on a tie or if no
+        // move is feasible) of mMutationCandidatesCount random candidates if pMoveCostComputation is not nullptr.
+        int NextMoveCandidate(
+                int minValue,
+                int maxValue,
+                const std::function<double(void)> &rnd01,
+                BidirectionalPermCostComputation *pMoveCostComputation,
+                const std::function<int(int)> &computeMoveCost);
 
         pair<optional<int>, vector<int>> ComputeObjective(const vector<int> &procTimes);
+        const FixedPermCostComputation::PrefixCheckpoint *FindParentCheckpoint(
+                const GeneticAlgorithmSolution &solution,
+                int upperBound,
+                const GeneticAlgorithmPrefixCosts *&pCheckpointPrefixCosts) const;
+        void SavePrefixCosts(
+                const FixedPermCostComputation *pCostComputation,
+                const GeneticAlgorithmSolution &solution,
+                const FixedPermCostComputation::PrefixCheckpoint *pCheckpoint,
+                const GeneticAlgorithmPrefixCosts *pCheckpointPrefixCosts) const;
+        int ComputeCost(
+                FixedPermCostComputation *pCostComputation,
+                const GeneticAlgorithmSolution &solution,
+                int upperBound,
+                bool &prunedByBound);
 
         void InitGenes(GeneticAlgorithmSolution& solution,const std::function<double(void)> &rnd01);
 
-        bool EvalSolution(const GeneticAlgorithmSolution& solution, GeneticAlgorithmCost &cost);
+        bool EvalSolution(int islandIdx, const GeneticAlgorithmSolution& solution, GeneticAlgorithmCost &cost);
+
+        void EvalSolutions(
+                int islandIdx,
+                const vector<GeneticAlgorithmSolution> &solutions,
+                vector<GeneticAlgorithmCost> &costs,
+                vector<bool> &accepted);
+
+        bool SetCost(int worstKeptCost, int fixedPermCost, bool prunedByBound, GeneticAlgorithmCost &cost);
+        void InsertCachedCost(const vector<int> &procTimes, int upperBound, int fixedPermCost, bool prunedByBound);
 
         GeneticAlgorithmSolution MutateSwap(
-                const GeneticAlgorithmSolution& baseSolution,
+                GeneticAlgorithmSolution &&baseSolution,
                 const std::function<double(void)> &rnd01,
                 double shrinkScale);
 
         GeneticAlgorithmSolution MutateSwapDiffProcTimes(
-                const GeneticAlgorithmSolution& baseSolution,
+                GeneticAlgorithmSolution &&baseSolution,
                 const std::function<double(void)> &rnd01,
                 double shrinkScale);
 
         GeneticAlgorithmSolution MutateBlockInsertion(
-                const GeneticAlgorithmSolution& baseSolution,
+                GeneticAlgorithmSolution &&baseSolution,
                 const std::function<double(void)> &rnd01,
                 double shrinkScale);
 
@@ -146,9 +276,13 @@ namespace escs {
                 const GeneticAlgorithmSolution& parent2,
                 const std::function<double(void)> &rnd01);
 
+        // Keeps the storage of a dropped solution (see mRecycledSolutions) for the next children.
+        void RecycleSolution(GeneticAlgorithmSolution &&solution);
+
         double CalculateFitness(const GA_Type::thisChromosomeType &X);
 
         void ReportGeneration(
+                int islandIdx,
                 int generationNumber,
                 const EA::GenerationType<GeneticAlgorithmSolution,GeneticAlgorithmCost> &lastGeneration,
                 const GeneticAlgorithmSolution& bestSolution);
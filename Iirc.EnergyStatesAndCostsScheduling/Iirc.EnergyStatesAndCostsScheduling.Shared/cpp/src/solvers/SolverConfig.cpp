@@ -6,8 +6,8 @@
 #include "SolverConfig.h"
 
 namespace escs {
-    SolverConfig::SolverConfig(unsigned long randomSeed, optional<chrono::milliseconds> timeLimit, int numWorkers, vector<int> initialStartTimes)
-        : mRandom(randomSeed), mTimeLimit(timeLimit), mNumWorkers(numWorkers), mInitialStartTimes(initialStartTimes)
+    SolverConfig::SolverConfig(unsigned long randomSeed, optional<chrono::milliseconds> timeLimit, int numWorkers, vector<int> initialStartTimes, bool useMongeTransitions)
+        : mRandom(randomSeed), mTimeLimit(timeLimit), mNumWorkers(numWorkers), mInitialStartTimes(initialStartTimes), mUseMongeTransitions(useMongeTransitions)
     {
 
     }
@@ -43,6 +43,9 @@ namespace escs {
             }
         }
 
-        return SolverConfig(randomSeed, timeLimit, numWorkers, initStartTimes);
+        int useMongeTransitions;
+        stream >> useMongeTransitions;
+
+        return SolverConfig(randomSeed, timeLimit, numWorkers, initStartTimes, useMongeTransitions != 0);
     }
 }
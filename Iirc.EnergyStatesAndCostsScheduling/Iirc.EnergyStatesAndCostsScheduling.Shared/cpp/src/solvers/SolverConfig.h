@@ -19,6 +19,9 @@ namespace escs {
         const optional<chrono::milliseconds> mTimeLimit;
         const int mNumWorkers;
         const vector<int> mInitialStartTimes;
+        // If false, the cost computations do not use the Monge transitions (see MongeSwitchingCosts) even if the
+        // switching costs are Monge, e.g., to measure their speedup.
+        const bool mUseMongeTransitions;
 
         // TODO: should not be public
         vector<bool> mProcessableIntervals;
@@ -27,7 +30,8 @@ namespace escs {
                 unsigned long randomSeed,
                 optional<chrono::milliseconds> timeLimit,
                 int numWorkers,
-                vector<int> initialStartTimes);
+                vector<int> initialStartTimes,
+                bool useMongeTransitions = true);
 
         static SolverConfig ReadFromPath(string solverConfigPath);
     };
@@ -0,0 +1,182 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <climits>
+#include <stdexcept>
+#include "MinPlusKernel.h"
+#include "../input/Instance.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ESCS_MIN_PLUS_X86_VARIANTS
+#endif
+
+namespace escs {
+    namespace {
+        const unsigned NO_SUM = Instance::NO_VALUE;
+
+        int toResult(unsigned minSum, int minSumIdx, int &argmin) {
+            if (minSum >= NO_SUM) {
+                argmin = -1;
+                return Instance::NO_VALUE;
+            }
+
+            argmin = minSumIdx;
+            return minSum;
+        }
+
+        typedef int (*MinPlusArgmin)(const int *lhs, const int *rhs, int count, int &argmin);
+
+        int minPlusArgminScalar(const int *lhs, const int *rhs, int count, int &argmin) {
+            unsigned minSum = UINT_MAX;
+            int minSumIdx = -1;
+            for (int k = 0; k < count; k++) {
+                unsigned sum = (unsigned)lhs[k] + (unsigned)rhs[k];
+                bool isLess = sum < minSum;
+                minSum = isLess ? sum : minSum;
+                minSumIdx = isLess ? k : minSumIdx;
+            }
+
+            return toResult(minSum, minSumIdx, argmin);
+        }
+
+#ifdef ESCS_MIN_PLUS_X86_VARIANTS
+        __attribute__((target("avx2")))
+        int minPlusArgminAvx2(const int *lhs, const int *rhs, int count, int &argmin) {
+            // First pass: the min, second pass: its first occurrence (usually ends early).
+            __m256i minSums = _mm256_set1_epi32(-1);
+            int k = 0;
+            for (; k + 8 <= count; k += 8) {
+                __m256i sums = _mm256_add_epi32(
+                        _mm256_loadu_si256((const __m256i *)(lhs + k)),
+                        _mm256_loadu_si256((const __m256i *)(rhs + k)));
+                minSums = _mm256_min_epu32(minSums, sums);
+            }
+
+            __m128i halfMinSums = _mm_min_epu32(_mm256_castsi256_si128(minSums), _mm256_extracti128_si256(minSums, 1));
+            halfMinSums = _mm_min_epu32(halfMinSums, _mm_shuffle_epi32(halfMinSums, _MM_SHUFFLE(1, 0, 3, 2)));
+            halfMinSums = _mm_min_epu32(halfMinSums, _mm_shuffle_epi32(halfMinSums, _MM_SHUFFLE(2, 3, 0, 1)));
+            unsigned minSum = _mm_cvtsi128_si32(halfMinSums);
+            for (; k < count; k++) {
+                unsigned sum = (unsigned)lhs[k] + (unsigned)rhs[k];
+                minSum = sum < minSum ? sum : minSum;
+            }
+
+            if (minSum >= NO_SUM) {
+                return toResult(minSum, -1, argmin);
+            }
+
+            __m256i minSumBroadcast = _mm256_set1_epi32(minSum);
+            k = 0;
+            for (; k + 8 <= count; k += 8) {
+                __m256i sums = _mm256_add_epi32(
+                        _mm256_loadu_si256((const __m256i *)(lhs + k)),
+                        _mm256_loadu_si256((const __m256i *)(rhs + k)));
+                int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(sums, minSumBroadcast)));
+                if (mask != 0) {
+                    return toResult(minSum, k + __builtin_ctz(mask), argmin);
+                }
+            }
+
+            while ((unsigned)lhs[k] + (unsigned)rhs[k] != minSum) {
+                k++;
+            }
+
+            return toResult(minSum, k, argmin);
+        }
+
+        __attribute__((target("avx512f")))
+        int minPlusArgminAvx512(const int *lhs, const int *rhs, int count, int &argmin) {
+            // The tail is loaded masked, its missing lanes sum to UINT_MAX. The unmasked forms of min and of the
+            // reduction are avoided, they trigger false uninitialized warnings in some GCC versions.
+            const __mmask16 allLanes = 0xFFFF;
+            __m512i noSums = _mm512_set1_epi32(-1);
+            __m512i zeros = _mm512_setzero_si512();
+            __m512i minSums = noSums;
+            for (int k = 0; k < count; k += 16) {
+                __mmask16 mask = count - k >= 16 ? allLanes : (__mmask16)((1u << (count - k)) - 1);
+                __m512i sums = _mm512_add_epi32(
+                        _mm512_mask_loadu_epi32(noSums, mask, lhs + k),
+                        _mm512_mask_loadu_epi32(zeros, mask, rhs + k));
+                minSums = _mm512_mask_min_epu32(minSums, allLanes, minSums, sums);
+            }
+
+            unsigned lanesMinSums[16];
+            _mm512_storeu_si512(lanesMinSums, minSums);
+            unsigned minSum = UINT_MAX;
+            for (unsigned laneMinSum : lanesMinSums) {
+                minSum = laneMinSum < minSum ? laneMinSum : minSum;
+            }
+
+            if (minSum >= NO_SUM) {
+                return toResult(minSum, -1, argmin);
+            }
+
+            __m512i minSumBroadcast = _mm512_set1_epi32(minSum);
+            int k = 0;
+            for (;; k += 16) {
+                __mmask16 mask = count - k >= 16 ? allLanes : (__mmask16)((1u << (count - k)) - 1);
+                __m512i sums = _mm512_add_epi32(
+                        _mm512_mask_loadu_epi32(noSums, mask, lhs + k),
+                        _mm512_mask_loadu_epi32(zeros, mask, rhs + k));
+                __mmask16 eqMask = _mm512_cmpeq_epu32_mask(sums, minSumBroadcast);
+                if (eqMask != 0) {
+                    return toResult(minSum, k + __builtin_ctz(eqMask), argmin);
+                }
+            }
+        }
+#endif
+
+        MinPlusArgmin getMinPlusArgmin(MinPlusKernelVariant variant) {
+            switch (variant) {
+#ifdef ESCS_MIN_PLUS_X86_VARIANTS
+                case MinPlusKernelVariant::Avx2:
+                    return minPlusArgminAvx2;
+                case MinPlusKernelVariant::Avx512:
+                    return minPlusArgminAvx512;
+#endif
+                default:
+                    return minPlusArgminScalar;
+            }
+        }
+
+        MinPlusArgmin selectWidestMinPlusArgmin() {
+            for (auto variant : {MinPlusKernelVariant::Avx512, MinPlusKernelVariant::Avx2}) {
+                if (isMinPlusKernelVariantSupported(variant)) {
+                    return getMinPlusArgmin(variant);
+                }
+            }
+
+            return minPlusArgminScalar;
+        }
+    }
+
+    int computeMinPlusArgmin(const int *lhs, const int *rhs, int count, int &argmin) {
+        // Selected once, then an indirect call (the variants are not inlined into the callers anyway).
+        static const MinPlusArgmin widestMinPlusArgmin = selectWidestMinPlusArgmin();
+        return widestMinPlusArgmin(lhs, rhs, count, argmin);
+    }
+
+    bool isMinPlusKernelVariantSupported(MinPlusKernelVariant variant) {
+        switch (variant) {
+            case MinPlusKernelVariant::Scalar:
+                return true;
+#ifdef ESCS_MIN_PLUS_X86_VARIANTS
+            case MinPlusKernelVariant::Avx2:
+                return __builtin_cpu_supports("avx2");
+            case MinPlusKernelVariant::Avx512:
+                return __builtin_cpu_supports("avx512f");
+#endif
+            default:
+                return false;
+        }
+    }
+
+    int computeMinPlusArgmin(MinPlusKernelVariant variant, const int *lhs, const int *rhs, int count, int &argmin) {
+        if (!isMinPlusKernelVariantSupported(variant)) {
+            throw invalid_argument("The min-plus kernel variant is not supported.");
+        }
+
+        return getMinPlusArgmin(variant)(lhs, rhs, count, argmin);
+    }
+}
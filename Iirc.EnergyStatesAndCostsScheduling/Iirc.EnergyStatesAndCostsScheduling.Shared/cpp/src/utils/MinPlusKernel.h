@@ -0,0 +1,32 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#ifndef ENERGYSTATESANDCOSTSSCHEDULING_MINPLUSKERNEL_H
+#define ENERGYSTATESANDCOSTSSCHEDULING_MINPLUSKERNEL_H
+
+using namespace std;
+
+namespace escs {
+    // Returns the min of lhs[k] + rhs[k] over k in [0, count) and stores its leftmost argmin into argmin. The entries
+    // equal to Instance::NO_VALUE are missing; if no k has both entries, returns Instance::NO_VALUE and argmin is -1.
+    // The entries must be non-negative and the sums of the present entries below Instance::NO_VALUE.
+    //
+    // The sums are computed as unsigned, where Instance::NO_VALUE is a saturating sentinel: any sum involving it is at
+    // least Instance::NO_VALUE and does not wrap around, so the kernel has no data-dependent branches. The widest of the
+    // AVX-512, AVX2 and scalar variants supported by the CPU is selected at runtime.
+    int computeMinPlusArgmin(const int *lhs, const int *rhs, int count, int &argmin);
+
+    enum class MinPlusKernelVariant {
+        Scalar,
+        Avx2,
+        Avx512
+    };
+
+    // Whether the variant is compiled in and supported by the CPU (the scalar one always is).
+    bool isMinPlusKernelVariantSupported(MinPlusKernelVariant variant);
+
+    // As computeMinPlusArgmin, by the given variant (it must be supported), e.g., to test the variants not selected.
+    int computeMinPlusArgmin(MinPlusKernelVariant variant, const int *lhs, const int *rhs, int count, int &argmin);
+}
+
+#endif //ENERGYSTATESANDCOSTSSCHEDULING_MINPLUSKERNEL_H
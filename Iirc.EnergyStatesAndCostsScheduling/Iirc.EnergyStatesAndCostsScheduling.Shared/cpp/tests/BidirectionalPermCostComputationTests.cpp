@@ -0,0 +1,130 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <algorithm>
+#include "TestUtils.h"
+#include "../src/datastructs/BidirectionalPermCostComputation.h"
+#include "../src/datastructs/MongeSwitchingCosts.h"
+
+using namespace std;
+using namespace escs;
+
+void testInsertionCostsAgreeWithReference() {
+    // The permutation changes between the insertions, so that the kept prefix and suffix costs are reused.
+    mt19937 random(1);
+    for (int iter = 0; iter < 100; iter++) {
+        auto switchingCostsKind = random() % 2 == 0 ? SwitchingCostsKind::Random : SwitchingCostsKind::Monge;
+        auto horizon = createTestHorizon(random, 30 + random() % 40, switchingCostsKind, random() % 2);
+        auto monge = MongeSwitchingCosts::create(
+                horizon.mOptimalSwitchingCosts, horizon.mEarliestOnIntervalIdx, horizon.mLatestOnIntervalIdx);
+        auto permutation = createTestProcTimes(random, horizon, 4, 10);
+        if (permutation.size() < 2) {
+            continue;
+        }
+
+        // The inserted proc times fit as the last one is removed before.
+        int maxTotalProcTime = accumulate(permutation.begin(), permutation.end(), 0);
+        permutation.pop_back();
+        BidirectionalPermCostComputation computation(
+                maxTotalProcTime,
+                horizon.mNumIntervals,
+                horizon.mEarliestOnIntervalIdx,
+                horizon.mLatestOnIntervalIdx,
+                horizon.createCostTables(maxTotalProcTime),
+                horizon.mProcessableIntervals,
+                nullptr,
+                monge.get());
+
+        for (int rep = 0; rep < 5; rep++) {
+            computation.setPermutation(permutation);
+            int totalProcTime = accumulate(permutation.begin(), permutation.end(), 0);
+            for (int position = 0; position <= (int)permutation.size(); position++) {
+                int procTime = 1 + random() % (maxTotalProcTime - totalProcTime);
+                auto insertedPermutation = permutation;
+                insertedPermutation.insert(insertedPermutation.begin() + position, procTime);
+                CHECK(computation.computeInsertionCost(position, procTime)
+                      == computeReferenceCost(horizon, insertedPermutation));
+            }
+
+            // Keeps a prefix or a suffix of the previous permutation.
+            int from = random() % permutation.size();
+            if (random() % 2 == 0) {
+                shuffle(permutation.begin() + from, permutation.end(), random);
+            }
+            else {
+                shuffle(permutation.begin(), permutation.begin() + from + 1, random);
+            }
+        }
+    }
+}
+
+void testMoveCostsAgreeWithReference() {
+    // The removals, the swaps and the block moves (as the replacements of the positions between the block and its
+    // destination) of the GA mutations.
+    mt19937 random(2);
+    int feasibleCount = 0;
+    for (int iter = 0; iter < 100; iter++) {
+        auto switchingCostsKind = random() % 2 == 0 ? SwitchingCostsKind::Random : SwitchingCostsKind::Monge;
+        auto horizon = createTestHorizon(random, 30 + random() % 40, switchingCostsKind, random() % 2);
+        auto monge = MongeSwitchingCosts::create(
+                horizon.mOptimalSwitchingCosts, horizon.mEarliestOnIntervalIdx, horizon.mLatestOnIntervalIdx);
+        auto permutation = createTestProcTimes(random, horizon, 4, 10);
+        if (permutation.size() < 2) {
+            continue;
+        }
+
+        int totalProcTime = accumulate(permutation.begin(), permutation.end(), 0);
+        BidirectionalPermCostComputation computation(
+                totalProcTime,
+                horizon.mNumIntervals,
+                horizon.mEarliestOnIntervalIdx,
+                horizon.mLatestOnIntervalIdx,
+                horizon.createCostTables(totalProcTime),
+                horizon.mProcessableIntervals,
+                nullptr,
+                random() % 2 == 0 ? monge.get() : nullptr);
+
+        for (int rep = 0; rep < 5; rep++) {
+            computation.setPermutation(permutation);
+            int positionsCount = permutation.size();
+            for (int position = 0; position < positionsCount; position++) {
+                auto removedPermutation = permutation;
+                removedPermutation.erase(removedPermutation.begin() + position);
+                CHECK(computation.computeRemovalCost(position) == computeReferenceCost(horizon, removedPermutation));
+
+                int otherPosition = random() % positionsCount;
+                auto swappedPermutation = permutation;
+                swap(swappedPermutation[position], swappedPermutation[otherPosition]);
+                CHECK(computation.computeSwapCost(position, otherPosition)
+                      == computeReferenceCost(horizon, swappedPermutation));
+
+                int blockSize = 1 + random() % (positionsCount - position);
+                auto movedPermutation = permutation;
+                rotate(movedPermutation.begin(), movedPermutation.begin() + position, movedPermutation.end());
+                rotate(movedPermutation.begin(), movedPermutation.begin() + blockSize, movedPermutation.end());
+                CHECK(computation.computeReplacementCost(0, positionsCount, movedPermutation)
+                      == computeReferenceCost(horizon, movedPermutation));
+            }
+
+            // The permutation itself is not changed by the moves.
+            int cost = computation.getCost();
+            CHECK(cost == computeReferenceCost(horizon, permutation));
+            if (cost != Instance::NO_VALUE) {
+                CHECK(computeScheduleCost(horizon, permutation, computation.reconstructStartTimes()) == cost);
+                feasibleCount++;
+            }
+            CHECK(computation.getPermProcTimes() == permutation);
+
+            swap(permutation[random() % positionsCount], permutation[random() % positionsCount]);
+        }
+    }
+
+    CHECK(feasibleCount > 0);
+}
+
+int main() {
+    testInsertionCostsAgreeWithReference();
+    testMoveCostsAgreeWithReference();
+
+    return finishTest("BidirectionalPermCostComputationTests");
+}
@@ -0,0 +1,310 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include "TestUtils.h"
+#include "../src/solvers/BranchAndBoundJob.h"
+
+using namespace std;
+using namespace escs;
+
+typedef BranchAndBoundOnJob BaB;
+
+// The search variants compared, the primal heuristics are off (they need CP Optimizer and Gurobi solutions).
+BaB::SpecializedSolverConfig createSpecializedSolverConfig(
+        bool useIterativeDeepening,
+        BaB::JobsJoiningOnGcd jobsJoiningOnGcd,
+        BaB::BranchPriority branchPriority,
+        int searchThreadsCount,
+        BaB::NodeSelection nodeSelection,
+        int dominanceMemoCapacity,
+        optional<long long> nodesCountLimit = optional<long long>(),
+        optional<long long> openNodesMemoryLimitMb = optional<long long>()) {
+    return BaB::SpecializedSolverConfig(
+            false,
+            false,
+            false,
+            useIterativeDeepening,
+            BaB::PrimalHeuristicBlockFinding::BF_OFF,
+            BaB::PrimalHeuristicBlockFindingStrategy::MinimizeLengthDifference,
+            jobsJoiningOnGcd,
+            branchPriority,
+            optional<chrono::milliseconds>(),
+            nodesCountLimit,
+            searchThreadsCount,
+            nodeSelection,
+            openNodesMemoryLimitMb,
+            dominanceMemoCapacity);
+}
+
+void checkOptimalResult(
+        const Result &result,
+        const TestHorizon &horizon,
+        const vector<int> &procTimes,
+        int optCost,
+        bool dominanceMemoUsed) {
+    if (optCost == Instance::NO_VALUE) {
+        CHECK(result.mStatus == Status::Infeasible);
+        return;
+    }
+
+    CHECK(result.mStatus == Status::Optimal);
+    CHECK(result.mObjective == optCost);
+    CHECK(computeJobsScheduleCost(horizon, procTimes, result.mStartTimes) == optCost);
+    CHECK(result.mGlobalLowerBound == optCost);
+    CHECK(result.mDominatedNodesCount.has_value() == dominanceMemoUsed);
+}
+
+void testOptimalObjectivesAgreeWithReference() {
+    vector<BaB::SpecializedSolverConfig> specializedSolverConfigs {
+            createSpecializedSolverConfig(false, BaB::Off, BaB::Random, 1, BaB::DepthFirst, 0),
+            createSpecializedSolverConfig(false, BaB::ROOT, BaB::JoinToPrev, 1, BaB::DepthFirst, 100000),
+            createSpecializedSolverConfig(false, BaB::WHOLE_TREE, BaB::ForcedSpace, 1, BaB::DepthFirst, 3),
+            createSpecializedSolverConfig(false, BaB::WHOLE_TREE, BaB::Random, 4, BaB::DepthFirst, 100000),
+            createSpecializedSolverConfig(false, BaB::ROOT, BaB::JoinToPrev, 2, BaB::BestFirst, 100000),
+            createSpecializedSolverConfig(false, BaB::Off, BaB::Random, 2, BaB::BestFirstWithDives, 100000),
+    };
+    auto iterativeDeepeningConfig =
+            createSpecializedSolverConfig(true, BaB::WHOLE_TREE, BaB::Random, 2, BaB::DepthFirst, 100000);
+
+    mt19937 random(1);
+    for (int iter = 0; iter < 30; iter++) {
+        // The jobs of a block are not charged any switching cost, as the costs without a gap in the instances.
+        auto switchingCostsKind = random() % 2 == 0 ? SwitchingCostsKind::Random : SwitchingCostsKind::ConvexGap;
+        auto horizon = createTestHorizon(random, 20 + random() % 20, switchingCostsKind, false);
+        auto procTimes = createTestProcTimes(random, horizon, 2 + random() % 4, 6);
+        if (procTimes.empty()) {
+            continue;
+        }
+
+        auto pInstance = createTestInstance(horizon, procTimes);
+        int optCost = computeReferenceOptCost(horizon, procTimes);
+
+        for (auto &specializedSolverConfig : specializedSolverConfigs) {
+            SolverConfig solverConfig(iter, optional<chrono::milliseconds>(), 4, vector<int>());
+            solverConfig.mProcessableIntervals = horizon.mProcessableIntervals;
+            BaB solver(*pInstance, solverConfig, specializedSolverConfig);
+            solver.solve();
+            checkOptimalResult(
+                    solver.getResult(),
+                    horizon,
+                    procTimes,
+                    optCost,
+                    specializedSolverConfig.mDominanceMemoCapacity > 0);
+        }
+
+        // Aggregates the statistics over the puffed horizons.
+        SolverConfig solverConfig(iter, optional<chrono::milliseconds>(), 4, vector<int>());
+        solverConfig.mProcessableIntervals = horizon.mProcessableIntervals;
+        auto result = iterativeDeeping(solverConfig, iterativeDeepeningConfig, *pInstance);
+        checkOptimalResult(result, horizon, procTimes, optCost, true);
+    }
+}
+
+void testLeafStartTimesAgreeWithObjective() {
+    // The leaves joined to the last block inherit the lower bound of their parents, the incumbents found by them (kept
+    // when the search stops at the nodes limit) are reported with the cost of their start times.
+    mt19937 random(2);
+    int stoppedCount = 0;
+    for (int iter = 0; iter < 40; iter++) {
+        auto horizon = createTestHorizon(random, 20 + random() % 20, SwitchingCostsKind::Random, false);
+        auto procTimes = createTestProcTimes(random, horizon, 3 + random() % 4, 6);
+        if (procTimes.size() < 2) {
+            continue;
+        }
+
+        auto pInstance = createTestInstance(horizon, procTimes);
+        int optCost = computeReferenceOptCost(horizon, procTimes);
+        for (int searchThreadsCount : {1, 2}) {
+            auto specializedSolverConfig = createSpecializedSolverConfig(
+                    false,
+                    BaB::Off,
+                    BaB::JoinToPrev,
+                    searchThreadsCount,
+                    BaB::DepthFirst,
+                    0,
+                    2 + random() % 30);
+            SolverConfig solverConfig(iter, optional<chrono::milliseconds>(), 2, vector<int>());
+            solverConfig.mProcessableIntervals = horizon.mProcessableIntervals;
+            BaB solver(*pInstance, solverConfig, specializedSolverConfig);
+            solver.solve();
+            auto result = solver.getResult();
+            if (!result.mObjective.has_value()) {
+                continue;
+            }
+
+            CHECK(result.mObjective.value() >= optCost);
+            CHECK(computeJobsScheduleCost(horizon, procTimes, result.mStartTimes) == result.mObjective.value());
+            stoppedCount += result.mStatus == Status::Heuristic;
+        }
+    }
+
+    CHECK(stoppedCount > 0);
+}
+
+void testSearchThreadsShareNodesLimitAndIncumbent() {
+    // The nodes of all the threads are counted together, each thread enters at most one node over the limit. The
+    // incumbent found by any of them is reported with its own start times.
+    const int searchThreadsCount = 4;
+    mt19937 random(3);
+    int stoppedCount = 0;
+    for (int iter = 0; iter < 30; iter++) {
+        auto horizon = createTestHorizon(random, 20 + random() % 20, SwitchingCostsKind::Random, false);
+        auto procTimes = createTestProcTimes(random, horizon, 4 + random() % 3, 6);
+        if (procTimes.size() < 2) {
+            continue;
+        }
+
+        auto pInstance = createTestInstance(horizon, procTimes);
+        int optCost = computeReferenceOptCost(horizon, procTimes);
+        long long nodesCountLimit = 10 + random() % 100;
+        auto specializedSolverConfig = createSpecializedSolverConfig(
+                false,
+                BaB::WHOLE_TREE,
+                BaB::Random,
+                searchThreadsCount,
+                BaB::DepthFirst,
+                0,
+                nodesCountLimit);
+        SolverConfig solverConfig(iter, optional<chrono::milliseconds>(), searchThreadsCount, vector<int>());
+        solverConfig.mProcessableIntervals = horizon.mProcessableIntervals;
+        BaB solver(*pInstance, solverConfig, specializedSolverConfig);
+        solver.solve();
+        auto result = solver.getResult();
+
+        CHECK(result.mNodesCount.has_value());
+        CHECK(result.mNodesCount.value() > 0);
+        CHECK(result.mNodesCount.value() <= nodesCountLimit + searchThreadsCount - 1);
+        if (result.mStatus == Status::Optimal) {
+            CHECK(result.mObjective == optCost);
+        }
+        if (result.mObjective.has_value()) {
+            CHECK(result.mObjective.value() >= optCost);
+            CHECK(computeJobsScheduleCost(horizon, procTimes, result.mStartTimes) == result.mObjective.value());
+        }
+        stoppedCount += result.mStatus == Status::Heuristic || result.mStatus == Status::NoSolution;
+    }
+
+    CHECK(stoppedCount > 0);
+}
+
+void testBestFirstBoundsWhenStopped() {
+    // Stopped at the nodes limit, the best-first search reports the least bound of its open nodes as the global lower
+    // bound. Without any memory for the open nodes, it searches depth-first and still finds the optimum.
+    mt19937 random(4);
+    int stoppedCount = 0;
+    for (int iter = 0; iter < 30; iter++) {
+        auto horizon = createTestHorizon(random, 20 + random() % 20, SwitchingCostsKind::Random, false);
+        auto procTimes = createTestProcTimes(random, horizon, 4 + random() % 3, 6);
+        if (procTimes.size() < 2) {
+            continue;
+        }
+
+        auto pInstance = createTestInstance(horizon, procTimes);
+        int optCost = computeReferenceOptCost(horizon, procTimes);
+        for (auto nodeSelection : {BaB::BestFirst, BaB::BestFirstWithDives}) {
+            auto specializedSolverConfig = createSpecializedSolverConfig(
+                    false,
+                    BaB::Off,
+                    BaB::Random,
+                    1 + random() % 2,
+                    nodeSelection,
+                    0,
+                    5 + random() % 60);
+            SolverConfig solverConfig(iter, optional<chrono::milliseconds>(), 2, vector<int>());
+            solverConfig.mProcessableIntervals = horizon.mProcessableIntervals;
+            BaB solver(*pInstance, solverConfig, specializedSolverConfig);
+            solver.solve();
+            auto result = solver.getResult();
+            if (result.mStatus == Status::Optimal || result.mStatus == Status::Infeasible) {
+                checkOptimalResult(result, horizon, procTimes, optCost, false);
+                continue;
+            }
+
+            if (result.mGlobalLowerBound.has_value()) {
+                CHECK(result.mGlobalLowerBound.value() <= optCost);
+            }
+            if (result.mObjective.has_value()) {
+                CHECK(result.mObjective.value() >= optCost);
+                CHECK(!result.mGlobalLowerBound.has_value()
+                      || result.mGlobalLowerBound.value() <= result.mObjective.value());
+            }
+            stoppedCount++;
+        }
+
+        auto noMemoryConfig = createSpecializedSolverConfig(
+                false,
+                BaB::Off,
+                BaB::Random,
+                1,
+                BaB::BestFirst,
+                0,
+                optional<long long>(),
+                0);
+        SolverConfig solverConfig(iter, optional<chrono::milliseconds>(), 2, vector<int>());
+        solverConfig.mProcessableIntervals = horizon.mProcessableIntervals;
+        BaB solver(*pInstance, solverConfig, noMemoryConfig);
+        solver.solve();
+        checkOptimalResult(solver.getResult(), horizon, procTimes, optCost, false);
+    }
+
+    CHECK(stoppedCount > 0);
+}
+
+void testSolvesAgainOnRestoredBuffers() {
+    // The node states are undone on the way back up the tree, a second solve on the same buffers searches the same
+    // nodes as a fresh solver.
+    vector<BaB::SpecializedSolverConfig> specializedSolverConfigs {
+            createSpecializedSolverConfig(false, BaB::Off, BaB::JoinToPrev, 1, BaB::DepthFirst, 100000),
+            createSpecializedSolverConfig(false, BaB::WHOLE_TREE, BaB::ForcedSpace, 1, BaB::DepthFirst, 0),
+            createSpecializedSolverConfig(false, BaB::ROOT, BaB::JoinToPrev, 1, BaB::BestFirst, 0),
+    };
+
+    mt19937 random(5);
+    int comparedCount = 0;
+    for (int iter = 0; iter < 20; iter++) {
+        auto horizon = createTestHorizon(random, 20 + random() % 20, SwitchingCostsKind::Random, false);
+        auto procTimes = createTestProcTimes(random, horizon, 3 + random() % 4, 6);
+        if (procTimes.size() < 2) {
+            continue;
+        }
+
+        auto pInstance = createTestInstance(horizon, procTimes);
+        for (auto &specializedSolverConfig : specializedSolverConfigs) {
+            SolverConfig solverConfig(iter, optional<chrono::milliseconds>(), 1, vector<int>());
+            solverConfig.mProcessableIntervals = horizon.mProcessableIntervals;
+            BaB solver(*pInstance, solverConfig, specializedSolverConfig);
+            solver.solve();
+            auto firstResult = solver.getResult();
+            solver.solve();
+            auto secondResult = solver.getResult();
+
+            SolverConfig freshSolverConfig(iter, optional<chrono::milliseconds>(), 1, vector<int>());
+            freshSolverConfig.mProcessableIntervals = horizon.mProcessableIntervals;
+            BaB freshSolver(*pInstance, freshSolverConfig, specializedSolverConfig);
+            freshSolver.solve();
+            auto freshResult = freshSolver.getResult();
+
+            for (auto *pResult : {&secondResult, &freshResult}) {
+                CHECK(pResult->mStatus == firstResult.mStatus);
+                CHECK(pResult->mObjective == firstResult.mObjective);
+                CHECK(pResult->mStartTimes == firstResult.mStartTimes);
+                CHECK(pResult->mNodesCount == firstResult.mNodesCount);
+                CHECK(pResult->mRootLowerBound == firstResult.mRootLowerBound);
+                CHECK(pResult->mGlobalLowerBound == firstResult.mGlobalLowerBound);
+            }
+            comparedCount += firstResult.mObjective.has_value();
+        }
+    }
+
+    CHECK(comparedCount > 0);
+}
+
+int main() {
+    testOptimalObjectivesAgreeWithReference();
+    testLeafStartTimesAgreeWithObjective();
+    testSearchThreadsShareNodesLimitAndIncumbent();
+    testBestFirstBoundsWhenStopped();
+    testSolvesAgainOnRestoredBuffers();
+
+    return finishTest("BranchAndBoundJobTests");
+}
@@ -0,0 +1,132 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include "TestUtils.h"
+#include "../src/solvers/ConstructiveHeuristic.h"
+
+using namespace std;
+using namespace escs;
+
+// The insertion heuristic evaluated by the reference DP: each proc time (in the order) is inserted to the first
+// position of the least cost, the positions right after an equal proc time are skipped. Instance::NO_VALUE if an
+// insertion is not feasible, otherwise the cost of the final permutation.
+int computeReferenceInsertionCost(const TestHorizon &horizon, const vector<int> &orderedProcTimes) {
+    vector<int> permutation;
+    for (int procTime : orderedProcTimes) {
+        optional<int> bestPosition;
+        int bestCost = Instance::NO_VALUE;
+        for (int position = 0; position <= (int)permutation.size(); position++) {
+            if (position > 0 && permutation[position - 1] == procTime) {
+                continue;
+            }
+
+            auto insertedPermutation = permutation;
+            insertedPermutation.insert(insertedPermutation.begin() + position, procTime);
+            int cost = computeReferenceCost(horizon, insertedPermutation);
+            if (cost < bestCost) {
+                bestPosition = position;
+                bestCost = cost;
+            }
+        }
+
+        if (!permutation.empty() && !bestPosition.has_value()) {
+            return Instance::NO_VALUE;
+        }
+        permutation.insert(permutation.begin() + bestPosition.value_or(0), procTime);
+    }
+
+    return computeReferenceCost(horizon, permutation);
+}
+
+void testObjectivesAgreeWithReference() {
+    vector<ConstructiveHeuristic::JobsOrdering> jobsOrderings {
+            ProcessingTimesOrdering::ShortestProcessingTimeFirst,
+            ProcessingTimesOrdering::LongestProcessingTimeFirst,
+            ProcessingTimesOrdering::AlternateShortestLongestProcessingTime,
+            ProcessingTimesOrdering::AlternateHalvesShortLongProcessingTime,
+    };
+    vector<SwitchingCostsKind> switchingCostsKinds {
+            SwitchingCostsKind::Random,
+            SwitchingCostsKind::Monge,
+            SwitchingCostsKind::ConvexGap,
+    };
+
+    mt19937 random(1);
+    int solvedCount = 0;
+    for (int iter = 0; iter < 60; iter++) {
+        auto switchingCostsKind = switchingCostsKinds[random() % switchingCostsKinds.size()];
+        auto horizon = createTestHorizon(random, 30 + random() % 40, switchingCostsKind, false);
+        auto procTimes = createTestProcTimes(random, horizon, 5, 12);
+        if (procTimes.empty()) {
+            continue;
+        }
+
+        auto pInstance = createTestInstance(horizon, procTimes);
+        for (auto jobsOrdering : jobsOrderings) {
+            SolverConfig solverConfig(iter, optional<chrono::milliseconds>(), 1, vector<int>());
+            ConstructiveHeuristic::SpecializedSolverConfig specializedSolverConfig(
+                    ConstructiveHeuristic::AllPositions,
+                    jobsOrdering,
+                    0);
+            ConstructiveHeuristic solver(*pInstance, solverConfig, specializedSolverConfig);
+            solver.solve();
+            auto result = solver.getResult();
+
+            // The orderings above do not draw from the random generator.
+            mt19937_64 orderingRandom(0);
+            int expectedCost = computeReferenceInsertionCost(
+                    horizon,
+                    ProcessingTimesOrdering::create(*pInstance, jobsOrdering, orderingRandom));
+            if (expectedCost == Instance::NO_VALUE) {
+                CHECK(result.mStatus == Status::NoSolution);
+                continue;
+            }
+
+            CHECK(result.mStatus == Status::Heuristic);
+            CHECK(result.mObjective == expectedCost);
+            CHECK(computeJobsScheduleCost(horizon, procTimes, result.mStartTimes) == expectedCost);
+            solvedCount++;
+        }
+    }
+
+    CHECK(solvedCount > 0);
+}
+
+void testMongeTransitionsSwitch() {
+    mt19937 random(2);
+    int mongeUsedCount = 0;
+    for (int iter = 0; iter < 20; iter++) {
+        auto horizon = createTestHorizon(random, 30 + random() % 40, SwitchingCostsKind::Monge, false);
+        auto procTimes = createTestProcTimes(random, horizon, 5, 12);
+        if (procTimes.empty()) {
+            continue;
+        }
+
+        auto pInstance = createTestInstance(horizon, procTimes);
+        ConstructiveHeuristic::SpecializedSolverConfig specializedSolverConfig(
+                ConstructiveHeuristic::AllPositions,
+                ProcessingTimesOrdering::LongestProcessingTimeFirst,
+                0);
+        vector<Result> results;
+        for (bool useMongeTransitions : {true, false}) {
+            SolverConfig solverConfig(iter, optional<chrono::milliseconds>(), 1, vector<int>(), useMongeTransitions);
+            ConstructiveHeuristic solver(*pInstance, solverConfig, specializedSolverConfig);
+            solver.solve();
+            results.push_back(solver.getResult());
+        }
+
+        // The same objective by the generic transitions.
+        CHECK(results[0].mObjective == results[1].mObjective);
+        CHECK(results[1].mMongeTransitionKernelUsed == optional<bool>(false));
+        mongeUsedCount += results[0].mMongeTransitionKernelUsed.value_or(false);
+    }
+
+    CHECK(mongeUsedCount > 0);
+}
+
+int main() {
+    testObjectivesAgreeWithReference();
+    testMongeTransitionsSwitch();
+
+    return finishTest("ConstructiveHeuristicTests");
+}
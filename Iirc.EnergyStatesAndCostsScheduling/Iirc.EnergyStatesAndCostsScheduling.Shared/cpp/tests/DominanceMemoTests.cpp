@@ -0,0 +1,90 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <thread>
+#include "TestUtils.h"
+#include "../src/datastructs/DominanceMemo.h"
+
+using namespace std;
+using namespace escs;
+
+const int NV = Instance::NO_VALUE;
+
+void testDominanceByKeyAndFrontier() {
+    DominanceMemo memo(100, 4);
+    vector<int> key = {2, 0, 1};
+
+    CHECK(!memo.checkAndInsert(key, 10, {NV, 5, 7, NV}));
+
+    // Stored trimmed, i.e., on the completions 11 and 12. The infeasible completions of a checked frontier are ignored.
+    CHECK(memo.checkAndInsert(key, 10, {NV, 5, 7, NV}));
+    CHECK(memo.checkAndInsert(key, 11, {6, 7}));
+    CHECK(memo.checkAndInsert(key, 10, {NV, NV, 8}));
+
+    // Less on a completion, or feasible on a completion the stored frontier is not.
+    CHECK(!memo.checkAndInsert(key, 10, {NV, 6, 6}));
+    CHECK(!memo.checkAndInsert(key, 12, {100, 100}));
+
+    // Other keys are not compared.
+    CHECK(!memo.checkAndInsert({2, 1, 0}, 10, {NV, 5, 7, NV}));
+
+    // No feasible completion at all.
+    CHECK(memo.checkAndInsert({0, 0, 0}, 10, {NV, NV}));
+
+    CHECK(memo.getDominatedCount() == 4);
+}
+
+void testNewFrontierReplacesDominatedOnes() {
+    DominanceMemo memo(100, 1);
+    vector<int> key = {1};
+    CHECK(!memo.checkAndInsert(key, 0, {5, 5}));
+    CHECK(!memo.checkAndInsert(key, 0, {9, 3}));
+
+    // Dominates both stored frontiers, so it is the only one left.
+    CHECK(!memo.checkAndInsert(key, 0, {4, 2, 1}));
+    CHECK(memo.checkAndInsert(key, 0, {4, 2}));
+    CHECK(memo.checkAndInsert(key, 2, {1}));
+    CHECK(!memo.checkAndInsert(key, 3, {0}));
+}
+
+void testEvictsOldestFrontiers() {
+    const int capacity = 4;
+    DominanceMemo memo(capacity, 1);
+    for (int keyIdx = 0; keyIdx < 3 * capacity; keyIdx++) {
+        CHECK(!memo.checkAndInsert({keyIdx}, 0, {keyIdx}));
+    }
+
+    // Only the newest frontiers are kept (the evicted ones are stored again).
+    for (int keyIdx = 3 * capacity - 1; keyIdx >= 0; keyIdx--) {
+        CHECK(memo.checkAndInsert({keyIdx}, 0, {keyIdx}) == (keyIdx >= 2 * capacity));
+    }
+}
+
+void testConcurrentUse() {
+    // The frontier depends on the key only, hence all but the first check of each key are dominated.
+    DominanceMemo memo(1000, 4);
+    vector<thread> threads;
+    for (int threadIdx = 0; threadIdx < 8; threadIdx++) {
+        threads.emplace_back([&memo, threadIdx]() {
+            mt19937 random(threadIdx);
+            for (int iter = 0; iter < 10000; iter++) {
+                int keyIdx = random() % 100;
+                memo.checkAndInsert({keyIdx}, 0, {10, 10 + keyIdx % 10});
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    CHECK(memo.getDominatedCount() == 8 * 10000 - 100);
+}
+
+int main() {
+    testDominanceByKeyAndFrontier();
+    testNewFrontierReplacesDominatedOnes();
+    testEvictsOldestFrontiers();
+    testConcurrentUse();
+
+    return finishTest("DominanceMemoTests");
+}
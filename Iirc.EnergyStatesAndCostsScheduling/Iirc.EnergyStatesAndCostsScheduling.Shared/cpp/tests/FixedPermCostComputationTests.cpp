@@ -0,0 +1,256 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <algorithm>
+#include <cmath>
+#include "TestUtils.h"
+#include "../src/datastructs/FixedPermCostComputation.h"
+#include "../src/datastructs/MongeSwitchingCosts.h"
+
+using namespace std;
+using namespace escs;
+
+FixedPermCostComputation createTestComputation(
+        const TestHorizon &horizon,
+        int totalProcTime,
+        const MongeSwitchingCosts *monge) {
+    return FixedPermCostComputation(
+            totalProcTime,
+            horizon.mNumIntervals,
+            horizon.mEarliestOnIntervalIdx,
+            horizon.mLatestOnIntervalIdx,
+            horizon.createCostTables(totalProcTime),
+            horizon.mProcessableIntervals,
+            nullptr,
+            monge);
+}
+
+void testCostOnlyStartTimesAgreeWithFullMode() {
+    // The opt path recomputed segment by segment is the stored one, also for the permutations continuing from the
+    // kept costs of the previous one, with pruning, forced spaces and the Monge transitions.
+    mt19937 random(1);
+    int comparedCount = 0;
+    for (int iter = 0; iter < 60; iter++) {
+        auto switchingCostsKind = random() % 2 == 0 ? SwitchingCostsKind::Random : SwitchingCostsKind::Monge;
+        auto horizon = createTestHorizon(random, 60 + random() % 60, switchingCostsKind, random() % 2);
+        auto monge = MongeSwitchingCosts::create(
+                horizon.mOptimalSwitchingCosts, horizon.mEarliestOnIntervalIdx, horizon.mLatestOnIntervalIdx);
+        auto procTimes = createTestProcTimes(random, horizon, 3, 25);
+        if (procTimes.size() < 2) {
+            continue;
+        }
+
+        int totalProcTime = accumulate(procTimes.begin(), procTimes.end(), 0);
+        auto *pMonge = random() % 2 == 0 ? monge.get() : nullptr;
+        auto fullComputation = createTestComputation(horizon, totalProcTime, pMonge);
+        auto costOnlyComputation = createTestComputation(horizon, totalProcTime, pMonge);
+        vector<int> checkpointPositions;
+        for (int checkpointIdx = 0; checkpointIdx < 3; checkpointIdx++) {
+            checkpointPositions.push_back(random() % procTimes.size());
+        }
+        costOnlyComputation.setCostOnly(true, checkpointPositions);
+
+        auto permutation = procTimes;
+        for (int round = 0; round < 10; round++) {
+            // Mostly a change of the end of the previous permutation.
+            shuffle(permutation.begin() + (round % 3 == 0 ? 0 : random() % permutation.size()), permutation.end(), random);
+            for (auto *pComputation : {&fullComputation, &costOnlyComputation}) {
+                pComputation->setPermutation(permutation);
+            }
+            if (random() % 4 == 0) {
+                int position = random() % (permutation.size() - 1);
+                int space = random() % 3;
+                fullComputation.setForcedSpace(position, space);
+                costOnlyComputation.setForcedSpace(position, space);
+            }
+
+            int optCost = fullComputation.recomputeCost();
+            int upperBound = optCost == Instance::NO_VALUE ? 1000 : optCost + (int)(random() % 10);
+            CHECK(costOnlyComputation.recomputeCost(upperBound) == fullComputation.recomputeCost(upperBound));
+            CHECK(costOnlyComputation.recomputeCost() == optCost);
+            if (optCost != Instance::NO_VALUE) {
+                CHECK(costOnlyComputation.reconstructStartTimes() == fullComputation.reconstructStartTimes());
+                comparedCount++;
+            }
+        }
+    }
+
+    CHECK(comparedCount > 0);
+}
+
+void testCostOnlyKeepsCostsOfFewPositions() {
+    // Only the costs of every ceil(sqrt(total proc time))-th position, of the checkpoint positions and of the last
+    // computed position are kept.
+    mt19937 random(2);
+    auto horizon = createTestHorizon(random, 200, SwitchingCostsKind::Random, false);
+    vector<int> permutation(100, 1);
+    auto computation = createTestComputation(horizon, permutation.size(), nullptr);
+    computation.setCostOnly(true, {13, 37});
+
+    // With a forced space before the last position, all the positions but the last one are computed.
+    computation.setPermutation(permutation);
+    computation.setForcedSpace(98, 1);
+    CHECK(computation.recomputeCost() != Instance::NO_VALUE);
+
+    vector<int> keptPositions;
+    for (int position = 0; position < (int)permutation.size(); position++) {
+        FixedPermCostComputation::PrefixCheckpoint checkpoint;
+        if (computation.saveCheckpoint(position, checkpoint)) {
+            keptPositions.push_back(position);
+        }
+    }
+    CHECK(keptPositions == vector<int>({0, 10, 13, 20, 30, 37, 40, 50, 60, 70, 80, 90, 98}));
+
+    // Without the mode, all of them.
+    computation.setCostOnly(false);
+    CHECK(computation.recomputeCost() != Instance::NO_VALUE);
+    FixedPermCostComputation::PrefixCheckpoint checkpoint;
+    CHECK(computation.saveCheckpoint(57, checkpoint));
+}
+
+void testPrunedByBoundTellsInfeasible() {
+    // A feasible permutation without a cost under the bound is always pruned by it, an infeasible one only if some of
+    // its states were cut by the bound before they turned out infeasible (never without a bound), also when continuing
+    // from the restored checkpoints.
+    mt19937 random(3);
+    int prunedCount = 0;
+    int infeasibleCount = 0;
+    int restoredCount = 0;
+    for (int iter = 0; iter < 60; iter++) {
+        auto horizon = createTestHorizon(random, 30 + random() % 40, SwitchingCostsKind::Random, true);
+        if (iter % 2 == 0) {
+            // Infeasible permutations are common with many unprocessable intervals.
+            for (int interval = 0; interval < horizon.mNumIntervals; interval++) {
+                horizon.mProcessableIntervals[interval] = horizon.mProcessableIntervals[interval] && random() % 4 != 0;
+            }
+        }
+        auto procTimes = createTestProcTimes(random, horizon, 5, 10);
+        if (procTimes.size() < 2) {
+            continue;
+        }
+
+        int totalProcTime = accumulate(procTimes.begin(), procTimes.end(), 0);
+        auto computation = createTestComputation(horizon, totalProcTime, nullptr);
+        auto checkpointComputation = createTestComputation(horizon, totalProcTime, nullptr);
+        auto restoredComputation = createTestComputation(horizon, totalProcTime, nullptr);
+        for (int round = 0; round < 10; round++) {
+            auto prevProcTimes = procTimes;
+            shuffle(procTimes.begin() + random() % procTimes.size(), procTimes.end(), random);
+            int optCost = computeReferenceCost(horizon, procTimes);
+            int upperBound = optCost == Instance::NO_VALUE
+                             ? (int)(random() % 1000)
+                             : optCost - 20 + (int)(random() % 25);
+
+            computation.setPermutation(procTimes);
+            int cost = computation.recomputeCost(upperBound);
+            CHECK(cost == computeReferenceCost(horizon, procTimes, upperBound));
+            if (cost == Instance::NO_VALUE) {
+                CHECK(optCost == Instance::NO_VALUE || computation.isPrunedByBound());
+                prunedCount += optCost != Instance::NO_VALUE;
+                infeasibleCount += optCost == Instance::NO_VALUE && !computation.isPrunedByBound();
+            }
+
+            // From the checkpoint of the common prefix with the previous permutation, computed under the same bound.
+            int commonPrefixCount = mismatch(procTimes.begin(), procTimes.end(), prevProcTimes.begin()).first
+                    - procTimes.begin();
+            checkpointComputation.setPermutation(prevProcTimes);
+            checkpointComputation.recomputeCost(upperBound);
+            FixedPermCostComputation::PrefixCheckpoint checkpoint;
+            if (commonPrefixCount > 0 && checkpointComputation.saveCheckpoint(commonPrefixCount - 1, checkpoint)) {
+                restoredComputation.invalidateCosts(0);
+                restoredComputation.restoreCheckpoint(procTimes, checkpoint);
+                CHECK(restoredComputation.recomputeCost(upperBound) == cost);
+                CHECK(cost != Instance::NO_VALUE
+                      || optCost == Instance::NO_VALUE
+                      || restoredComputation.isPrunedByBound());
+                restoredCount++;
+            }
+
+            computation.invalidateCosts(0);
+            CHECK(computation.recomputeCost() == optCost);
+            CHECK(!computation.isPrunedByBound());
+        }
+    }
+
+    CHECK(prunedCount > 0);
+    CHECK(infeasibleCount > 0);
+    CHECK(restoredCount > 0);
+}
+
+void testBatchCostsAgreeWithReference() {
+    // The batches share prefixes and have duplicates, as the children of the same parents.
+    mt19937 random(4);
+    for (int iter = 0; iter < 40; iter++) {
+        auto horizon = createTestHorizon(random, 30 + random() % 40, SwitchingCostsKind::Random, random() % 2);
+        auto procTimes = createTestProcTimes(random, horizon, 4, 10);
+        if (procTimes.size() < 2) {
+            continue;
+        }
+
+        vector<vector<int>> permutations;
+        for (int idx = 0; idx < 12; idx++) {
+            if (idx > 0 && random() % 4 == 0) {
+                permutations.push_back(permutations[random() % idx]);
+                continue;
+            }
+
+            shuffle(procTimes.begin() + random() % procTimes.size(), procTimes.end(), random);
+            permutations.push_back(procTimes);
+        }
+
+        int totalProcTime = accumulate(procTimes.begin(), procTimes.end(), 0);
+        auto computation = createTestComputation(horizon, totalProcTime, nullptr);
+        computation.setCostOnly(random() % 2 == 0);
+        int upperBound = computeReferenceCost(horizon, permutations[0]);
+        auto costs = computation.computeCosts(permutations, upperBound);
+        auto costsWithStartTimes = computation.computeCostsWithStartTimes(permutations);
+        for (int idx = 0; idx < (int)permutations.size(); idx++) {
+            CHECK(costs[idx] == computeReferenceCost(horizon, permutations[idx], upperBound));
+            int optCost = computeReferenceCost(horizon, permutations[idx]);
+            CHECK(costsWithStartTimes[idx].first == optCost);
+            if (optCost != Instance::NO_VALUE) {
+                CHECK(computeScheduleCost(horizon, permutations[idx], costsWithStartTimes[idx].second) == optCost);
+            }
+            else {
+                CHECK(costsWithStartTimes[idx].second.empty());
+            }
+        }
+
+        // Continuing from the checkpoints of the first permutation (of another computation), each evaluated once.
+        auto checkpointComputation = createTestComputation(horizon, totalProcTime, nullptr);
+        checkpointComputation.setPermutation(permutations[0]);
+        checkpointComputation.recomputeCost();
+        vector<FixedPermCostComputation::PrefixCheckpoint> savedCheckpoints(permutations.size());
+        vector<const FixedPermCostComputation::PrefixCheckpoint*> checkpoints(permutations.size(), nullptr);
+        for (int idx = 0; idx < (int)permutations.size(); idx++) {
+            int commonPrefixCount = mismatch(
+                    permutations[idx].begin(), permutations[idx].end(), permutations[0].begin()).first
+                    - permutations[idx].begin();
+            if (commonPrefixCount > 0
+                && checkpointComputation.saveCheckpoint(commonPrefixCount - 1, savedCheckpoints[idx])) {
+                checkpoints[idx] = &savedCheckpoints[idx];
+            }
+        }
+
+        vector<int> evaluatedCounts(permutations.size(), 0);
+        auto checkpointCosts = createTestComputation(horizon, totalProcTime, nullptr).computeCosts(
+                permutations,
+                upperBound,
+                checkpoints,
+                [&](int idx, int cost) {
+                    CHECK(cost == costs[idx]);
+                    evaluatedCounts[idx]++;
+                });
+        CHECK(checkpointCosts == costs);
+        CHECK(evaluatedCounts == vector<int>(permutations.size(), 1));
+    }
+}
+
+int main() {
+    testCostOnlyStartTimesAgreeWithFullMode();
+    testCostOnlyKeepsCostsOfFewPositions();
+    testPrunedByBoundTellsInfeasible();
+    testBatchCostsAgreeWithReference();
+
+    return finishTest("FixedPermCostComputationTests");
+}
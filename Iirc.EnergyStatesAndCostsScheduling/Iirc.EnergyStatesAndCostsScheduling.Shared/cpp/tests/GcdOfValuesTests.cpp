@@ -0,0 +1,71 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <algorithm>
+#include "TestUtils.h"
+#include "../src/datastructs/GcdOfValues.h"
+
+using namespace std;
+using namespace escs;
+
+int computeReferenceGcd(const vector<int> &values) {
+    int gcd = 0;
+    for (int value : values) {
+        gcd = std::gcd(gcd, value);
+    }
+
+    return gcd;
+}
+
+void testGcdOfValues() {
+    GcdOfValues gcdOfValues({12, 18, 30});
+    CHECK(gcdOfValues.gcd({12, 18, 30}) == 6);
+    CHECK(gcdOfValues.gcd({12, 30}) == 6);
+    CHECK(gcdOfValues.gcd({18}) == 18);
+    CHECK(gcdOfValues.gcd({7, 12}) == 1);
+}
+
+void testGcdOfMultisetAgreesWithReference() {
+    mt19937 random(1);
+    for (int iter = 0; iter < 2000; iter++) {
+        int base = 1 + random() % 60;
+        vector<int> values;
+        for (int idx = 0; idx < 1 + (int)(random() % 12); idx++) {
+            values.push_back(base * (1 + random() % 3000) * (random() % 2 == 0 ? 7 : 1));
+        }
+        GcdOfValues gcdOfValues(values);
+        CHECK(gcdOfValues.gcd(values) == computeReferenceGcd(values));
+
+        // The counts are indexed by the distinct values in the ascending order.
+        vector<int> distinctValues = values;
+        sort(distinctValues.begin(), distinctValues.end());
+        distinctValues.erase(unique(distinctValues.begin(), distinctValues.end()), distinctValues.end());
+        vector<int> counts(distinctValues.size());
+        for (auto &count : counts) {
+            count = random() % 3;
+        }
+        gcdOfValues.setCounts(counts);
+
+        for (int step = 0; step < 50; step++) {
+            int valueIdx = random() % distinctValues.size();
+            int delta = counts[valueIdx] > 0 && random() % 2 == 0 ? -1 : 1;
+            counts[valueIdx] += delta;
+            gcdOfValues.addCount(valueIdx, delta);
+
+            vector<int> multisetValues;
+            for (int idx = 0; idx < (int)distinctValues.size(); idx++) {
+                if (counts[idx] > 0) {
+                    multisetValues.push_back(distinctValues[idx]);
+                }
+            }
+            CHECK(gcdOfValues.getGcd() == computeReferenceGcd(multisetValues));
+        }
+    }
+}
+
+int main() {
+    testGcdOfValues();
+    testGcdOfMultisetAgreesWithReference();
+
+    return finishTest("GcdOfValuesTests");
+}
@@ -0,0 +1,385 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <algorithm>
+#include <chrono>
+#include <set>
+#include "TestUtils.h"
+#include "../src/solvers/GeneticAlgorithm.h"
+
+using namespace std;
+using namespace escs;
+
+GeneticAlgorithm::SpecializedSolverConfig createTestSpecializedSolverConfig(
+        GeneticAlgorithm::CrossoverStrategy crossoverStrategy,
+        int populationThreadsCount,
+        bool steadyState,
+        int islandsCount = 1,
+        int migrantsCount = 0,
+        double seedsFraction = 0.0,
+        int generationsCount = 15) {
+    return GeneticAlgorithm::SpecializedSolverConfig(
+            generationsCount,
+            20,
+            2,
+            0.7,
+            crossoverStrategy,
+            GeneticAlgorithm::SelectStrategyRandomly,
+            0.3,
+            15,
+            15,
+            populationThreadsCount,
+            1,
+            100,
+            islandsCount,
+            migrantsCount > 0 ? 2 : 0,
+            migrantsCount,
+            steadyState,
+            seedsFraction,
+            1);
+}
+
+// The two-point crossover filling the child in place: the swath [start, end] of the swath parent, the other
+// positions in the order of the other parent.
+vector<int> computeReferenceTwoPointChild(
+        const vector<int> &swathParent,
+        const vector<int> &otherParent,
+        int swathStartIndex,
+        int swathEndIndex) {
+    vector<int> child(swathParent.size(), -1);
+    multiset<int> remainingProcTimes(swathParent.begin(), swathParent.end());
+    for (int swathIndex = swathStartIndex; swathIndex <= swathEndIndex; swathIndex++) {
+        child[swathIndex] = swathParent[swathIndex];
+        remainingProcTimes.erase(remainingProcTimes.find(swathParent[swathIndex]));
+    }
+
+    int nextChildIndex = swathStartIndex == 0 ? swathEndIndex + 1 : 0;
+    for (int procTime : otherParent) {
+        auto remainingIt = remainingProcTimes.find(procTime);
+        if (remainingIt == remainingProcTimes.end()) {
+            continue;
+        }
+
+        remainingProcTimes.erase(remainingIt);
+        child[nextChildIndex++] = procTime;
+        if (nextChildIndex == swathStartIndex) {
+            nextChildIndex = swathEndIndex + 1;
+        }
+    }
+
+    return child;
+}
+
+void testCrossoversOnRecycledStorage() {
+    // The children are the ones of the reference, also when they take over the storage of the recycled solutions.
+    mt19937 random(1);
+    int reusedCount = 0;
+    for (int iter = 0; iter < 20; iter++) {
+        auto horizon = createTestHorizon(random, 30 + random() % 40, SwitchingCostsKind::Random, false);
+        auto procTimes = createTestProcTimes(random, horizon, 4, 12);
+        if (procTimes.size() < 2) {
+            continue;
+        }
+
+        auto pInstance = createTestInstance(horizon, procTimes);
+        SolverConfig solverConfig(iter, optional<chrono::milliseconds>(), 1, vector<int>());
+        auto specializedSolverConfig = createTestSpecializedSolverConfig(GeneticAlgorithm::TwoPoint, 1, false);
+        GeneticAlgorithm solver(*pInstance, solverConfig, specializedSolverConfig);
+
+        int n = procTimes.size();
+        for (int round = 0; round < 20; round++) {
+            GeneticAlgorithmSolution parent1;
+            GeneticAlgorithmSolution parent2;
+            parent1.mProcessingTimes = procTimes;
+            shuffle(parent1.mProcessingTimes.begin(), parent1.mProcessingTimes.end(), random);
+            parent2.mProcessingTimes = procTimes;
+            shuffle(parent2.mProcessingTimes.begin(), parent2.mProcessingTimes.end(), random);
+
+            // The swath start and end, then the choice of the swath parent.
+            vector<double> randomValues {
+                    (random() % 100) / 100.0,
+                    (random() % 100) / 100.0,
+                    (random() % 100) / 100.0};
+            int randomValueIdx = 0;
+            auto rnd01 = [&]() { return randomValues[randomValueIdx++ % randomValues.size()]; };
+
+            auto child = solver.CrossoverTwoPoint(parent1, parent2, rnd01);
+            int swathStartIndex = min((int)(randomValues[0] * n), n - 1);
+            int swathEndIndex = min((int)(randomValues[1] * n), n - 1);
+            bool fromParent1 = randomValues[2] <= 0.5;
+            CHECK(child.mProcessingTimes == computeReferenceTwoPointChild(
+                    fromParent1 ? parent1.mProcessingTimes : parent2.mProcessingTimes,
+                    fromParent1 ? parent2.mProcessingTimes : parent1.mProcessingTimes,
+                    min(swathStartIndex, swathEndIndex),
+                    max(swathStartIndex, swathEndIndex)));
+            CHECK(child.mParentsPrefixCosts.size() == 2);
+
+            auto sequentialChild = solver.CrossoverSequential(parent1, parent2, [&]() {
+                return (random() % 100) / 100.0;
+            });
+            CHECK(is_permutation(
+                    sequentialChild.mProcessingTimes.begin(),
+                    sequentialChild.mProcessingTimes.end(),
+                    procTimes.begin(),
+                    procTimes.end()));
+            CHECK(sequentialChild.mParentsPrefixCosts.size() == 2);
+
+            // The next child takes over the storage of the last recycled one.
+            const int *pRecycledProcTimes = child.mProcessingTimes.data();
+            solver.RecycleSolution(move(sequentialChild));
+            solver.RecycleSolution(move(child));
+            auto nextChild = solver.CrossoverTwoPoint(parent1, parent2, rnd01);
+            CHECK(nextChild.mProcessingTimes.data() == pRecycledProcTimes);
+            CHECK(nextChild.mProcessingTimes.size() == procTimes.size());
+            reusedCount++;
+        }
+    }
+
+    CHECK(reusedCount > 0);
+}
+
+void testObjectivesAgreeWithSchedule() {
+    // The generational and the steady-state modes move and recycle the chromosomes, the reported objective is the
+    // cost of the reported schedule.
+    mt19937 random(2);
+    int solvedCount = 0;
+    for (int iter = 0; iter < 16; iter++) {
+        auto horizon = createTestHorizon(random, 30 + random() % 40, SwitchingCostsKind::Random, false);
+        auto procTimes = createTestProcTimes(random, horizon, 5, 12);
+        if (procTimes.size() < 2) {
+            continue;
+        }
+
+        auto pInstance = createTestInstance(horizon, procTimes);
+        SolverConfig solverConfig(iter, optional<chrono::milliseconds>(), 2, vector<int>());
+        auto specializedSolverConfig = createTestSpecializedSolverConfig(
+                iter % 2 == 0 ? GeneticAlgorithm::Sequential : GeneticAlgorithm::TwoPoint,
+                1 + iter % 2,
+                iter % 4 >= 2);
+        GeneticAlgorithm solver(*pInstance, solverConfig, specializedSolverConfig);
+        solver.solve();
+        auto result = solver.GetResult();
+        if (result.mStatus != Status::Heuristic) {
+            CHECK(computeReferenceCost(horizon, procTimes) == Instance::NO_VALUE
+                  || result.mStatus == Status::NoSolution);
+            continue;
+        }
+
+        CHECK(result.mObjective.has_value());
+        CHECK(computeJobsScheduleCost(horizon, procTimes, result.mStartTimes) == result.mObjective.value());
+        solvedCount++;
+    }
+
+    CHECK(solvedCount > 0);
+}
+
+void testSameSeedSameResultOnThreads() {
+    // Each task of the population threads draws from its own stream seeded by the GA, regardless of the thread that
+    // takes it.
+    mt19937 random(3);
+    int comparedCount = 0;
+    for (int iter = 0; iter < 8; iter++) {
+        auto horizon = createTestHorizon(random, 40 + random() % 40, SwitchingCostsKind::Random, false);
+        auto procTimes = createTestProcTimes(random, horizon, 8, 12);
+        if (procTimes.size() < 4) {
+            continue;
+        }
+
+        auto pInstance = createTestInstance(horizon, procTimes);
+        auto specializedSolverConfig = createTestSpecializedSolverConfig(GeneticAlgorithm::TwoPoint, 3, false);
+        vector<Result> results;
+        for (int run = 0; run < 2; run++) {
+            SolverConfig solverConfig(iter, optional<chrono::milliseconds>(), 3, vector<int>());
+            GeneticAlgorithm solver(*pInstance, solverConfig, specializedSolverConfig);
+            solver.solve();
+            results.push_back(solver.GetResult());
+        }
+
+        CHECK(results[0].mObjective == results[1].mObjective);
+        CHECK(results[0].mStartTimes == results[1].mStartTimes);
+        comparedCount += results[0].mObjective.has_value();
+    }
+
+    CHECK(comparedCount > 0);
+}
+
+Generation_Type createTestGeneration(const vector<int> &procTimes, const vector<double> &totalCosts) {
+    Generation_Type generation;
+    for (double totalCost : totalCosts) {
+        GA_Type::thisChromosomeType chromosome;
+        chromosome.genes.mProcessingTimes = procTimes;
+        chromosome.total_cost = totalCost;
+        generation.chromosomes.push_back(chromosome);
+        generation.sorted_indices.push_back(generation.sorted_indices.size());
+    }
+    sort(generation.sorted_indices.begin(), generation.sorted_indices.end(), [&](int lhs, int rhs) {
+        return totalCosts[lhs] < totalCosts[rhs];
+    });
+
+    return generation;
+}
+
+vector<double> getTotalCosts(const Generation_Type &generation) {
+    vector<double> totalCosts;
+    for (auto &chromosome : generation.chromosomes) {
+        totalCosts.push_back(chromosome.total_cost);
+    }
+
+    return totalCosts;
+}
+
+void testMigrationOverRing() {
+    // The best chromosomes of an island replace the worst ones of the next island if better, the last island sends
+    // its best ones to the first one.
+    mt19937 random(4);
+    auto horizon = createTestHorizon(random, 40, SwitchingCostsKind::Random, false);
+    vector<int> procTimes {1, 2, 3, 2};
+    auto pInstance = createTestInstance(horizon, procTimes);
+    SolverConfig solverConfig(1, optional<chrono::milliseconds>(), 3, vector<int>());
+    auto specializedSolverConfig = createTestSpecializedSolverConfig(GeneticAlgorithm::TwoPoint, 1, false, 3, 2);
+    GeneticAlgorithm solver(*pInstance, solverConfig, specializedSolverConfig);
+    solver.solve();
+    auto result = solver.GetResult();
+    CHECK(result.mObjective.has_value());
+    CHECK(computeJobsScheduleCost(horizon, procTimes, result.mStartTimes) == result.mObjective.value());
+
+    // Drain the emigrants left by the solve.
+    Generation_Type emptyGeneration;
+    for (int islandIdx = 0; islandIdx < 3; islandIdx++) {
+        solver.Migrate(islandIdx, emptyGeneration);
+    }
+
+    auto generation0 = createTestGeneration(procTimes, {50, 10, 30, 20});
+    auto generation1 = createTestGeneration(procTimes, {40, 15, 60, 5});
+    auto generation2 = createTestGeneration(procTimes, {1, 2, 3, 4});
+    solver.Migrate(0, generation0);
+    CHECK(getTotalCosts(generation0) == vector<double>({50, 10, 30, 20}));
+
+    // 10 replaces 60, 20 replaces 40.
+    solver.Migrate(1, generation1);
+    CHECK(getTotalCosts(generation1) == vector<double>({20, 15, 10, 5}));
+
+    // 5 and 15 (the best ones before the immigration) are not better than the worst ones.
+    solver.Migrate(2, generation2);
+    CHECK(getTotalCosts(generation2) == vector<double>({1, 2, 3, 4}));
+
+    // 1 replaces 50, 2 replaces 30.
+    solver.Migrate(0, generation0);
+    CHECK(getTotalCosts(generation0) == vector<double>({1, 10, 2, 20}));
+}
+
+void testSteadyStateStopsOnTimeLimit() {
+    // Neither the generations nor the stalls stop the run, the workers stop at the time limit.
+    mt19937 random(5);
+    auto horizon = createTestHorizon(random, 80, SwitchingCostsKind::Random, false);
+    auto procTimes = createTestProcTimes(random, horizon, 10, 12);
+    auto pInstance = createTestInstance(horizon, procTimes);
+    GeneticAlgorithm::SpecializedSolverConfig specializedSolverConfig(
+            1000000,
+            20,
+            2,
+            0.7,
+            GeneticAlgorithm::TwoPoint,
+            GeneticAlgorithm::SelectStrategyRandomly,
+            0.3,
+            1000000,
+            1000000,
+            2,
+            1,
+            100,
+            1,
+            0,
+            0,
+            true,
+            0.0,
+            1);
+    SolverConfig solverConfig(1, optional<chrono::milliseconds>(300), 2, vector<int>());
+    GeneticAlgorithm solver(*pInstance, solverConfig, specializedSolverConfig);
+    auto startTime = chrono::steady_clock::now();
+    solver.solve();
+    auto duration = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - startTime);
+    auto result = solver.GetResult();
+
+    CHECK(result.mTimeLimitReached);
+    CHECK(duration < chrono::milliseconds(3000));
+    if (result.mObjective.has_value()) {
+        CHECK(computeJobsScheduleCost(horizon, procTimes, result.mStartTimes) == result.mObjective.value());
+    }
+}
+
+void testSeedsBoundObjective() {
+    // The seeds are kept by the elitism: a warm start from a schedule is not worse than it, the seeds by the orderings
+    // are not worse than the orderings.
+    vector<ProcessingTimesOrdering::OrderingStrategy> orderingStrategies {
+            ProcessingTimesOrdering::ShortestProcessingTimeFirst,
+            ProcessingTimesOrdering::LongestProcessingTimeFirst,
+            ProcessingTimesOrdering::AlternateShortestLongestProcessingTime,
+            ProcessingTimesOrdering::AlternateHalvesShortLongProcessingTime,
+    };
+
+    mt19937 random(6);
+    int warmStartedCount = 0;
+    int orderingsBoundedCount = 0;
+    for (int iter = 0; iter < 12; iter++) {
+        auto horizon = createTestHorizon(random, 40 + random() % 40, SwitchingCostsKind::Random, false);
+        auto procTimes = createTestProcTimes(random, horizon, 6, 12);
+        if (procTimes.size() < 2) {
+            continue;
+        }
+
+        auto pInstance = createTestInstance(horizon, procTimes);
+        SolverConfig solverConfig(iter, optional<chrono::milliseconds>(), 1, vector<int>());
+        GeneticAlgorithm solver(
+                *pInstance,
+                solverConfig,
+                createTestSpecializedSolverConfig(GeneticAlgorithm::TwoPoint, 1, false));
+        solver.solve();
+        auto result = solver.GetResult();
+        if (result.mObjective.has_value()) {
+            SolverConfig warmStartSolverConfig(iter + 1, optional<chrono::milliseconds>(), 1, result.mStartTimes);
+            GeneticAlgorithm warmStartSolver(
+                    *pInstance,
+                    warmStartSolverConfig,
+                    createTestSpecializedSolverConfig(GeneticAlgorithm::TwoPoint, 1, false, 1, 0, 0.0, 1));
+            warmStartSolver.solve();
+            auto warmStartResult = warmStartSolver.GetResult();
+            CHECK(warmStartResult.mObjective.has_value());
+            CHECK(warmStartResult.mObjective.value_or(Instance::NO_VALUE) <= result.mObjective.value());
+            warmStartedCount++;
+        }
+
+        SolverConfig seededSolverConfig(iter, optional<chrono::milliseconds>(), 1, vector<int>());
+        GeneticAlgorithm seededSolver(
+                *pInstance,
+                seededSolverConfig,
+                createTestSpecializedSolverConfig(GeneticAlgorithm::TwoPoint, 1, false, 1, 0, 1.0, 1));
+        seededSolver.solve();
+        auto seededResult = seededSolver.GetResult();
+        for (auto orderingStrategy : orderingStrategies) {
+            // The orderings above do not draw from the random generator.
+            mt19937_64 orderingRandom(0);
+            int orderingCost = computeReferenceCost(
+                    horizon,
+                    ProcessingTimesOrdering::create(*pInstance, orderingStrategy, orderingRandom));
+            if (orderingCost != Instance::NO_VALUE) {
+                CHECK(seededResult.mObjective.has_value());
+                CHECK(seededResult.mObjective.value_or(Instance::NO_VALUE) <= orderingCost);
+                orderingsBoundedCount++;
+            }
+        }
+    }
+
+    CHECK(warmStartedCount > 0);
+    CHECK(orderingsBoundedCount > 0);
+}
+
+int main() {
+    testCrossoversOnRecycledStorage();
+    testObjectivesAgreeWithSchedule();
+    testSameSeedSameResultOnThreads();
+    testMigrationOverRing();
+    testSteadyStateStopsOnTimeLimit();
+    testSeedsBoundObjective();
+
+    return finishTest("GeneticAlgorithmTests");
+}
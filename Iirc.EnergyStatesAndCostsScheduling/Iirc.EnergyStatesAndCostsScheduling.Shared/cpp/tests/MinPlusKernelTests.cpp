@@ -0,0 +1,114 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <algorithm>
+#include "TestUtils.h"
+#include "../src/utils/MinPlusKernel.h"
+#include "../src/datastructs/FixedPermCostComputation.h"
+
+using namespace std;
+using namespace escs;
+
+void testKernelAgreesWithLoop() {
+    vector<MinPlusKernelVariant> variants;
+    for (auto variant : {MinPlusKernelVariant::Scalar, MinPlusKernelVariant::Avx2, MinPlusKernelVariant::Avx512}) {
+        if (isMinPlusKernelVariantSupported(variant)) {
+            variants.push_back(variant);
+        }
+        else {
+            cout << "MinPlusKernelTests: variant " << (int)variant << " not supported, skipped" << endl;
+        }
+    }
+    CHECK(isMinPlusKernelVariantSupported(MinPlusKernelVariant::Scalar));
+
+    mt19937 random(1);
+    for (int iter = 0; iter < 100000; iter++) {
+        int count = random() % 70;
+        int maxValue = random() % 3 == 0 ? 5 : (random() % 2 == 0 ? 1000 : 1 << 29);
+        int density = random() % 4;
+        // One more entry so that the arrays may start unaligned.
+        vector<int> lhs(count + 1);
+        vector<int> rhs(count + 1);
+        for (int idx = 0; idx <= count; idx++) {
+            lhs[idx] = (int)(random() % 4) < density ? (int)(random() % maxValue) : Instance::NO_VALUE;
+            rhs[idx] = (int)(random() % 4) < density ? (int)(random() % maxValue) : Instance::NO_VALUE;
+        }
+        int offset = random() % 2;
+
+        int expectedMin = Instance::NO_VALUE;
+        int expectedArgmin = -1;
+        for (int idx = 0; idx < count; idx++) {
+            int lhsValue = lhs[offset + idx];
+            int rhsValue = rhs[offset + idx];
+            if (lhsValue != Instance::NO_VALUE && rhsValue != Instance::NO_VALUE && lhsValue + rhsValue < expectedMin) {
+                expectedMin = lhsValue + rhsValue;
+                expectedArgmin = idx;
+            }
+        }
+
+        int argmin = 0;
+        CHECK(computeMinPlusArgmin(lhs.data() + offset, rhs.data() + offset, count, argmin) == expectedMin);
+        CHECK(argmin == expectedArgmin);
+
+        // Also the variants not selected on this CPU.
+        for (auto variant : variants) {
+            argmin = 0;
+            CHECK(computeMinPlusArgmin(variant, lhs.data() + offset, rhs.data() + offset, count, argmin)
+                  == expectedMin);
+            CHECK(argmin == expectedArgmin);
+        }
+    }
+}
+
+void testGenericTransitionsAgreeWithReference() {
+    // The transitions by the kernel, with and without an upper bound.
+    mt19937 random(2);
+    for (int iter = 0; iter < 100; iter++) {
+        auto horizon = createTestHorizon(random, 30 + random() % 40, SwitchingCostsKind::Random, random() % 2);
+        auto procTimes = createTestProcTimes(random, horizon, 4, 8);
+        if (procTimes.empty()) {
+            continue;
+        }
+
+        int totalProcTime = accumulate(procTimes.begin(), procTimes.end(), 0);
+        FixedPermCostComputation computation(
+                totalProcTime,
+                horizon.mNumIntervals,
+                horizon.mEarliestOnIntervalIdx,
+                horizon.mLatestOnIntervalIdx,
+                horizon.createCostTables(totalProcTime),
+                horizon.mProcessableIntervals,
+                nullptr,
+                nullptr);
+
+        for (int rep = 0; rep < 5; rep++) {
+            shuffle(procTimes.begin(), procTimes.end(), random);
+            computation.setPermutation(procTimes);
+            int cost = computation.recomputeCost();
+            CHECK(cost == computeReferenceCost(horizon, procTimes));
+            if (cost != Instance::NO_VALUE) {
+                CHECK(computeScheduleCost(horizon, procTimes, computation.reconstructStartTimes()) == cost);
+            }
+
+            int upperBound = cost == Instance::NO_VALUE ? 1000 : cost - 5 + (int)(random() % 10);
+            CHECK(computation.recomputeCost(upperBound) == computeReferenceCost(horizon, procTimes, upperBound));
+        }
+    }
+}
+
+void testCostTablesCheckKernelPrecondition() {
+    mt19937 random(3);
+    auto horizon = createTestHorizon(random, 30, SwitchingCostsKind::Random, false);
+    CHECK(horizon.createCostTables(5)->hasNonNegativeCosts());
+
+    horizon.mOptimalSwitchingCosts[horizon.mEarliestOnIntervalIdx + 1][horizon.mEarliestOnIntervalIdx + 2] = -1;
+    CHECK(!horizon.createCostTables(5)->hasNonNegativeCosts());
+}
+
+int main() {
+    testKernelAgreesWithLoop();
+    testCostTablesCheckKernelPrecondition();
+    testGenericTransitionsAgreeWithReference();
+
+    return finishTest("MinPlusKernelTests");
+}
@@ -0,0 +1,107 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <algorithm>
+#include "TestUtils.h"
+#include "../src/datastructs/FixedPermCostComputation.h"
+#include "../src/datastructs/MongeSwitchingCosts.h"
+
+using namespace std;
+using namespace escs;
+
+void testDetectsMongeSwitchingCosts() {
+    mt19937 random(1);
+    for (int iter = 0; iter < 50; iter++) {
+        auto horizon = createTestHorizon(random, 30 + random() % 40, SwitchingCostsKind::Monge, false);
+        int earliest = horizon.mEarliestOnIntervalIdx;
+        int latest = horizon.mLatestOnIntervalIdx;
+        CHECK(MongeSwitchingCosts::create(horizon.mOptimalSwitchingCosts, earliest, latest) != nullptr);
+
+        // Violates the inequality on the completions c, c + 1 and the starts c + 1, c + 2.
+        int completion = earliest + 1;
+        horizon.mOptimalSwitchingCosts[completion + 1][completion + 2] += 1000;
+        CHECK(MongeSwitchingCosts::create(horizon.mOptimalSwitchingCosts, earliest, latest) == nullptr);
+    }
+}
+
+void testMongeTransitionsAgreeWithReference() {
+    // The costs by the Monge transitions are the costs of the reference DP and of the generic transitions, also with
+    // the relaxed unit positions at the end and with the forced spaces.
+    mt19937 random(2);
+    long long mongeTransitionsCount = 0;
+    for (int iter = 0; iter < 100; iter++) {
+        auto horizon = createTestHorizon(random, 30 + random() % 40, SwitchingCostsKind::Monge, random() % 2);
+        auto monge = MongeSwitchingCosts::create(
+                horizon.mOptimalSwitchingCosts, horizon.mEarliestOnIntervalIdx, horizon.mLatestOnIntervalIdx);
+        auto procTimes = createTestProcTimes(random, horizon, 4, 8);
+        if (procTimes.empty() || monge == nullptr) {
+            continue;
+        }
+
+        int totalProcTime = accumulate(procTimes.begin(), procTimes.end(), 0);
+        auto costTables = horizon.createCostTables(totalProcTime);
+        FixedPermCostComputation mongeComputation(
+                totalProcTime,
+                horizon.mNumIntervals,
+                horizon.mEarliestOnIntervalIdx,
+                horizon.mLatestOnIntervalIdx,
+                costTables,
+                horizon.mProcessableIntervals,
+                nullptr,
+                monge.get());
+        FixedPermCostComputation genericComputation(
+                totalProcTime,
+                horizon.mNumIntervals,
+                horizon.mEarliestOnIntervalIdx,
+                horizon.mLatestOnIntervalIdx,
+                costTables,
+                horizon.mProcessableIntervals,
+                nullptr,
+                nullptr);
+
+        for (int rep = 0; rep < 5; rep++) {
+            mongeComputation.reset();
+            genericComputation.reset();
+            shuffle(procTimes.begin(), procTimes.end(), random);
+
+            // The positions after the joined ones stay relaxed to the unit proc times.
+            int joinedCount = random() % 2 == 0 ? procTimes.size() : random() % procTimes.size();
+            vector<int> permutation(procTimes.begin(), procTimes.begin() + joinedCount);
+            for (int position = 0; position < joinedCount; position++) {
+                mongeComputation.join(position, procTimes[position]);
+                genericComputation.join(position, procTimes[position]);
+            }
+            while (accumulate(permutation.begin(), permutation.end(), 0) < totalProcTime) {
+                permutation.push_back(1);
+            }
+
+            int cost = mongeComputation.recomputeCost();
+            CHECK(cost == computeReferenceCost(horizon, permutation));
+            CHECK(cost == genericComputation.recomputeCost());
+            if (cost != Instance::NO_VALUE) {
+                auto startTimes = mongeComputation.reconstructStartTimes();
+                CHECK(computeScheduleCost(horizon, permutation, startTimes) == cost);
+                CHECK(startTimes == genericComputation.reconstructStartTimes());
+            }
+
+            for (int position = 0; position < joinedCount; position++) {
+                if (random() % 4 == 0) {
+                    mongeComputation.setForcedSpace(position, 1);
+                    genericComputation.setForcedSpace(position, 1);
+                }
+            }
+            CHECK(mongeComputation.recomputeCost() == genericComputation.recomputeCost());
+        }
+
+        mongeTransitionsCount += mongeComputation.getMongeTransitionsCount();
+    }
+
+    CHECK(mongeTransitionsCount > 0);
+}
+
+int main() {
+    testDetectsMongeSwitchingCosts();
+    testMongeTransitionsAgreeWithReference();
+
+    return finishTest("MongeSwitchingCostsTests");
+}
@@ -0,0 +1,102 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <algorithm>
+#include "TestUtils.h"
+#include "../src/datastructs/OpenNodeQueue.h"
+
+using namespace std;
+using namespace escs;
+
+OpenNodeQueue::OpenNode createTestOpenNode(int lowerBound, int depth) {
+    OpenNodeQueue::OpenNode openNode;
+    openNode.mDepth = depth;
+    openNode.mLowerBound = lowerBound;
+    openNode.mLowerBoundInherited = false;
+    openNode.mJoinToPrevBlock = false;
+    openNode.mJoinedGcd = 1;
+    return openNode;
+}
+
+void testPopsLeastBoundDeeperFirst() {
+    // The nodes not under the upper bound are dropped by the pop.
+    mt19937 random(1);
+    for (int iter = 0; iter < 50; iter++) {
+        OpenNodeQueue queue{optional<long long>()};
+        vector<pair<int, int>> boundsAndDepths;
+        for (int nodeIdx = 0; nodeIdx < 30; nodeIdx++) {
+            boundsAndDepths.emplace_back(random() % 10, random() % 6);
+            CHECK(queue.push(createTestOpenNode(boundsAndDepths.back().first, boundsAndDepths.back().second)));
+        }
+
+        // The least bound first, the deeper one on ties.
+        sort(boundsAndDepths.begin(), boundsAndDepths.end(), [](const pair<int, int> &lhs, const pair<int, int> &rhs) {
+            return lhs.first != rhs.first ? lhs.first < rhs.first : lhs.second > rhs.second;
+        });
+        int upperBound = 3 + random() % 6;
+        OpenNodeQueue::OpenNode openNode;
+        for (auto &boundAndDepth : boundsAndDepths) {
+            if (boundAndDepth.first >= upperBound) {
+                break;
+            }
+
+            CHECK(queue.getMinLowerBound() == boundAndDepth.first);
+            CHECK(queue.pop(upperBound, openNode));
+            CHECK(openNode.mLowerBound == boundAndDepth.first);
+            CHECK(openNode.mDepth == boundAndDepth.second);
+        }
+
+        CHECK(!queue.pop(upperBound, openNode));
+        CHECK(queue.empty());
+        CHECK(!queue.getMinLowerBound().has_value());
+    }
+}
+
+void testMemoryLimitRejectsAndFrees() {
+    // The nodes over the limit are rejected until the popped ones free their memory.
+    OpenNodeQueue unlimitedQueue{optional<long long>()};
+    for (int nodeIdx = 0; nodeIdx < 1000; nodeIdx++) {
+        CHECK(unlimitedQueue.push(createTestOpenNode(nodeIdx, 0)));
+    }
+
+    OpenNodeQueue queue{optional<long long>(4096)};
+    int storedCount = 0;
+    while (queue.push(createTestOpenNode(storedCount, 0))) {
+        storedCount++;
+    }
+    CHECK(storedCount > 0);
+    CHECK(storedCount < 1000);
+
+    // A node keeping its inherited blocks needs more memory.
+    auto inheritingNode = createTestOpenNode(0, 0);
+    inheritingNode.mLowerBoundInherited = true;
+    inheritingNode.mRemProcBlocksReversed = vector<Block>(64, Block(0, 1));
+
+    OpenNodeQueue::OpenNode openNode;
+    CHECK(queue.pop(Instance::NO_VALUE, openNode));
+    CHECK(!queue.push(inheritingNode));
+    CHECK(queue.push(createTestOpenNode(0, 0)));
+    CHECK(!queue.push(createTestOpenNode(0, 0)));
+}
+
+void testPathStepsSharedBySiblings() {
+    // A child appends a single step to the path of its parent.
+    auto pRoot = make_shared<const OpenNodeQueue::PathStep>(OpenNodeQueue::PathStep {nullptr, 3, true});
+    auto pChild = make_shared<const OpenNodeQueue::PathStep>(OpenNodeQueue::PathStep {pRoot, 2, false});
+    auto pSibling = make_shared<const OpenNodeQueue::PathStep>(OpenNodeQueue::PathStep {pRoot, 5, true});
+
+    auto steps = OpenNodeQueue::getSteps(pChild);
+    CHECK(steps.size() == 2);
+    CHECK(steps[0] == pRoot.get());
+    CHECK(steps[1]->mProcTime == 2 && !steps[1]->mStartsBlock);
+    CHECK(OpenNodeQueue::getSteps(pSibling)[0] == pRoot.get());
+    CHECK(OpenNodeQueue::getSteps(nullptr).empty());
+}
+
+int main() {
+    testPopsLeastBoundDeeperFirst();
+    testMemoryLimitRejectsAndFrees();
+    testPathStepsSharedBySiblings();
+
+    return finishTest("OpenNodeQueueTests");
+}
@@ -0,0 +1,134 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <algorithm>
+#include <thread>
+#include "TestUtils.h"
+#include "../src/datastructs/PermutationCostCache.h"
+
+using namespace std;
+using namespace escs;
+
+void testExactAndBoundCosts() {
+    PermutationCostCache cache(100, 4);
+    vector<int> exact = {1, 2, 3};
+    vector<int> bounded = {3, 2, 1};
+    int cost = 0;
+
+    CHECK(!cache.find(exact, 50, cost));
+
+    // The exact cost answers any bound.
+    cache.insert(exact, 50, 40);
+    CHECK(cache.find(exact, 41, cost) && cost == 40);
+    CHECK(cache.find(exact, 1000, cost) && cost == 40);
+    CHECK(cache.find(exact, 40, cost) && cost == Instance::NO_VALUE);
+    CHECK(cache.find(exact, 10, cost) && cost == Instance::NO_VALUE);
+
+    // The cost not less than a bound answers only the bounds not greater.
+    cache.insert(bounded, 30, Instance::NO_VALUE);
+    CHECK(cache.find(bounded, 30, cost) && cost == Instance::NO_VALUE);
+    CHECK(cache.find(bounded, 20, cost) && cost == Instance::NO_VALUE);
+    CHECK(!cache.find(bounded, 31, cost));
+
+    // A greater bound extends it, the exact cost replaces it.
+    cache.insert(bounded, 35, Instance::NO_VALUE);
+    CHECK(cache.find(bounded, 35, cost) && cost == Instance::NO_VALUE);
+    CHECK(!cache.find(bounded, 36, cost));
+    cache.insert(bounded, 36, 35);
+    CHECK(cache.find(bounded, 100, cost) && cost == 35);
+    CHECK(cache.find(bounded, 35, cost) && cost == Instance::NO_VALUE);
+
+    CHECK(cache.getHitsCount() == 9);
+    CHECK(cache.getMissesCount() == 3);
+}
+
+void testEvictsOldestEntries() {
+    const int capacity = 8;
+    PermutationCostCache cache(capacity, 1);
+    for (int idx = 0; idx < 3 * capacity; idx++) {
+        cache.insert({idx, idx + 1}, Instance::NO_VALUE, idx);
+    }
+
+    int cost = 0;
+    for (int idx = 0; idx < 3 * capacity; idx++) {
+        bool found = cache.find({idx, idx + 1}, Instance::NO_VALUE, cost);
+        CHECK(found == (idx >= 2 * capacity));
+        CHECK(!found || cost == idx);
+    }
+}
+
+void testAgreesWithBoundedCosts() {
+    // The cached results of the bounded cost computation answer the later bounds as the computation itself.
+    mt19937 random(1);
+    for (int iter = 0; iter < 30; iter++) {
+        auto horizon = createTestHorizon(random, 30 + random() % 30, SwitchingCostsKind::Random, random() % 2);
+        auto procTimes = createTestProcTimes(random, horizon, 4, 6);
+        if (procTimes.empty()) {
+            continue;
+        }
+
+        PermutationCostCache cache(16, 2);
+        vector<vector<int>> permutations;
+        for (int idx = 0; idx < 6; idx++) {
+            shuffle(procTimes.begin(), procTimes.end(), random);
+            permutations.push_back(procTimes);
+        }
+
+        for (int query = 0; query < 60; query++) {
+            auto &permutation = permutations[random() % permutations.size()];
+            int optCost = computeReferenceCost(horizon, permutation);
+            int upperBound = optCost == Instance::NO_VALUE || random() % 4 == 0
+                             ? Instance::NO_VALUE
+                             : optCost - 10 + (int)(random() % 20);
+
+            int cost = 0;
+            bool prunedByBound = false;
+            if (cache.find(permutation, upperBound, cost, prunedByBound)) {
+                CHECK(cost == computeReferenceCost(horizon, permutation, upperBound));
+                CHECK(prunedByBound == (cost == Instance::NO_VALUE && optCost != Instance::NO_VALUE));
+            }
+            else {
+                // The infeasible ones under no bound, see find.
+                cache.insert(
+                        permutation,
+                        optCost == Instance::NO_VALUE ? Instance::NO_VALUE : upperBound,
+                        computeReferenceCost(horizon, permutation, upperBound));
+            }
+        }
+    }
+}
+
+void testConcurrentUse() {
+    PermutationCostCache cache(64, 4);
+    vector<thread> threads;
+    for (int threadIdx = 0; threadIdx < 8; threadIdx++) {
+        threads.emplace_back([&cache, threadIdx]() {
+            mt19937 random(threadIdx);
+            for (int iter = 0; iter < 20000; iter++) {
+                vector<int> procTimes = {(int)(random() % 50), (int)(random() % 50)};
+                int expectedCost = procTimes[0] * 100 + procTimes[1];
+                int cost = 0;
+                if (cache.find(procTimes, Instance::NO_VALUE, cost)) {
+                    CHECK(cost == expectedCost);
+                }
+                else {
+                    cache.insert(procTimes, Instance::NO_VALUE, expectedCost);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    CHECK(cache.getHitsCount() + cache.getMissesCount() == 8 * 20000);
+}
+
+int main() {
+    testExactAndBoundCosts();
+    testEvictsOldestEntries();
+    testAgreesWithBoundedCosts();
+    testConcurrentUse();
+
+    return finishTest("PermutationCostCacheTests");
+}
@@ -0,0 +1,105 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <algorithm>
+#include "TestUtils.h"
+#include "../src/datastructs/FixedPermCostComputation.h"
+#include "../src/datastructs/MongeSwitchingCosts.h"
+
+using namespace std;
+using namespace escs;
+
+void testRestoredComputationsAgreeWithReference() {
+    // As in the GA: a child continues from the last checkpoint of its parent before the first changed position, pruned
+    // under a bound not less than its own. The checkpoints are restored into another computation sharing the tables.
+    mt19937 random(1);
+    int restoredCount = 0;
+    for (int iter = 0; iter < 100; iter++) {
+        auto switchingCostsKind = random() % 2 == 0 ? SwitchingCostsKind::Random : SwitchingCostsKind::Monge;
+        auto horizon = createTestHorizon(random, 30 + random() % 60, switchingCostsKind, random() % 2);
+        auto monge = MongeSwitchingCosts::create(
+                horizon.mOptimalSwitchingCosts, horizon.mEarliestOnIntervalIdx, horizon.mLatestOnIntervalIdx);
+        auto procTimes = createTestProcTimes(random, horizon, 5, 12);
+        if (procTimes.empty()) {
+            continue;
+        }
+
+        int totalProcTime = accumulate(procTimes.begin(), procTimes.end(), 0);
+        auto costTables = horizon.createCostTables(totalProcTime);
+        auto createComputation = [&]() {
+            return FixedPermCostComputation(
+                    totalProcTime,
+                    horizon.mNumIntervals,
+                    horizon.mEarliestOnIntervalIdx,
+                    horizon.mLatestOnIntervalIdx,
+                    costTables,
+                    horizon.mProcessableIntervals,
+                    nullptr,
+                    random() % 2 == 0 ? monge.get() : nullptr);
+        };
+        auto parentComputation = createComputation();
+        auto childComputation = createComputation();
+        childComputation.setCostOnly(random() % 2 == 0);
+
+        for (int round = 0; round < 10; round++) {
+            auto parent = procTimes;
+            shuffle(parent.begin(), parent.end(), random);
+            int parentOptCost = computeReferenceCost(horizon, parent);
+            int parentUpperBound = round % 3 == 0 || parentOptCost == Instance::NO_VALUE
+                                   ? Instance::NO_VALUE
+                                   : parentOptCost - 5 + (int)(random() % 30);
+            parentComputation.setPermutation(parent);
+            CHECK(parentComputation.recomputeCost(parentUpperBound)
+                  == computeReferenceCost(horizon, parent, parentUpperBound));
+
+            vector<FixedPermCostComputation::PrefixCheckpoint> checkpoints;
+            for (int position = 0; position + 1 < (int)parent.size(); position++) {
+                FixedPermCostComputation::PrefixCheckpoint checkpoint;
+                if (parentComputation.saveCheckpoint(position, checkpoint)) {
+                    checkpoints.push_back(checkpoint);
+                }
+            }
+
+            for (int childIdx = 0; childIdx < 8; childIdx++) {
+                auto child = parent;
+                shuffle(child.begin() + random() % child.size(), child.end(), random);
+                int commonPrefixCount = mismatch(child.begin(), child.end(), parent.begin()).first - child.begin();
+                int childUpperBound = random() % 3 == 0 || parentOptCost == Instance::NO_VALUE
+                                      ? parentUpperBound
+                                      : parentOptCost - 10 + (int)(random() % 30);
+
+                const FixedPermCostComputation::PrefixCheckpoint *pCheckpoint = nullptr;
+                for (auto &checkpoint : checkpoints) {
+                    if (checkpoint.mPosition < commonPrefixCount && checkpoint.mUpperBound >= childUpperBound) {
+                        pCheckpoint = &checkpoint;
+                    }
+                }
+                if (pCheckpoint != nullptr) {
+                    childComputation.restoreCheckpoint(child, *pCheckpoint);
+                    restoredCount++;
+                }
+                else {
+                    childComputation.setPermutation(child);
+                }
+
+                CHECK(childComputation.recomputeCost(childUpperBound)
+                      == computeReferenceCost(horizon, child, childUpperBound));
+
+                // The start times are reconstructed from scratch before the checkpoint.
+                int optCost = computeReferenceCost(horizon, child);
+                if (optCost != Instance::NO_VALUE && random() % 3 == 0) {
+                    CHECK(childComputation.recomputeCost() == optCost);
+                    CHECK(computeScheduleCost(horizon, child, childComputation.reconstructStartTimes()) == optCost);
+                }
+            }
+        }
+    }
+
+    CHECK(restoredCount > 0);
+}
+
+int main() {
+    testRestoredComputationsAgreeWithReference();
+
+    return finishTest("PrefixCheckpointTests");
+}
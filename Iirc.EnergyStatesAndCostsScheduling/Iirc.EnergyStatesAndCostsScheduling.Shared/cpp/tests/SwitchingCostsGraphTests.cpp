@@ -0,0 +1,146 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include "TestUtils.h"
+#include "../src/datastructs/FixedPermCostComputation.h"
+#include "../src/datastructs/SwitchingCostsGraph.h"
+
+using namespace std;
+using namespace escs;
+
+const int NV = Instance::NO_VALUE;
+
+// On, idle and off states, the off state is cheaper than the idle one only for the long gaps.
+StateDiagram createTestStateDiagram() {
+    return StateDiagram(
+            0,
+            1,
+            {TestHorizon::ON_POWER_CONSUMPTION, 1, 0},
+            {{0, 1, 2}, {1, 0, NV}, {3, NV, 0}},
+            {{0, 2, 3}, {2, 0, NV}, {5, NV, 0}});
+}
+
+// Replaces the switching costs between the completions and the starts of the horizon by the shortest paths over the
+// (interval, state) nodes of the diagram, relaxed interval by interval.
+void setStateDiagramSwitchingCosts(TestHorizon &horizon, const StateDiagram &stateDiagram) {
+    int statesCount = stateDiagram.getStatesCount();
+    int minIntervalIdx = horizon.mEarliestOnIntervalIdx + 1;
+    int maxIntervalIdx = horizon.mLatestOnIntervalIdx;
+    for (int completion = minIntervalIdx; completion <= maxIntervalIdx; completion++) {
+        vector<vector<long long>> costs(maxIntervalIdx + 1, vector<long long>(statesCount, NV));
+        costs[completion][stateDiagram.mOnStateIdx] = 0;
+        for (int intervalIdx = completion; intervalIdx <= maxIntervalIdx; intervalIdx++) {
+            horizon.mOptimalSwitchingCosts[completion][intervalIdx] =
+                    (int)costs[intervalIdx][stateDiagram.mOnStateIdx];
+            for (int fromStateIdx = 0; fromStateIdx < statesCount; fromStateIdx++) {
+                for (int toStateIdx = 0; toStateIdx < statesCount; toStateIdx++) {
+                    int time = fromStateIdx == toStateIdx ? 1 : stateDiagram.mTransitionTimes[fromStateIdx][toStateIdx];
+                    int power = fromStateIdx == toStateIdx
+                            ? stateDiagram.mStatesPowerConsumption[fromStateIdx]
+                            : stateDiagram.mTransitionPowerConsumptions[fromStateIdx][toStateIdx];
+                    if (costs[intervalIdx][fromStateIdx] == NV || time == NV || intervalIdx + time > maxIntervalIdx) {
+                        continue;
+                    }
+
+                    long long energyCost = horizon.mCumulativeEnergyCost[intervalIdx][intervalIdx + time - 1];
+                    costs[intervalIdx + time][toStateIdx] = min(
+                            costs[intervalIdx + time][toStateIdx],
+                            costs[intervalIdx][fromStateIdx] + power * energyCost);
+                }
+            }
+        }
+    }
+}
+
+shared_ptr<const SwitchingCostsGraph> createTestGraph(const TestHorizon &horizon, const StateDiagram &stateDiagram) {
+    return SwitchingCostsGraph::create(
+            stateDiagram,
+            1,
+            horizon.mEarliestOnIntervalIdx,
+            horizon.mLatestOnIntervalIdx,
+            horizon.mOptimalSwitchingCosts,
+            horizon.mCumulativeEnergyCost);
+}
+
+void testGraphTransitionsAgreeWithReference() {
+    auto stateDiagram = createTestStateDiagram();
+    mt19937 random(1);
+    for (int iter = 0; iter < 50; iter++) {
+        auto horizon = createTestHorizon(random, 30 + random() % 60, SwitchingCostsKind::Random, random() % 2);
+        setStateDiagramSwitchingCosts(horizon, stateDiagram);
+        auto graph = createTestGraph(horizon, stateDiagram);
+        CHECK(graph != nullptr);
+
+        auto procTimes = createTestProcTimes(random, horizon, 4, 10);
+        if (procTimes.empty()) {
+            continue;
+        }
+
+        int totalProcTime = accumulate(procTimes.begin(), procTimes.end(), 0);
+        FixedPermCostComputation graphComputation(
+                totalProcTime,
+                horizon.mNumIntervals,
+                horizon.mEarliestOnIntervalIdx,
+                horizon.mLatestOnIntervalIdx,
+                horizon.createCostTables(totalProcTime),
+                horizon.mProcessableIntervals,
+                graph.get(),
+                nullptr);
+        for (int rep = 0; rep < 5; rep++) {
+            shuffle(procTimes.begin(), procTimes.end(), random);
+            graphComputation.setPermutation(procTimes);
+            int cost = graphComputation.recomputeCost();
+            CHECK(cost == computeReferenceCost(horizon, procTimes));
+            if (cost != Instance::NO_VALUE) {
+                CHECK(computeScheduleCost(horizon, procTimes, graphComputation.reconstructStartTimes()) == cost);
+            }
+        }
+    }
+}
+
+void testRejectsOtherSwitchingCosts() {
+    auto stateDiagram = createTestStateDiagram();
+    mt19937 random(2);
+    for (int iter = 0; iter < 20; iter++) {
+        auto horizon = createTestHorizon(random, 30 + random() % 60, SwitchingCostsKind::Random, false);
+        setStateDiagramSwitchingCosts(horizon, stateDiagram);
+        int earliest = horizon.mEarliestOnIntervalIdx;
+        int latest = horizon.mLatestOnIntervalIdx;
+        auto &switchingCosts = horizon.mOptimalSwitchingCosts;
+
+        // The first and the last completion are verified also outside the debug builds.
+        switchingCosts[earliest + 1][earliest + 3]++;
+        CHECK(createTestGraph(horizon, stateDiagram) == nullptr);
+        switchingCosts[earliest + 1][earliest + 3]--;
+
+        switchingCosts[latest][latest]++;
+        CHECK(createTestGraph(horizon, stateDiagram) == nullptr);
+        switchingCosts[latest][latest]--;
+
+        // The completions having a switching cost to the start are not contiguous.
+        int hiddenCost = switchingCosts[earliest + 2][latest];
+        switchingCosts[earliest + 2][latest] = NV;
+        CHECK(createTestGraph(horizon, stateDiagram) == nullptr);
+        switchingCosts[earliest + 2][latest] = hiddenCost;
+
+        CHECK(createTestGraph(horizon, stateDiagram) != nullptr);
+    }
+}
+
+void testInstanceSharesGraphOfSameSwitchingCosts() {
+    auto stateDiagram = createTestStateDiagram();
+    mt19937 random(3);
+    auto horizon = createTestHorizon(random, 40, SwitchingCostsKind::Random, false);
+    setStateDiagramSwitchingCosts(horizon, stateDiagram);
+    auto pInstance = createTestInstance(horizon, {2, 3}, stateDiagram);
+    CHECK(pInstance->mOptimalSwitchingCostsGraph != nullptr);
+    CHECK(pInstance->mFullOptimalSwitchingCostsGraph == pInstance->mOptimalSwitchingCostsGraph);
+}
+
+int main() {
+    testGraphTransitionsAgreeWithReference();
+    testRejectsOtherSwitchingCosts();
+    testInstanceSharesGraphOfSameSwitchingCosts();
+
+    return finishTest("SwitchingCostsGraphTests");
+}
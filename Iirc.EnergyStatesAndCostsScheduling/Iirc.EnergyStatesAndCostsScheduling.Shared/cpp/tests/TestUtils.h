@@ -0,0 +1,324 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#ifndef ENERGYSTATESANDCOSTSSCHEDULING_TESTUTILS_H
+#define ENERGYSTATESANDCOSTSSCHEDULING_TESTUTILS_H
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "../src/input/Instance.h"
+#include "../src/datastructs/InstanceCostTables.h"
+
+using namespace std;
+
+// Reports and counts the failed check (from any thread), the test continues.
+#define CHECK(condition) escs::check((condition), #condition, __FILE__, __LINE__)
+
+namespace escs {
+    inline atomic<int> &getFailedChecksCount() {
+        static atomic<int> failedChecksCount(0);
+        return failedChecksCount;
+    }
+
+    inline void check(bool condition, const char *conditionText, const char *file, int line) {
+        if (!condition) {
+            getFailedChecksCount()++;
+            cerr << file << ":" << line << ": check failed: " << conditionText << endl;
+        }
+    }
+
+    // The exit code of the test.
+    inline int finishTest(const string &testName) {
+        if (getFailedChecksCount() > 0) {
+            cerr << testName << ": " << getFailedChecksCount() << " checks failed" << endl;
+            return 1;
+        }
+
+        cout << testName << ": passed" << endl;
+        return 0;
+    }
+
+    enum class SwitchingCostsKind {
+        // Random costs of the gaps up to a random length, and some random longer gaps.
+        Random,
+        // Convex in the gap length plus costs of the completion and of the start, up to a random length (Monge).
+        Monge,
+        // Convex in the gap length and zero without a gap as in the instances, up to a random length (Monge).
+        ConvexGap
+    };
+
+    // Random horizon of a single machine, as given to the cost computations by the instance.
+    struct TestHorizon {
+        static constexpr int ON_POWER_CONSUMPTION = 4;
+
+        int mNumIntervals;
+        int mEarliestOnIntervalIdx;
+        int mLatestOnIntervalIdx;
+        vector<vector<int>> mCumulativeEnergyCost;
+        vector<vector<int>> mOptimalSwitchingCosts; // From the completion (1 if first) to the start (or to last off).
+        vector<bool> mProcessableIntervals;
+
+        shared_ptr<const InstanceCostTables> createCostTables(int maxProcTime) const {
+            return make_shared<const InstanceCostTables>(
+                    mOptimalSwitchingCosts,
+                    InstanceCostTables::createCumulOnEnergyCostPerProcTime(
+                            mCumulativeEnergyCost, ON_POWER_CONSUMPTION, maxProcTime));
+        }
+    };
+
+    inline TestHorizon createTestHorizon(
+            mt19937 &random,
+            int numIntervals,
+            SwitchingCostsKind switchingCostsKind,
+            bool withUnprocessableIntervals) {
+        TestHorizon horizon;
+        horizon.mNumIntervals = numIntervals;
+        horizon.mEarliestOnIntervalIdx = 3;
+        horizon.mLatestOnIntervalIdx = numIntervals - 3;
+
+        vector<int> energyCosts(numIntervals);
+        for (auto &energyCost : energyCosts) {
+            energyCost = 1 + random() % 9;
+        }
+
+        horizon.mCumulativeEnergyCost = vector<vector<int>>(numIntervals, vector<int>(numIntervals, 0));
+        for (int from = 0; from < numIntervals; from++) {
+            int cumulativeEnergyCost = 0;
+            for (int to = from; to < numIntervals; to++) {
+                cumulativeEnergyCost += energyCosts[to];
+                horizon.mCumulativeEnergyCost[from][to] = cumulativeEnergyCost;
+            }
+        }
+
+        int earliest = horizon.mEarliestOnIntervalIdx;
+        int latest = horizon.mLatestOnIntervalIdx;
+        int maxGap = 3 + random() % 20;
+        int gapCostFactor = random() % 4;
+        vector<int> completionCosts(numIntervals + 1);
+        vector<int> startCosts(numIntervals + 1);
+        for (int interval = 0; interval <= numIntervals; interval++) {
+            completionCosts[interval] = random() % 20;
+            startCosts[interval] = random() % 20;
+        }
+
+        auto &switchingCosts = horizon.mOptimalSwitchingCosts;
+        switchingCosts = vector<vector<int>>(numIntervals + 1, vector<int>(numIntervals + 1, Instance::NO_VALUE));
+        for (int completion = earliest + 1; completion <= latest; completion++) {
+            for (int start = completion; start <= latest; start++) {
+                int gap = start - completion;
+                if (switchingCostsKind == SwitchingCostsKind::Monge) {
+                    if (gap <= maxGap) {
+                        switchingCosts[completion][start] =
+                                gapCostFactor * gap * gap + completionCosts[completion] + startCosts[start];
+                    }
+                }
+                else if (switchingCostsKind == SwitchingCostsKind::ConvexGap) {
+                    if (gap <= maxGap) {
+                        switchingCosts[completion][start] = gapCostFactor * gap * gap + gap;
+                    }
+                }
+                else if (gap == 0) {
+                    switchingCosts[completion][start] = 0;
+                }
+                else if (gap <= maxGap || random() % 3 == 0) {
+                    switchingCosts[completion][start] = random() % 40;
+                }
+            }
+        }
+        for (int start = earliest; start <= latest; start++) {
+            switchingCosts[1][start] = random() % 30;
+        }
+        for (int completion = earliest + 1; completion <= latest + 1; completion++) {
+            switchingCosts[completion][numIntervals] = random() % 30;
+        }
+
+        horizon.mProcessableIntervals = vector<bool>(numIntervals, true);
+        if (withUnprocessableIntervals) {
+            for (int interval = 0; interval < numIntervals; interval++) {
+                if (random() % 15 == 0) {
+                    horizon.mProcessableIntervals[interval] = false;
+                }
+            }
+        }
+
+        return horizon;
+    }
+
+    // Random proc times that fit the horizon (possibly none).
+    inline vector<int> createTestProcTimes(mt19937 &random, const TestHorizon &horizon, int maxProcTime, int maxCount) {
+        int maxTotalProcTime = (horizon.mLatestOnIntervalIdx - horizon.mEarliestOnIntervalIdx) * 2 / 3;
+        vector<int> procTimes;
+        int totalProcTime = 0;
+        while ((int)procTimes.size() < maxCount) {
+            int procTime = 1 + random() % maxProcTime;
+            if (totalProcTime + procTime > maxTotalProcTime) {
+                break;
+            }
+
+            procTimes.push_back(procTime);
+            totalProcTime += procTime;
+        }
+
+        return procTimes;
+    }
+
+    // Cost of the schedule of the permutation given by the start times, Instance::NO_VALUE if not feasible.
+    inline int computeScheduleCost(
+            const TestHorizon &horizon,
+            const vector<int> &procTimes,
+            const vector<int> &startTimes) {
+        auto &switchingCosts = horizon.mOptimalSwitchingCosts;
+        int totalProcTime = accumulate(procTimes.begin(), procTimes.end(), 0);
+        int level = 0;
+        int cost = 0;
+        int prevCompletion = 1;
+        for (int position = 0; position < (int)procTimes.size(); position++) {
+            int start = startTimes[position];
+            int procTime = procTimes[position];
+            if (start < horizon.mEarliestOnIntervalIdx + level
+                || start > horizon.mLatestOnIntervalIdx - (totalProcTime - level) + 1
+                || start < prevCompletion
+                || switchingCosts[prevCompletion][start] == Instance::NO_VALUE) {
+                return Instance::NO_VALUE;
+            }
+            for (int interval = start; interval < start + procTime; interval++) {
+                if (!horizon.mProcessableIntervals[interval]) {
+                    return Instance::NO_VALUE;
+                }
+            }
+
+            cost += switchingCosts[prevCompletion][start]
+                    + TestHorizon::ON_POWER_CONSUMPTION * horizon.mCumulativeEnergyCost[start][start + procTime - 1];
+            prevCompletion = start + procTime;
+            level += procTime;
+        }
+
+        if (switchingCosts[prevCompletion][horizon.mNumIntervals] == Instance::NO_VALUE) {
+            return Instance::NO_VALUE;
+        }
+
+        return cost + switchingCosts[prevCompletion][horizon.mNumIntervals];
+    }
+
+    // Optimal cost of the permutation by the textbook DP over the starts (no pruning, no transition kernels), as
+    // FixedPermCostComputation::recomputeCost(upperBound): Instance::NO_VALUE if infeasible or not less than the bound.
+    inline int computeReferenceCost(
+            const TestHorizon &horizon,
+            const vector<int> &procTimes,
+            int upperBound = Instance::NO_VALUE) {
+        auto &switchingCosts = horizon.mOptimalSwitchingCosts;
+        int numIntervals = horizon.mNumIntervals;
+        int totalProcTime = accumulate(procTimes.begin(), procTimes.end(), 0);
+
+        // Costs by the completion of the previous position (1 before the first one).
+        vector<long long> prevCosts(numIntervals + 1, Instance::NO_VALUE);
+        prevCosts[1] = 0;
+        int level = 0;
+        for (int procTime : procTimes) {
+            vector<long long> costs(numIntervals + 1, Instance::NO_VALUE);
+            int minStart = horizon.mEarliestOnIntervalIdx + level;
+            int maxStart = horizon.mLatestOnIntervalIdx - (totalProcTime - level) + 1;
+            for (int start = minStart; start <= maxStart; start++) {
+                bool processable = true;
+                for (int interval = start; interval < start + procTime; interval++) {
+                    processable &= horizon.mProcessableIntervals[interval];
+                }
+                if (!processable) {
+                    continue;
+                }
+
+                long long minCost = Instance::NO_VALUE;
+                for (int prevCompletion = 1; prevCompletion <= start; prevCompletion++) {
+                    if (prevCosts[prevCompletion] != Instance::NO_VALUE
+                        && switchingCosts[prevCompletion][start] != Instance::NO_VALUE) {
+                        minCost = min(minCost, prevCosts[prevCompletion] + switchingCosts[prevCompletion][start]);
+                    }
+                }
+                if (minCost != Instance::NO_VALUE) {
+                    costs[start + procTime] = minCost
+                            + TestHorizon::ON_POWER_CONSUMPTION
+                              * horizon.mCumulativeEnergyCost[start][start + procTime - 1];
+                }
+            }
+
+            prevCosts = costs;
+            level += procTime;
+        }
+
+        long long optCost = Instance::NO_VALUE;
+        for (int completion = 1; completion < numIntervals; completion++) {
+            if (prevCosts[completion] != Instance::NO_VALUE
+                && switchingCosts[completion][numIntervals] != Instance::NO_VALUE) {
+                optCost = min(optCost, prevCosts[completion] + switchingCosts[completion][numIntervals]);
+            }
+        }
+
+        return optCost < upperBound ? (int)optCost : Instance::NO_VALUE;
+    }
+
+    // Optimal cost of the horizon over all the permutations of the proc times, Instance::NO_VALUE if infeasible.
+    inline int computeReferenceOptCost(const TestHorizon &horizon, vector<int> procTimes) {
+        sort(procTimes.begin(), procTimes.end());
+        int optCost = Instance::NO_VALUE;
+        do {
+            optCost = min(optCost, computeReferenceCost(horizon, procTimes));
+        } while (next_permutation(procTimes.begin(), procTimes.end()));
+
+        return optCost;
+    }
+
+    // Single machine instance of the horizon with a job per proc time (ignores the unprocessable intervals).
+    inline unique_ptr<Instance> createTestInstance(
+            const TestHorizon &horizon,
+            const vector<int> &procTimes,
+            const optional<StateDiagram> &stateDiagram = optional<StateDiagram>()) {
+        vector<const Job*> jobs;
+        for (int jobIdx = 0; jobIdx < (int)procTimes.size(); jobIdx++) {
+            jobs.push_back(new Job(jobIdx, jobIdx, 0, procTimes[jobIdx]));
+        }
+        vector<const Interval*> intervals;
+        for (int interval = 0; interval < horizon.mNumIntervals; interval++) {
+            intervals.push_back(
+                    new Interval(interval, interval, interval + 1, horizon.mCumulativeEnergyCost[interval][interval]));
+        }
+
+        return make_unique<Instance>(
+                1,
+                jobs,
+                intervals,
+                1,
+                TestHorizon::ON_POWER_CONSUMPTION,
+                horizon.mEarliestOnIntervalIdx,
+                horizon.mLatestOnIntervalIdx,
+                horizon.mOptimalSwitchingCosts,
+                horizon.mOptimalSwitchingCosts,
+                horizon.mCumulativeEnergyCost,
+                stateDiagram);
+    }
+
+    // Cost of the schedule given by the start times of the jobs (indexed as the proc times), as computeScheduleCost.
+    inline int computeJobsScheduleCost(
+            const TestHorizon &horizon,
+            const vector<int> &procTimes,
+            const vector<int> &jobStartTimes) {
+        vector<int> jobIdxs(procTimes.size());
+        iota(jobIdxs.begin(), jobIdxs.end(), 0);
+        sort(jobIdxs.begin(), jobIdxs.end(), [&](int lhs, int rhs) { return jobStartTimes[lhs] < jobStartTimes[rhs]; });
+
+        vector<int> permProcTimes;
+        vector<int> startTimes;
+        for (int jobIdx : jobIdxs) {
+            permProcTimes.push_back(procTimes[jobIdx]);
+            startTimes.push_back(jobStartTimes[jobIdx]);
+        }
+
+        return computeScheduleCost(horizon, permProcTimes, startTimes);
+    }
+}
+
+#endif //ENERGYSTATESANDCOSTSSCHEDULING_TESTUTILS_H
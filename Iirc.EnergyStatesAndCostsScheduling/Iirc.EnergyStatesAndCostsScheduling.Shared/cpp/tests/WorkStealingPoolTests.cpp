@@ -0,0 +1,99 @@
+// This file is released under MIT license.
+// See file LICENSE.txt for more information.
+
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include "TestUtils.h"
+#include "../src/openga/openGA.hpp"
+
+using namespace std;
+using namespace escs;
+
+void testInitWorkerOncePerThread() {
+    // The tasks of all the runs see the state set by the init of their thread.
+    const int workersCount = 4;
+    thread_local int initializedWorker = -1;
+    atomic<int> initsCount(0);
+    mutex initializedThreadsMutex;
+    set<thread::id> initializedThreads;
+    {
+        EA::WorkStealingPool pool(workersCount, [&](int worker) {
+            initializedWorker = worker;
+            initsCount++;
+            lock_guard<mutex> lock(initializedThreadsMutex);
+            initializedThreads.insert(this_thread::get_id());
+        });
+
+        for (int run = 0; run < 20; run++) {
+            pool.run(50, [&](int /*taskIdx*/, int worker) {
+                CHECK(initializedWorker == worker);
+            });
+        }
+    }
+
+    CHECK(initsCount == workersCount);
+    CHECK((int)initializedThreads.size() == workersCount);
+}
+
+void testRunsEachTaskOnce() {
+    // Also with fewer tasks than the workers and with the tasks of uneven durations (stolen by the idle workers).
+    const int workersCount = 4;
+    EA::WorkStealingPool pool(workersCount);
+    for (int tasksCount : {0, 1, 3, 4, 17, 200}) {
+        vector<atomic<int>> runsCounts(tasksCount);
+        for (auto &runsCount : runsCounts) {
+            runsCount = 0;
+        }
+        atomic<int> maxWorker(-1);
+        pool.run(tasksCount, [&](int taskIdx, int worker) {
+            if (taskIdx % 7 == 0) {
+                this_thread::sleep_for(chrono::microseconds(200));
+            }
+            runsCounts[taskIdx]++;
+            int prevMaxWorker = maxWorker.load();
+            while (worker > prevMaxWorker && !maxWorker.compare_exchange_weak(prevMaxWorker, worker)) {
+            }
+        });
+
+        for (auto &runsCount : runsCounts) {
+            CHECK(runsCount == 1);
+        }
+        CHECK(maxWorker < workersCount);
+    }
+}
+
+void testRethrowsTaskException() {
+    // The first exception is rethrown after all the tasks finished, the pool runs the next tasks normally.
+    EA::WorkStealingPool pool(3);
+    atomic<int> finishedCount(0);
+    bool thrown = false;
+    try {
+        pool.run(30, [&](int taskIdx, int /*worker*/) {
+            if (taskIdx == 5) {
+                throw runtime_error("task failed");
+            }
+            finishedCount++;
+        });
+    }
+    catch (const runtime_error &) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(finishedCount == 29);
+
+    finishedCount = 0;
+    pool.run(30, [&](int /*taskIdx*/, int /*worker*/) {
+        finishedCount++;
+    });
+    CHECK(finishedCount == 30);
+}
+
+int main() {
+    testInitWorkerOncePerThread();
+    testRunsEachTaskOnce();
+    testRethrowsTaskException();
+
+    return finishTest("WorkStealingPoolTests");
+}